@@ -31,6 +31,7 @@ Revision History:
 #include "ast/ast_smt_pp.h"
 #include "ast/ast_smt2_pp.h"
 #include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/rewriter_params.hpp"
 #include "ast/rewriter/var_subst.h"
 #include "ast/rewriter/expr_safe_replace.h"
 #include "ast/rewriter/recfun_replace.h"
@@ -745,6 +746,9 @@ extern "C" {
         bool     use_ctrl_c  = p.get_bool("ctrl_c", false);
         th_rewriter m_rw(m, p);
         m_rw.set_solver(alloc(api::seq_expr_solver, m, p));
+        rewriter_params rp(p);
+        if (rp.persistent_cache() > 0)
+            m_rw.set_cache(&mk_c(c)->get_rewrite_cache(rp.persistent_cache()));
         expr_ref    result(m);
         cancel_eh<reslimit> eh(m.limit());
         api::context::set_interruptable si(*(mk_c(c)), eh);
@@ -316,6 +316,21 @@ namespace api {
         return *(m_rcf_manager.get());
     }
 
+    // ------------------------
+    //
+    // Simplification results kept across calls to Z3_simplify
+    //
+    // -----------------------
+    rewrite_cache & context::get_rewrite_cache(unsigned max_size) {
+        if (m_rewrite_cache.get() == nullptr) {
+            m_rewrite_cache = alloc(rewrite_cache, m(), max_size);
+        }
+        else if (m_rewrite_cache->max_size() != max_size) {
+            m_rewrite_cache->set_max_size(max_size);
+        }
+        return *(m_rewrite_cache.get());
+    }
+
 };
 
 
@@ -39,6 +39,7 @@ Revision History:
 #include "api/api_polynomial.h"
 #include "util/hashtable.h"
 #include "ast/rewriter/seq_rewriter.h"
+#include "ast/rewriter/rewrite_cache.h"
 #include "smt/smt_solver.h"
 #include "solver/solver.h"
 
@@ -237,6 +238,16 @@ namespace api {
     public:
         realclosure::manager & rcfm();
 
+        // ------------------------
+        //
+        // Simplification results kept across calls to Z3_simplify
+        //
+        // ------------------------
+    private:
+        scoped_ptr<rewrite_cache>        m_rewrite_cache;
+    public:
+        rewrite_cache & get_rewrite_cache(unsigned max_size);
+
         // ------------------------
         //
         // Solver interface for backward compatibility 
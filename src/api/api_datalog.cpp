@@ -109,6 +109,9 @@ namespace api {
         void add_table_fact(func_decl* r, unsigned num_args, unsigned args[]) {
             m_context.add_table_fact(r, num_args, args);
         }
+        void remove_table_fact(func_decl* r, unsigned num_args, unsigned args[]) {
+            m_context.remove_table_fact(r, num_args, args);
+        }
         std::string get_last_status() {
             datalog::execution_result status = m_context.get_status();
             switch(status) {
@@ -273,6 +276,15 @@ extern "C" {
         Z3_CATCH;
     }
 
+    void Z3_API Z3_fixedpoint_remove_fact(Z3_context c, Z3_fixedpoint d, 
+                                          Z3_func_decl r, unsigned num_args, unsigned args[]) {
+        Z3_TRY;
+        LOG_Z3_fixedpoint_remove_fact(c, d, r, num_args, args);
+        RESET_ERROR_CODE();
+        to_fixedpoint_ref(d)->remove_table_fact(to_func_decl(r), num_args, args);
+        Z3_CATCH;
+    }
+
     Z3_lbool Z3_API Z3_fixedpoint_query(Z3_context c,Z3_fixedpoint d, Z3_ast q) {
         Z3_TRY;
         LOG_Z3_fixedpoint_query(c, d, q);
@@ -23,6 +23,7 @@ Revision History:
 #include "api/api_ast_vector.h"
 #include "ast/array_decl_plugin.h"
 #include "model/model.h"
+#include "model/compiled_expr.h"
 #include "model/model_v2_pp.h"
 #include "model/model_smt2_pp.h"
 #include "model/model_params.hpp"
@@ -173,6 +174,29 @@ extern "C" {
         Z3_CATCH_RETURN(0);
     }
 
+    bool Z3_API Z3_model_eval_many(Z3_context c, Z3_ast t, bool model_completion, unsigned num_models, Z3_model const ms[], Z3_ast results[]) {
+        Z3_TRY;
+        LOG_Z3_model_eval_many(c, t, model_completion, num_models, ms, results);
+        RESET_ERROR_CODE();
+        CHECK_IS_EXPR(t, false);
+        for (unsigned i = 0; i < num_models; ++i) {
+            CHECK_NON_NULL(ms[i], false);
+        }
+        ast_manager& mgr = mk_c(c)->m();
+        params_ref p;
+        compiled_expr ce(mgr, to_expr(t));
+        mk_c(c)->reset_last_result();
+        for (unsigned i = 0; i < num_models; ++i) {
+            model * _m = to_model_ref(ms[i]);
+            _m->set_solver(alloc(api::seq_expr_solver, mgr, p));
+            expr_ref result = ce(*_m, model_completion);
+            mk_c(c)->save_multiple_ast_trail(result.get());
+            results[i] = of_ast(result.get());
+        }
+        RETURN_Z3_model_eval_many true;
+        Z3_CATCH_RETURN(false);
+    }
+
     unsigned Z3_API Z3_model_get_num_sorts(Z3_context c, Z3_model m) {
         Z3_TRY;
         LOG_Z3_model_get_num_sorts(c, m);
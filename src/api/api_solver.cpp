@@ -119,6 +119,17 @@ extern "C" {
         Z3_CATCH_RETURN(nullptr);
     }
 
+    Z3_solver Z3_API Z3_mk_incremental_solver_from_tactic(Z3_context c, Z3_tactic pre, Z3_tactic t) {
+        Z3_TRY;
+        LOG_Z3_mk_incremental_solver_from_tactic(c, pre, t);
+        RESET_ERROR_CODE();
+        Z3_solver_ref * s = alloc(Z3_solver_ref, *mk_c(c), mk_incremental_tactic2solver_factory(to_tactic_ref(pre), to_tactic_ref(t)));
+        mk_c(c)->save_object(s);
+        Z3_solver r = of_solver(s);
+        RETURN_Z3(r);
+        Z3_CATCH_RETURN(nullptr);
+    }
+
     Z3_solver Z3_API Z3_solver_translate(Z3_context c, Z3_solver s, Z3_context target) {
         Z3_TRY;
         LOG_Z3_solver_translate(c, s, target);
@@ -24,18 +24,19 @@ Revision History:
 #include "util/scoped_ctrl_c.h"
 #include "util/cancel_eh.h"
 #include "util/scoped_timer.h"
+#include "tactic/profile_tactic.h"
 
 Z3_apply_result_ref::Z3_apply_result_ref(api::context& c, ast_manager & m): api::object(c) {
 }
 
 extern "C" {
 
-#define RETURN_TACTIC(_t_) {                                    \
-        Z3_tactic_ref * _ref_ = alloc(Z3_tactic_ref, *mk_c(c)); \
-        _ref_->m_tactic   = _t_;                                \
-        mk_c(c)->save_object(_ref_);                            \
-        Z3_tactic _result_  = of_tactic(_ref_);                 \
-        RETURN_Z3(_result_);                                    \
+#define RETURN_TACTIC(_name_, _t_) {                                   \
+        Z3_tactic_ref * _ref_ = alloc(Z3_tactic_ref, *mk_c(c));        \
+        _ref_->m_tactic   = mk_profile_tactic_if_enabled(_name_, _t_); \
+        mk_c(c)->save_object(_ref_);                                   \
+        Z3_tactic _result_  = of_tactic(_ref_);                        \
+        RETURN_Z3(_result_);                                           \
 }
 
 #define RETURN_PROBE(_t_) {                                     \
@@ -56,7 +57,7 @@ extern "C" {
             RETURN_Z3(nullptr);
         }
         tactic * new_t = t->mk(mk_c(c)->m());
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC(name, new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -111,7 +112,7 @@ extern "C" {
         LOG_Z3_tactic_and_then(c, t1, t2);
         RESET_ERROR_CODE();
         tactic * new_t = and_then(to_tactic_ref(t1), to_tactic_ref(t2));
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("and-then", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -120,7 +121,7 @@ extern "C" {
         LOG_Z3_tactic_or_else(c, t1, t2);
         RESET_ERROR_CODE();
         tactic * new_t = or_else(to_tactic_ref(t1), to_tactic_ref(t2));
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("or-else", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -133,7 +134,7 @@ extern "C" {
             _ts.push_back(to_tactic_ref(ts[i]));
         }
         tactic * new_t = par(num, _ts.c_ptr());
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("par-or", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -142,7 +143,7 @@ extern "C" {
         LOG_Z3_tactic_par_and_then(c, t1, t2);
         RESET_ERROR_CODE();
         tactic * new_t = par_and_then(to_tactic_ref(t1), to_tactic_ref(t2));
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("par-then", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -151,7 +152,7 @@ extern "C" {
         LOG_Z3_tactic_try_for(c, t, ms);
         RESET_ERROR_CODE();
         tactic * new_t = try_for(to_tactic_ref(t), ms);
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("try-for", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -160,7 +161,7 @@ extern "C" {
         LOG_Z3_tactic_when(c, p, t);
         RESET_ERROR_CODE();
         tactic * new_t = when(to_probe_ref(p), to_tactic_ref(t));
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("when", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
     
@@ -169,7 +170,7 @@ extern "C" {
         LOG_Z3_tactic_cond(c, p, t1, t2);
         RESET_ERROR_CODE();
         tactic * new_t = cond(to_probe_ref(p), to_tactic_ref(t1), to_tactic_ref(t2));
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("cond", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -178,7 +179,7 @@ extern "C" {
         LOG_Z3_tactic_repeat(c, t, max);
         RESET_ERROR_CODE();
         tactic * new_t = repeat(to_tactic_ref(t), max);
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("repeat", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -187,7 +188,7 @@ extern "C" {
         LOG_Z3_tactic_skip(c);
         RESET_ERROR_CODE();
         tactic * new_t = mk_skip_tactic();
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("skip", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -196,7 +197,7 @@ extern "C" {
         LOG_Z3_tactic_fail(c);
         RESET_ERROR_CODE();
         tactic * new_t = mk_fail_tactic();
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("fail", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -205,7 +206,7 @@ extern "C" {
         LOG_Z3_tactic_fail_if(c, p);
         RESET_ERROR_CODE();
         tactic * new_t = fail_if(to_probe_ref(p));
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("fail-if", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -214,7 +215,7 @@ extern "C" {
         LOG_Z3_tactic_fail_if_not_decided(c);
         RESET_ERROR_CODE();
         tactic * new_t = mk_fail_if_undecided_tactic();
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("fail-if-undecided", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -226,7 +227,7 @@ extern "C" {
         to_tactic_ref(t)->collect_param_descrs(r);
         to_param_ref(p).validate(r);
         tactic * new_t = using_params(to_tactic_ref(t), to_param_ref(p));
-        RETURN_TACTIC(new_t);
+        RETURN_TACTIC("using-params", new_t);
         Z3_CATCH_RETURN(nullptr);
     }
 
@@ -7568,11 +7568,17 @@ class Tactic:
         if self.tactic is not None and self.ctx.ref() is not None:
             Z3_tactic_dec_ref(self.ctx.ref(), self.tactic)
 
-    def solver(self):
+    def solver(self, preprocess=None):
         """Create a solver using the tactic `self`.
 
         The solver supports the methods `push()` and `pop()`, but it
-        will always solve each `check()` from scratch.
+        will always solve each `check()` from scratch. If the tactic
+        `preprocess` is given, it is applied only to the constraints
+        added since the previous `check()`, and `self` is applied to
+        the preprocessed constraints. This is sound only for tactics
+        that record every step that does not produce an equivalent goal
+        in their model converter, so tactics such as symmetry-reduce
+        must not be used as `preprocess`.
 
         >>> t = Then('simplify', 'nlsat')
         >>> s = t.solver()
@@ -7583,7 +7589,10 @@ class Tactic:
         >>> s.model()
         [x = 1.4142135623?]
         """
-        return Solver(Z3_mk_solver_from_tactic(self.ctx.ref(), self.tactic), self.ctx)
+        if preprocess is None:
+            return Solver(Z3_mk_solver_from_tactic(self.ctx.ref(), self.tactic), self.ctx)
+        preprocess = _to_tactic(preprocess, self.ctx)
+        return Solver(Z3_mk_incremental_solver_from_tactic(self.ctx.ref(), preprocess.tactic, self.tactic), self.ctx)
 
     def apply(self, goal, *arguments, **keywords):
         """Apply tactic `self` to the given goal or Z3 Boolean expression using the given options.
@@ -4888,6 +4888,21 @@ extern "C" {
     */
     Z3_bool_opt Z3_API Z3_model_eval(Z3_context c, Z3_model m, Z3_ast t, bool model_completion, Z3_ast * v);
 
+    /**
+       \brief Evaluate the AST node \c t in each of the models \c ms.
+       Return \c true if succeeded, and store the value of \c t in \c ms[i] in \c results[i].
+
+       The result is the same as calling #Z3_model_eval for each model, but \c t
+       is prepared only once, and Boolean, bit-vector (of at most 64 bits) and integer
+       operations are evaluated directly on machine words. This is useful when the
+       same expression is evaluated in a large number of models.
+
+       \sa Z3_model_eval
+
+       def_API('Z3_model_eval_many', BOOL, (_in(CONTEXT), _in(AST), _in(BOOL), _in(UINT), _in_array(3, MODEL), _out_array(3, AST)))
+    */
+    bool Z3_API Z3_model_eval_many(Z3_context c, Z3_ast t, bool model_completion, unsigned num_models, Z3_model const ms[], Z3_ast results[]);
+
     /**
        \brief Return the interpretation (i.e., assignment) of constant \c a in the model \c m.
        Return \c NULL, if the model does not assign an interpretation for \c a.
@@ -6045,6 +6060,37 @@ extern "C" {
     */
     Z3_solver Z3_API Z3_mk_solver_from_tactic(Z3_context c, Z3_tactic t);
 
+    /**
+       \brief Create a new solver that is implemented using the tactics \c pre and \c t.
+       Assertions are preprocessed by \c pre in batches: on every #Z3_solver_check,
+       \c pre is applied to the assertions added since the previous check, and its
+       results are kept across #Z3_solver_push and #Z3_solver_pop. The tactic \c t is
+       applied to the preprocessed assertions and the assumptions.
+
+       Symbols of assertions that were preprocessed by an earlier check are not
+       eliminated. If \c pre eliminates such a symbol, the results are rolled back to
+       the batch where the symbol occurs first, and the assertions from this batch on
+       are preprocessed again as one batch. If new assertions contain a symbol that
+       \c pre eliminated before, the definition of the symbol is moved from the model
+       converter of \c pre into the new assertions; if the model converter cannot
+       produce its definitions as formulas, the results are rolled back instead.
+       All assertions are preprocessed again, together with the assumptions, only if
+       proofs are enabled, if the assumptions contain an eliminated symbol, or if
+       \c pre fails or does not produce exactly one goal.
+
+       Preprocessing in batches is sound only if every step of \c pre that does not
+       produce an equivalent goal is recorded in its model converter, as for simplify,
+       propagate-values, solve-eqs and elim-uncnstr. Tactics that preserve only
+       satisfiability without such a record, for example symmetry-reduce, must not be
+       used as \c pre.
+
+       \remark User must use #Z3_solver_inc_ref and #Z3_solver_dec_ref to manage solver objects.
+       Even if the context was created using #Z3_mk_context instead of #Z3_mk_context_rc.
+
+       def_API('Z3_mk_incremental_solver_from_tactic', SOLVER, (_in(CONTEXT), _in(TACTIC), _in(TACTIC)))
+    */
+    Z3_solver Z3_API Z3_mk_incremental_solver_from_tactic(Z3_context c, Z3_tactic pre, Z3_tactic t);
+
     /**
        \brief Copy a solver \c s from the context \c source to the context \c target.
 
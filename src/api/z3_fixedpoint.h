@@ -87,6 +87,25 @@ extern "C" {
                                        Z3_func_decl r,
                                        unsigned num_args, unsigned args[]);
 
+    /**
+       \brief Retract a Database fact that was added with #Z3_fixedpoint_add_fact.
+
+       \param c - context
+       \param d - fixed point context
+       \param r - relation signature for the row.
+       \param num_args - number of columns for the given row.
+       \param args - array of the row elements.
+
+       Retraction requires the Datalog engine with the parameter \c datalog.incremental
+       set. Subsequent queries update the relations derived from \c r instead of
+       evaluating the rules from scratch.
+
+       def_API('Z3_fixedpoint_remove_fact', VOID, (_in(CONTEXT), _in(FIXEDPOINT), _in(FUNC_DECL), _in(UINT), _in_array(3, UINT)))
+    */
+    void Z3_API Z3_fixedpoint_remove_fact(Z3_context c, Z3_fixedpoint d,
+                                          Z3_func_decl r,
+                                          unsigned num_args, unsigned args[]);
+
     /**
        \brief Assert a constraint to the fixedpoint context.
 
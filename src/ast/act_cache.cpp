@@ -205,7 +205,7 @@ expr * act_cache::find(expr * k) {
 
 void act_cache::reset() {
     dec_refs();
-    m_table.reset();
+    m_table.reset_keep_capacity();
     m_queue.reset();
     m_unused = 0;
     m_qhead = 0;
@@ -0,0 +1,117 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    par_rewriter.cpp
+
+Abstract:
+
+    Apply th_rewriter to a set of formulas in parallel.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#include <mutex>
+#include "util/thread_pool.h"
+#include "util/scoped_ptr_vector.h"
+#include "ast/ast_translation.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/par_rewriter.h"
+
+// the translation to and from the worker managers does not pay off for fewer formulas
+static const unsigned min_formulas_per_thread = 64;
+
+bool par_rewrite(ast_manager & m, params_ref const & p, unsigned num_threads, expr_ref_vector & fmls, unsigned & num_steps) {
+    return par_rewrite(thread_pool::get(), m, p, num_threads, fmls, num_steps);
+}
+
+bool par_rewrite(thread_pool & pool, ast_manager & m, params_ref const & p, unsigned num_threads, expr_ref_vector & fmls, unsigned & num_steps) {
+    unsigned sz = fmls.size();
+    // the calling thread executes tasks of the group while it waits
+    num_threads = std::min(num_threads, pool.num_workers() + 1);
+    num_threads = std::min(num_threads, sz / min_formulas_per_thread);
+    if (thread_pool::in_parallel() || num_threads <= 1 || m.proofs_enabled())
+        return false;
+    IF_VERBOSE(10, verbose_stream() << "(par-rewrite :formulas " << sz << " :threads " << num_threads << ")\n";);
+
+    scoped_ptr_vector<ast_manager>     managers;
+    scoped_limits                      scl(m.limit());
+    scoped_ptr_vector<expr_ref_vector> partitions;
+    vector<params_ref>                 params;
+    unsigned_vector                    steps;
+    for (unsigned i = 0; i < num_threads; ++i) {
+        ast_manager * new_m = alloc(ast_manager, m, true);
+        managers.push_back(new_m);
+        scl.push_child(&new_m->limit());
+        ast_translation translator(m, *new_m);
+        expr_ref_vector * part = alloc(expr_ref_vector, *new_m);
+        for (unsigned j = i * sz / num_threads; j < (i + 1) * sz / num_threads; ++j)
+            part->push_back(translator(fmls.get(j)));
+        partitions.push_back(part);
+        // parameters are reference counted, so each thread gets its own copy
+        params.push_back(params_ref());
+        params.back().copy(p);
+        steps.push_back(0);
+    }
+
+    bool        failed = false;
+    bool        is_error = false;
+    bool        is_rewriter_ex = false;
+    std::string ex_msg;
+    unsigned    error_code = 0;
+    std::mutex  mux;
+
+    thread_pool::task_group tasks(pool);
+    for (unsigned i = 0; i < num_threads; ++i) {
+        tasks.add([&, i]() {
+            try {
+                ast_manager & new_m = *managers[i];
+                expr_ref_vector & part = *partitions[i];
+                th_rewriter rw(new_m, params[i]);
+                expr_ref r(new_m);
+                for (unsigned j = 0; j < part.size(); ++j) {
+                    rw(part.get(j), r);
+                    part[j] = r;
+                    steps[i] += rw.get_num_steps();
+                }
+                return;
+            }
+            catch (z3_error & err) {
+                std::lock_guard<std::mutex> lock(mux);
+                failed = true;
+                is_error = true;
+                error_code = err.error_code();
+            }
+            catch (z3_exception & ex) {
+                std::lock_guard<std::mutex> lock(mux);
+                failed = true;
+                is_rewriter_ex = dynamic_cast<rewriter_exception*>(&ex) != nullptr;
+                ex_msg = ex.msg();
+            }
+            for (unsigned j = 0; j < num_threads; ++j)
+                managers[j]->limit().cancel();
+        });
+    }
+    tasks.wait();
+
+    if (failed) {
+        if (is_error) throw z3_error(error_code);
+        if (is_rewriter_ex) throw rewriter_exception(ex_msg.c_str());
+        throw default_exception(std::move(ex_msg));
+    }
+
+    for (unsigned i = 0; i < num_threads; ++i) {
+        ast_translation translator(*managers[i], m);
+        expr_ref_vector const & part = *partitions[i];
+        unsigned offset = i * sz / num_threads;
+        for (unsigned j = 0; j < part.size(); ++j)
+            fmls[offset + j] = translator(part.get(j));
+        num_steps += steps[i];
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    par_rewriter.h
+
+Abstract:
+
+    Apply th_rewriter to a set of formulas in parallel.
+
+    The formulas are split into consecutive partitions. Every partition is
+    translated to an ast_manager of its own, rewritten by a task of the thread pool
+    and translated back, so the result is the same as rewriting the
+    formulas one by one with the same parameters.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#ifndef PAR_REWRITER_H_
+#define PAR_REWRITER_H_
+
+#include "ast/ast.h"
+#include "util/params.h"
+
+class thread_pool;
+
+/**
+   \brief Rewrite the formulas in \c fmls using up to \c num_threads threads, and
+   add the number of rewriting steps to \c num_steps.
+
+   Return false, leaving \c fmls unchanged, if the formulas are not rewritten in
+   parallel: when there are too few formulas, proofs are enabled, the caller
+   already runs a task of a thread pool or in an OpenMP parallel region, or
+   the pool has no workers.
+*/
+bool par_rewrite(ast_manager & m, params_ref const & p, unsigned num_threads, expr_ref_vector & fmls, unsigned & num_steps);
+
+/**
+   \brief Rewrite the formulas in \c fmls with the tasks of \c pool instead of the shared pool.
+*/
+bool par_rewrite(thread_pool & pool, ast_manager & m, params_ref const & p, unsigned num_threads, expr_ref_vector & fmls, unsigned & num_steps);
+
+#endif
@@ -0,0 +1,135 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    rewrite_cache.cpp
+
+Abstract:
+
+    Rewrite results that are kept across calls to the rewriter.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#include "ast/rewriter/rewrite_cache.h"
+
+rewrite_cache::rewrite_cache(ast_manager & m, unsigned max_size):
+    m(m),
+    m_max_size(max_size),
+    m_first(null_entry),
+    m_last(null_entry) {
+}
+
+rewrite_cache::~rewrite_cache() {
+    reset();
+}
+
+void rewrite_cache::unlink(unsigned idx) {
+    entry & e = m_entries[idx];
+    if (e.m_prev == null_entry)
+        m_first = e.m_next;
+    else
+        m_entries[e.m_prev].m_next = e.m_next;
+    if (e.m_next == null_entry)
+        m_last = e.m_prev;
+    else
+        m_entries[e.m_next].m_prev = e.m_prev;
+}
+
+void rewrite_cache::link_first(unsigned idx) {
+    entry & e = m_entries[idx];
+    e.m_prev = null_entry;
+    e.m_next = m_first;
+    if (m_first == null_entry)
+        m_last = idx;
+    else
+        m_entries[m_first].m_prev = idx;
+    m_first = idx;
+}
+
+void rewrite_cache::evict(unsigned idx) {
+    entry & e = m_entries[idx];
+    unlink(idx);
+    m_table.erase(key(e.m_key->get_id(), e.m_fingerprint));
+    m.dec_ref(e.m_key);
+    m.dec_ref(e.m_value);
+    e.m_key = nullptr;
+    e.m_value = nullptr;
+    m_free.push_back(idx);
+}
+
+void rewrite_cache::set_max_size(unsigned max_size) {
+    m_max_size = max_size;
+    while (m_table.size() > m_max_size) {
+        evict(m_last);
+        m_stats.m_num_evictions++;
+    }
+}
+
+bool rewrite_cache::find(expr * t, unsigned fingerprint, expr * & r) {
+    unsigned idx;
+    if (!m_table.find(key(t->get_id(), fingerprint), idx)) {
+        m_stats.m_num_misses++;
+        return false;
+    }
+    m_stats.m_num_hits++;
+    if (m_first != idx) {
+        unlink(idx);
+        link_first(idx);
+    }
+    r = m_entries[idx].m_value;
+    return true;
+}
+
+void rewrite_cache::insert(expr * t, unsigned fingerprint, expr * r) {
+    if (m_max_size == 0 || contains(t, fingerprint))
+        return;
+    // take the references first, r may only be referenced by the entry that is evicted
+    m.inc_ref(t);
+    m.inc_ref(r);
+    if (m_table.size() >= m_max_size) {
+        evict(m_last);
+        m_stats.m_num_evictions++;
+    }
+    unsigned idx;
+    if (m_free.empty()) {
+        idx = m_entries.size();
+        m_entries.push_back(entry());
+    }
+    else {
+        idx = m_free.back();
+        m_free.pop_back();
+    }
+    entry & e = m_entries[idx];
+    e.m_key = t;
+    e.m_value = r;
+    e.m_fingerprint = fingerprint;
+    link_first(idx);
+    m_table.insert(key(t->get_id(), fingerprint), idx);
+}
+
+void rewrite_cache::reset() {
+    for (entry & e : m_entries) {
+        if (e.m_key) {
+            m.dec_ref(e.m_key);
+            m.dec_ref(e.m_value);
+        }
+    }
+    m_entries.reset();
+    m_free.reset();
+    m_table.reset();
+    m_first = null_entry;
+    m_last = null_entry;
+}
+
+void rewrite_cache::collect_statistics(statistics & st) const {
+    st.update("rewrite cache hits", m_stats.m_num_hits);
+    st.update("rewrite cache misses", m_stats.m_num_misses);
+    st.update("rewrite cache evictions", m_stats.m_num_evictions);
+    st.update("rewrite cache size", m_table.size());
+}
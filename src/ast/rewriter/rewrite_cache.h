@@ -0,0 +1,101 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    rewrite_cache.h
+
+Abstract:
+
+    Rewrite results that are kept across calls to the rewriter.
+
+    The cache of rewriter_tpl only lives for a single call. A rewrite_cache
+    is owned by the client (the simplify command, the API context) and
+    attached to a th_rewriter with th_rewriter::set_cache, so that
+    simplifying terms that overlap with previously simplified terms
+    reuses the results for the shared subterms.
+
+    Entries are keyed by the expression and a fingerprint of the rewriter
+    configuration, since different parameters produce different results.
+    The cache holds references to keys and values. The number of entries
+    is bounded; when the bound is reached the least recently used entry is
+    evicted and its references are released, so terms that are no longer
+    used elsewhere are reclaimed by the ast_manager.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#ifndef REWRITE_CACHE_H_
+#define REWRITE_CACHE_H_
+
+#include "ast/ast.h"
+#include "util/map.h"
+#include "util/statistics.h"
+
+class rewrite_cache {
+    struct entry {
+        expr *   m_key;
+        expr *   m_value;
+        unsigned m_fingerprint;
+        unsigned m_prev;   // more recently used entry
+        unsigned m_next;   // less recently used entry
+    };
+    struct stats {
+        unsigned m_num_hits;
+        unsigned m_num_misses;
+        unsigned m_num_evictions;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+    typedef std::pair<unsigned, unsigned> key;
+    typedef map<key, unsigned, pair_hash<unsigned_hash, unsigned_hash>, default_eq<key> > key2entry;
+
+    static const unsigned null_entry = UINT_MAX;
+
+    ast_manager &   m;
+    unsigned        m_max_size;
+    svector<entry>  m_entries;
+    unsigned_vector m_free;
+    key2entry       m_table;
+    unsigned        m_first;   // most recently used entry
+    unsigned        m_last;    // least recently used entry
+    stats           m_stats;
+
+    void unlink(unsigned idx);
+    void link_first(unsigned idx);
+    void evict(unsigned idx);
+
+public:
+    rewrite_cache(ast_manager & m, unsigned max_size);
+    ~rewrite_cache();
+
+    ast_manager & get_manager() const { return m; }
+    unsigned size() const { return m_table.size(); }
+    unsigned max_size() const { return m_max_size; }
+
+    /**
+       \brief Update the bound on the number of entries, evicting the least recently used entries if needed.
+    */
+    void set_max_size(unsigned max_size);
+
+    /**
+       \brief Return true if \c t was rewritten to \c r under the configuration \c fingerprint.
+       The entry becomes the most recently used one.
+    */
+    bool find(expr * t, unsigned fingerprint, expr * & r);
+
+    bool contains(expr * t, unsigned fingerprint) const { return m_table.contains(key(t->get_id(), fingerprint)); }
+
+    void insert(expr * t, unsigned fingerprint, expr * r);
+
+    void reset();
+
+    void collect_statistics(statistics & st) const;
+    void reset_statistics() { m_stats.reset(); }
+};
+
+#endif
@@ -16,7 +16,9 @@ Author:
 Notes:
 
 --*/
+#include<sstream>
 #include "util/cooperate.h"
+#include "util/gparams.h"
 #include "ast/rewriter/th_rewriter.h"
 #include "ast/rewriter/rewriter_params.hpp"
 #include "ast/rewriter/bool_rewriter.h"
@@ -29,6 +31,7 @@ Notes:
 #include "ast/rewriter/pb_rewriter.h"
 #include "ast/rewriter/seq_rewriter.h"
 #include "ast/rewriter/rewriter_def.h"
+#include "ast/rewriter/rewrite_cache.h"
 #include "ast/rewriter/var_subst.h"
 #include "ast/expr_substitution.h"
 #include "ast/ast_smt2_pp.h"
@@ -62,6 +65,10 @@ struct th_rewriter_cfg : public default_rewriter_cfg {
     expr_dependency_ref m_used_dependencies; // set of dependencies of used substitutions
     expr_substitution * m_subst;
 
+    // results kept across calls
+    rewrite_cache *     m_cache;
+    unsigned            m_fingerprint;
+
     ast_manager & m() const { return m_b_rw.m(); }
 
     void updt_local_params(params_ref const & _p) {
@@ -684,7 +691,9 @@ struct th_rewriter_cfg : public default_rewriter_cfg {
         m_a_util(m),
         m_bv_util(m),
         m_used_dependencies(m),
-        m_subst(nullptr) {
+        m_subst(nullptr),
+        m_cache(nullptr),
+        m_fingerprint(0) {
         updt_local_params(p);
     }
 
@@ -697,9 +706,19 @@ struct th_rewriter_cfg : public default_rewriter_cfg {
         m_subst = nullptr;
     }
 
+    // The rewriting result of a ground application does not depend on the context.
+    static bool is_cacheable(expr * s) {
+        return is_app(s) && to_app(s)->get_num_args() > 0 && is_ground(s);
+    }
+
     bool get_subst(expr * s, expr * & t, proof * & pr) {
-        if (m_subst == nullptr)
+        if (m_subst == nullptr) {
+            if (m_cache && is_cacheable(s) && m_cache->find(s, m_fingerprint, t)) {
+                pr = nullptr;
+                return true;
+            }
             return false;
+        }
         expr_dependency * d = nullptr;
         if (m_subst->find(s, t, pr, d)) {
             m_used_dependencies = m().mk_join(m_used_dependencies, d);
@@ -727,10 +746,49 @@ struct th_rewriter::imp : public rewriter_tpl<th_rewriter_cfg> {
     void set_solver(expr_solver* solver) {
         m_cfg.m_seq_rw.set_solver(solver);
     }
+
+    void set_cache(rewrite_cache * c, unsigned fingerprint) {
+        // cached results have no proofs
+        m_cfg.m_cache = m().proofs_enabled() ? nullptr : c;
+        m_cfg.m_fingerprint = fingerprint;
+    }
+
+    /**
+       \brief Store the result \c r of rewriting \c t and the results for the shared
+       subterms of \c t in the persistent cache.
+       The subterms found in the persistent cache were not visited by the last call.
+    */
+    void cache_results(expr * t, expr * r) {
+        rewrite_cache * c = m_cfg.m_cache;
+        if (c == nullptr || m_cfg.m_subst != nullptr || get_num_steps() > m_cfg.m_max_steps)
+            return;
+        unsigned fp = m_cfg.m_fingerprint;
+        ptr_buffer<expr> todo;
+        expr_mark visited;
+        todo.push_back(t);
+        while (!todo.empty()) {
+            expr * e = todo.back();
+            todo.pop_back();
+            if (!is_app(e) || visited.is_marked(e))
+                continue;
+            visited.mark(e, true);
+            if (th_rewriter_cfg::is_cacheable(e)) {
+                if (c->contains(e, fp))
+                    continue;
+                expr * v = (e == t) ? r : get_cached(e);
+                if (v)
+                    c->insert(e, fp, v);
+            }
+            for (expr * arg : *to_app(e))
+                todo.push_back(arg);
+        }
+    }
 };
 
 th_rewriter::th_rewriter(ast_manager & m, params_ref const & p):
-    m_params(p) {
+    m_params(p),
+    m_cache(nullptr),
+    m_fingerprint(0) {
     m_imp = alloc(imp, m, p);
 }
 
@@ -741,6 +799,8 @@ ast_manager & th_rewriter::m() const {
 void th_rewriter::updt_params(params_ref const & p) {
     m_params = p;
     m_imp->cfg().updt_params(p);
+    if (m_cache)
+        set_cache(m_cache);
 }
 
 void th_rewriter::get_param_descrs(param_descrs & r) {
@@ -768,6 +828,8 @@ void th_rewriter::cleanup() {
     ast_manager & m = m_imp->m();
     m_imp->~imp();
     new (m_imp) imp(m, m_params);
+    if (m_cache)
+        m_imp->set_cache(m_cache, m_fingerprint);
 }
 
 void th_rewriter::reset() {
@@ -778,15 +840,18 @@ void th_rewriter::reset() {
 void th_rewriter::operator()(expr_ref & term) {
     expr_ref result(term.get_manager());
     m_imp->operator()(term, result);
+    m_imp->cache_results(term, result);
     term = std::move(result);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result) {
     m_imp->operator()(t, result);
+    m_imp->cache_results(t, result);
 }
 
 void th_rewriter::operator()(expr * t, expr_ref & result, proof_ref & result_pr) {
     m_imp->operator()(t, result, result_pr);
+    m_imp->cache_results(t, result);
 }
 
 expr_ref th_rewriter::operator()(expr * n, unsigned num_bindings, expr * const * bindings) {
@@ -816,3 +881,22 @@ expr_ref th_rewriter::mk_app(func_decl* f, unsigned num_args, expr* const* args)
 void th_rewriter::set_solver(expr_solver* solver) {
     m_imp->set_solver(solver);
 }
+
+void th_rewriter::set_cache(rewrite_cache * c) {
+    m_cache = c;
+    m_fingerprint = 0;
+    if (c) {
+        // the fingerprint covers the rewriter parameters, including their global defaults
+        std::ostringstream strm;
+        param_descrs r;
+        get_param_descrs(r);
+        params_ref g = gparams::get_module("rewriter");
+        for (unsigned i = 0; i < r.size(); ++i) {
+            symbol k = r.get_param_name(i);
+            m_params.display(strm, k);
+            g.display(strm, k);
+        }
+        m_fingerprint = string_hash(strm.str().c_str(), static_cast<unsigned>(strm.str().size()), 17);
+    }
+    m_imp->set_cache(c, m_fingerprint);
+}
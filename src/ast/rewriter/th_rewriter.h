@@ -27,10 +27,14 @@ class expr_substitution;
 
 class expr_solver;
 
+class rewrite_cache;
+
 class th_rewriter {
-    struct     imp;
-    imp *      m_imp;
-    params_ref m_params;
+    struct          imp;
+    imp *           m_imp;
+    params_ref      m_params;
+    rewrite_cache * m_cache;
+    unsigned        m_fingerprint;
 public:
     th_rewriter(ast_manager & m, params_ref const & p = params_ref());
     ~th_rewriter();
@@ -63,6 +67,12 @@ public:
 
     void set_solver(expr_solver* solver);
 
+    /**
+       \brief Use and extend the results in \c c, which are kept across calls and
+       across rewriters with the same parameters. The cache is not used when proofs are enabled.
+    */
+    void set_cache(rewrite_cache * c);
+
 };
 
 #endif
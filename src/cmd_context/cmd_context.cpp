@@ -1322,6 +1322,7 @@ void cmd_context::reset(bool finalize) {
     m_opt = nullptr;
     m_pp_env = nullptr;
     m_dt_eh  = nullptr;
+    m_rewrite_cache = nullptr;
     if (m_manager) {
         dealloc(m_pmanager);
         m_pmanager = nullptr;
@@ -1936,6 +1937,16 @@ void cmd_context::set_solver_factory(solver_factory * f) {
     }
 }
 
+rewrite_cache & cmd_context::get_rewrite_cache(unsigned max_size) {
+    if (!m_rewrite_cache) {
+        m_rewrite_cache = alloc(rewrite_cache, m(), max_size);
+    }
+    else if (m_rewrite_cache->max_size() != max_size) {
+        m_rewrite_cache->set_max_size(max_size);
+    }
+    return *m_rewrite_cache;
+}
+
 void cmd_context::display_statistics(bool show_total_time, double total_time) {
     statistics st;
     if (show_total_time)
@@ -1952,6 +1963,9 @@ void cmd_context::display_statistics(bool show_total_time, double total_time) {
     else if (m_opt) {
         m_opt->collect_statistics(st);
     }
+    if (m_rewrite_cache) {
+        m_rewrite_cache->collect_statistics(st);
+    }
     st.display_smt2(regular_stream());
 }
 
@@ -34,6 +34,7 @@ Notes:
 #include "ast/datatype_decl_plugin.h"
 #include "ast/recfun_decl_plugin.h"
 #include "ast/rewriter/seq_rewriter.h"
+#include "ast/rewriter/rewrite_cache.h"
 #include "tactic/generic_model_converter.h"
 #include "solver/solver.h"
 #include "solver/progress_callback.h"
@@ -266,6 +267,8 @@ protected:
     scoped_ptr<pp_env>            m_pp_env;
     pp_env & get_pp_env() const;
 
+    scoped_ptr<rewrite_cache>     m_rewrite_cache; // simplification results kept across simplify commands
+
     void register_builtin_sorts(decl_plugin * p);
     void register_builtin_ops(decl_plugin * p);
     void load_plugin(symbol const & name, bool install_names, svector<family_id>& fids);
@@ -362,6 +365,10 @@ public:
     ast_manager & m() const { const_cast<cmd_context*>(this)->init_manager(); return *m_manager; }
     ast_manager & get_ast_manager() override { return m(); }
     pdecl_manager & pm() const { if (!m_pmanager) const_cast<cmd_context*>(this)->init_manager(); return *m_pmanager; }
+    /**
+       \brief Return the cache of simplification results with at most \c max_size entries.
+    */
+    rewrite_cache & get_rewrite_cache(unsigned max_size);
     sexpr_manager & sm() const { if (!m_sexpr_manager) const_cast<cmd_context*>(this)->m_sexpr_manager = alloc(sexpr_manager); return *m_sexpr_manager; }
 
     void set_solver_factory(solver_factory * s);
@@ -17,6 +17,7 @@ Notes:
 --*/
 #include "cmd_context/cmd_context.h"
 #include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/rewriter_params.hpp"
 #include "ast/shared_occs.h"
 #include "ast/ast_smt_pp.h"
 #include "ast/for_each_expr.h"
@@ -74,6 +75,9 @@ public:
         th_rewriter s(ctx.m(), m_params);
         th_solver solver(ctx);
         s.set_solver(alloc(th_solver, ctx));
+        rewriter_params rp(m_params);
+        if (rp.persistent_cache() > 0)
+            s.set_cache(&ctx.get_rewrite_cache(rp.persistent_cache()));
         unsigned cache_sz;
         unsigned num_steps = 0;
         unsigned timeout   = m_params.get_uint("timeout", UINT_MAX);
@@ -28,6 +28,8 @@ Notes:
 #include "tactic/tactic.h"
 #include "tactic/tactical.h"
 #include "tactic/probe.h"
+#include "tactic/portfolio_tactic.h"
+#include "tactic/profile_tactic.h"
 #include "solver/check_sat_result.h"
 #include "cmd_context/cmd_context_to_goal.h"
 #include "cmd_context/echo_tactic.h"
@@ -89,6 +91,7 @@ void help_tactic(cmd_context & ctx) {
     buf << "- (or-else <tactic>+) tries the given tactics in sequence until one of them succeeds (i.e., the first that doesn't fail).\n";
     buf << "- (par-or <tactic>+) executes the given tactics in parallel until one of them succeeds (i.e., the first that doesn't fail).\n";
     buf << "- (par-then <tactic1> <tactic2>) executes tactic1 and then tactic2 to every subgoal produced by tactic1. All subgoals are processed in parallel.\n";
+    buf << "- (portfolio <tactic>+) executes the given tactics in rounds of increasing time slices until one of them decides the goal, see portfolio.* parameters.\n";
     buf << "- (try-for <tactic> <num>) executes the given tactic for at most <num> milliseconds, it fails if the execution takes more than <num> milliseconds.\n";
     buf << "- (if <probe> <tactic> <tactic>) if <probe> evaluates to true, then execute the first tactic. Otherwise execute the second.\n";
     buf << "- (when <probe> <tactic>) shorthand for (if <probe> <tactic> skip).\n";
@@ -461,6 +464,26 @@ static tactic * mk_par_then(cmd_context & ctx, sexpr * n) {
     return par_and_then(args.size(), args.c_ptr());
 }
 
+static tactic * mk_portfolio(cmd_context & ctx, sexpr * n) {
+    SASSERT(n->is_composite());
+    unsigned num_children = n->get_num_children();
+    if (num_children < 2)
+        throw cmd_exception("invalid portfolio combinator, at least one argument expected", n->get_line(), n->get_pos());
+    // the outcomes of every tactic are recorded under its text
+    vector<std::string> names;
+    ptr_buffer<char const> name_ptrs;
+    tactic_ref_buffer args;
+    for (unsigned i = 1; i < num_children; i++) {
+        std::ostringstream buf;
+        n->get_child(i)->display(buf);
+        names.push_back(buf.str());
+        args.push_back(sexpr2tactic(ctx, n->get_child(i)));
+    }
+    for (std::string const & name : names)
+        name_ptrs.push_back(name.c_str());
+    return mk_portfolio_tactic(ctx.m(), args.size(), name_ptrs.c_ptr(), args.c_ptr());
+}
+
 static tactic * mk_try_for(cmd_context & ctx, sexpr * n) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
@@ -653,7 +676,7 @@ static tactic * mk_skip_if_failed(cmd_context & ctx, sexpr * n) {
     return skip_if_failed(t);
 }
 
-tactic * sexpr2tactic(cmd_context & ctx, sexpr * n) {
+static tactic * sexpr2tactic_core(cmd_context & ctx, sexpr * n) {
     if (n->is_symbol()) {
         tactic_cmd * cmd = ctx.find_tactic_cmd(n->get_symbol());
         if (cmd != nullptr)
@@ -681,6 +704,8 @@ tactic * sexpr2tactic(cmd_context & ctx, sexpr * n) {
             return mk_par(ctx, n);
         else if (cmd_name == "par-then")
             return mk_par_then(ctx, n);
+        else if (cmd_name == "portfolio")
+            return mk_portfolio(ctx, n);
         else if (cmd_name == "try-for")
             return mk_try_for(ctx, n);
         else if (cmd_name == "repeat")
@@ -713,6 +738,13 @@ tactic * sexpr2tactic(cmd_context & ctx, sexpr * n) {
     }
 }
 
+tactic * sexpr2tactic(cmd_context & ctx, sexpr * n) {
+    tactic * t = sexpr2tactic_core(ctx, n);
+    // every node of the strategy is profiled under its symbol or combinator name
+    sexpr * head = n->is_composite() ? n->get_child(0) : n;
+    return mk_profile_tactic_if_enabled(head->get_symbol().str().c_str(), t);
+}
+
 static probe * mk_not_probe (cmd_context & ctx, sexpr * n) {
     SASSERT(n->is_composite());
     unsigned num_children = n->get_num_children();
@@ -283,6 +283,7 @@ inline void grobner::add_var(monomial * m, expr * v) {
     SASSERT(!m_util.is_numeral(v));
      m_manager.inc_ref(v);
      m->m_vars.push_back(v);
+     m->m_vars_mask |= var_mask(v);
 }
 
 grobner::monomial * grobner::mk_monomial(rational const & coeff, unsigned num_vars, expr * const * vars) {
@@ -320,6 +321,7 @@ grobner::monomial * grobner::mk_monomial(rational const & coeff, expr * m) {
     else {
         r->m_coeff = coeff;
         r->m_vars.push_back(m);
+        r->m_vars_mask = var_mask(m);
         m_manager.inc_ref(m);
     }
     return r;
@@ -408,6 +410,7 @@ void grobner::assert_monomial_tautology(expr * m) {
     m1->m_coeff     = rational(-1);
     m_manager.inc_ref(m);
     m1->m_vars.push_back(m);
+    m1->m_vars_mask = var_mask(m);
     eq->m_monomials.push_back(m1);
     normalize_coeff(eq->m_monomials);                                          
     init_equation(eq, static_cast<v_dependency*>(nullptr));                                                          \
@@ -533,7 +536,8 @@ bool grobner::is_subset(monomial const * m1, monomial const * m2, ptr_vector<exp
     unsigned i2  = 0;
     unsigned sz1 = m1->m_vars.size();
     unsigned sz2 = m2->m_vars.size();
-    if (sz1 <= sz2) {
+    // a variable of m1 that does not occur in m2 is usually detected by the masks
+    if (sz1 <= sz2 && (m1->m_vars_mask & ~m2->m_vars_mask) == 0) {
         while (true) {
             if (i1 >= sz1) {
                 for (; i2 < sz2; i2++) 
@@ -574,6 +578,9 @@ bool grobner::is_subset(monomial const * m1, monomial const * m2, ptr_vector<exp
 */
 void grobner::mul_append(unsigned start_idx, equation const * source, rational const & coeff, ptr_vector<expr> const & vars, ptr_vector<monomial> & result) {
     unsigned sz = source->get_num_monomials();
+    uint64_t mask = 0;
+    for (expr * v : vars) 
+        mask |= var_mask(v);
     for (unsigned i = start_idx; i < sz; i++) {
         monomial const * m = source->get_monomial(i);
         monomial * new_m   = alloc(monomial);
@@ -581,6 +588,7 @@ void grobner::mul_append(unsigned start_idx, equation const * source, rational c
         new_m->m_coeff    *= coeff;
         new_m->m_vars.append(m->m_vars.size(), m->m_vars.c_ptr());
         new_m->m_vars.append(vars.size(), vars.c_ptr());
+        new_m->m_vars_mask = m->m_vars_mask | mask;
         ptr_vector<expr>::iterator it  = new_m->m_vars.begin();
         ptr_vector<expr>::iterator end = new_m->m_vars.end();
         for (; it != end; ++it)
@@ -845,6 +853,8 @@ void grobner::simplify_to_process(equation * eq) {
 */
 bool grobner::unify(monomial const * m1, monomial const * m2, ptr_vector<expr> & rest1, ptr_vector<expr> & rest2) {
     TRACE("grobner", tout << "unifying: "; display_monomial(tout, *m1); tout << " "; display_monomial(tout, *m2); tout << "\n";);
+    if ((m1->m_vars_mask & m2->m_vars_mask) == 0) 
+        return false; // m1 and m2 do not share variables
     bool found_M = false;
     unsigned i1  = 0;
     unsigned i2  = 0;
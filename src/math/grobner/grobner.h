@@ -45,11 +45,12 @@ public:
     class monomial {
         rational         m_coeff;
         ptr_vector<expr> m_vars;  //!< sorted variables
+        uint64_t         m_vars_mask; //!< superset of the variable ids modulo 64, used to filter divisibility tests
         
         friend class grobner;
         friend struct monomial_lt;
 
-        monomial() {}
+        monomial():m_vars_mask(0) {}
     public:
         rational const & get_coeff() const { return m_coeff; }
         unsigned get_degree() const { return m_vars.size(); }
@@ -77,6 +78,8 @@ public:
 protected:
     static bool is_eq_monomial_body(monomial const * m1, monomial const * m2);
 
+    static uint64_t var_mask(expr * v) { return static_cast<uint64_t>(1) << (v->get_id() & 63); }
+
     struct var_lt {
         obj_map<expr, int> & m_var2weight;
         var_lt(obj_map<expr, int> & m):m_var2weight(m) {}
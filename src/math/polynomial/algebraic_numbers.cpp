@@ -27,6 +27,9 @@ Notes:
 #include "util/timeit.h"
 #include "math/polynomial/algebraic_params.hpp"
 #include "util/common_msgs.h"
+#include <cfloat>
+#include <cmath>
+#include <limits>
 
 namespace algebraic_numbers {
 
@@ -96,6 +99,13 @@ namespace algebraic_numbers {
         unsigned                 m_compare_sturm;
         unsigned                 m_compare_refine;
         unsigned                 m_compare_poly_eq;
+        unsigned                 m_compare_double;
+        unsigned                 m_compare_exact;
+        unsigned                 m_eval_sign_double;
+        unsigned                 m_eval_sign_double_interval;
+        unsigned                 m_eval_sign_rational;
+        unsigned                 m_eval_sign_interval;
+        unsigned                 m_eval_sign_resultant;
 
         imp(reslimit& lim, manager & w, unsynch_mpq_manager & m, params_ref const & p, small_object_allocator & a):
             m_limit(lim),
@@ -136,6 +146,13 @@ namespace algebraic_numbers {
             m_compare_sturm   = 0;
             m_compare_refine  = 0;
             m_compare_poly_eq = 0;
+            m_compare_double  = 0;
+            m_compare_exact   = 0;
+            m_eval_sign_double    = 0;
+            m_eval_sign_double_interval = 0;
+            m_eval_sign_rational  = 0;
+            m_eval_sign_interval  = 0;
+            m_eval_sign_resultant = 0;
         }
 
         void collect_statistics(statistics & st) {
@@ -145,6 +162,14 @@ namespace algebraic_numbers {
             st.update("algebraic compare refine", m_compare_refine);
             st.update("algebraic compare poly", m_compare_poly_eq);
 #endif
+            // hit rates of the floating point filters
+            st.update("algebraic compare rational double", m_compare_double);
+            st.update("algebraic compare rational exact", m_compare_exact);
+            st.update("algebraic eval sign double", m_eval_sign_double);
+            st.update("algebraic eval sign double interval", m_eval_sign_double_interval);
+            st.update("algebraic eval sign rational", m_eval_sign_rational);
+            st.update("algebraic eval sign interval", m_eval_sign_interval);
+            st.update("algebraic eval sign resultant", m_eval_sign_resultant);
         }
 
         void updt_params(params_ref const & _p) {
@@ -1672,6 +1697,62 @@ namespace algebraic_numbers {
             return qm().lt(a, b) ? -1 : 1;
         }
 
+        /**
+           \brief Bound on the rounding error of a sum of sz terms computed with doubles,
+           where every term is computed with at most max_ops roundings and mag is the
+           computed sum of the absolute values of the terms.
+           Every conversion of a small integer or a small rational to a double is counted as a
+           rounding, even if it is exact. DBL_EPSILON is twice the unit roundoff; the factor
+           covers the higher order terms of the error and the error in mag itself.
+        */
+        static double double_error_bound(unsigned max_ops, unsigned sz, double mag) {
+            return static_cast<double>(max_ops + sz + 2) * DBL_EPSILON * mag;
+        }
+
+        /**
+           \brief Try to compute the sign of the univariate polynomial p at b using floating point arithmetic.
+           It succeeds only if b and the coefficients of p are small, and the magnitude of the value
+           exceeds the bound on the rounding error.
+        */
+        bool eval_sign_at_double(unsigned sz, mpz const * p, mpq const & b, int & r) {
+            if (!qm().is_small(b))
+                return false;
+            double d        = qm().get_double(b);
+            // numerator, denominator and their quotient
+            unsigned conv   = qm().is_int(b) ? 1 : 3;
+            double pw       = 1.0;
+            double val      = 0.0;
+            double mag      = 0.0;
+            unsigned max_ops = 0;
+            for (unsigned i = 0; i < sz; i++) {
+                if (i > 0) {
+                    pw *= d;
+                    // give up before overflows and underflows invalidate the error bound
+                    if (!std::isfinite(pw) || (pw != 0.0 && std::fabs(pw) < 1e-290))
+                        return false;
+                }
+                if (qm().is_zero(p[i]))
+                    continue;
+                if (!qm().is_small(p[i]))
+                    return false;
+                double t = qm().get_double(p[i]) * pw;
+                // the conversion of the coefficient, the error of d raised to the power i, and i multiplications
+                max_ops = std::max(max_ops, 1 + (conv + 1) * i);
+                val += t;
+                mag += std::fabs(t);
+            }
+            if (!std::isfinite(val) || !std::isfinite(mag))
+                return false;
+            if (mag == 0.0) {
+                r = 0;
+                return true;
+            }
+            if (std::fabs(val) <= double_error_bound(max_ops, sz, mag))
+                return false;
+            r = val > 0.0 ? 1 : -1;
+            return true;
+        }
+
         /**
           Comparing algebraic_cells with rationals
           Given an algebraic cell c with isolating interval (l, u) for p and a rational b
@@ -1695,7 +1776,14 @@ namespace algebraic_numbers {
             if (bqm().ge(l, b))
                 return 1;
             // b is in the isolating interval (l, u)
-            int sign_b = upm().eval_sign_at(c->m_p_sz, c->m_p, b);
+            int sign_b;
+            if (eval_sign_at_double(c->m_p_sz, c->m_p, b, sign_b)) {
+                m_compare_double++;
+            }
+            else {
+                m_compare_exact++;
+                sign_b = upm().eval_sign_at(c->m_p_sz, c->m_p, b);
+            }
             if (sign_b == 0)
                 return 0;
             return sign_b == sign_lower(c) ? 1 : -1;
@@ -1873,6 +1961,29 @@ namespace algebraic_numbers {
             }
         }
 
+        /**
+           \brief Binary search for a in the sorted vector roots.
+           Only O(log n) comparisons are performed, and the isolating interval of a
+           is refined once and reused by the following comparisons.
+        */
+        unsigned locate(numeral & a, unsigned sz, numeral * roots, bool & is_root) {
+            unsigned lo = 0, hi = sz;
+            is_root = false;
+            while (lo < hi) {
+                unsigned mid = lo + (hi - lo) / 2;
+                int s = compare(a, roots[mid]);
+                if (s == 0) {
+                    is_root = true;
+                    return mid;
+                }
+                if (s < 0)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            return lo;
+        }
+
         bool eq(numeral & a, numeral & b) {
             return compare(a, b) == 0;
         }
@@ -1976,9 +2087,185 @@ namespace algebraic_numbers {
         };
 
         polynomial::var_vector m_eval_sign_vars;
+        /**
+           \brief Try to compute the sign of p at x2v using floating point arithmetic.
+           It succeeds only if all variables of p are assigned to rationals, and the coefficients
+           and the numerators and denominators of the values fit in machine integers.
+           The sign is accepted only if the magnitude of the computed value exceeds the bound
+           on the accumulated rounding error (see double_error_bound).
+        */
+        bool eval_sign_at_double(polynomial::manager & ext_pm, polynomial_ref const & p, polynomial::var2anum const & x2v, int & r) {
+            unsigned sz       = ext_pm.size(p);
+            unsigned max_ops  = 0;
+            double val        = 0.0;
+            double mag        = 0.0;
+            for (unsigned i = 0; i < sz; i++) {
+                mpz const & a = ext_pm.coeff(p, i);
+                if (!qm().is_small(a))
+                    return false;
+                double t      = qm().get_double(a);
+                unsigned ops  = 1;
+                polynomial::monomial * m = ext_pm.get_monomial(p, i);
+                unsigned msz  = ext_pm.size(m);
+                for (unsigned j = 0; j < msz && t != 0.0; j++) {
+                    polynomial::var x = ext_pm.get_var(m, j);
+                    if (!x2v.contains(x))
+                        return false;
+                    anum const & v = x2v(x);
+                    if (!v.is_basic())
+                        return false;
+                    mpq const & q = basic_value(v);
+                    if (!qm().is_small(q))
+                        return false;
+                    if (qm().is_zero(q)) {
+                        t = 0.0;
+                        break;
+                    }
+                    double d = qm().get_double(q);
+                    // numerator, denominator and their quotient
+                    unsigned conv = qm().is_int(q) ? 1 : 3;
+                    unsigned k = ext_pm.degree(m, j);
+                    for (unsigned l = 0; l < k; l++) {
+                        t *= d;
+                        // give up before overflows and underflows invalidate the error bound
+                        if (!std::isfinite(t) || std::fabs(t) < 1e-290)
+                            return false;
+                    }
+                    // the error of d is raised to the power k, and there are k multiplications
+                    ops += (conv + 1) * k;
+                }
+                max_ops = std::max(max_ops, ops);
+                val += t;
+                mag += std::fabs(t);
+            }
+            if (!std::isfinite(val) || !std::isfinite(mag))
+                return false;
+            if (mag == 0.0) {
+                r = 0;
+                return true;
+            }
+            if (std::fabs(val) <= double_error_bound(max_ops, sz, mag))
+                return false;
+            r = val > 0.0 ? 1 : -1;
+            return true;
+        }
+
+        /**
+           \brief Enclose the result of a double operation: a correctly rounded result is within one ulp
+           of the exact value, so moving the bounds one ulp outwards gives an interval that contains it.
+        */
+        static bool widen(double & lo, double & hi) {
+            lo = std::nextafter(lo, -std::numeric_limits<double>::infinity());
+            hi = std::nextafter(hi, std::numeric_limits<double>::infinity());
+            return std::isfinite(lo) && std::isfinite(hi);
+        }
+
+        bool to_double_interval(mpz const & a, double & lo, double & hi) {
+            if (!qm().is_small(a))
+                return false;
+            lo = hi = qm().get_double(a);
+            return widen(lo, hi);
+        }
+
+        bool to_double_interval(mpq const & a, double & lo, double & hi) {
+            double nlo, nhi, dlo, dhi;
+            if (!to_double_interval(a.numerator(), nlo, nhi) || !to_double_interval(a.denominator(), dlo, dhi))
+                return false;
+            // the denominator is positive
+            lo = nlo >= 0.0 ? nlo / dhi : nlo / dlo;
+            hi = nhi >= 0.0 ? nhi / dlo : nhi / dhi;
+            return widen(lo, hi);
+        }
+
+        bool to_double_interval(mpbq const & a, double & lo, double & hi) {
+            if (!to_double_interval(a.numerator(), lo, hi))
+                return false;
+            int k = -static_cast<int>(a.k());
+            lo = std::ldexp(lo, k);
+            hi = std::ldexp(hi, k);
+            return widen(lo, hi);
+        }
+
+        static bool mul_double_interval(double alo, double ahi, double blo, double bhi, double & lo, double & hi) {
+            double p1 = alo * blo, p2 = alo * bhi, p3 = ahi * blo, p4 = ahi * bhi;
+            lo = std::min(std::min(p1, p2), std::min(p3, p4));
+            hi = std::max(std::max(p1, p2), std::max(p3, p4));
+            return widen(lo, hi);
+        }
+
+        /**
+           \brief Try to compute the sign of p at x2v using interval arithmetic on doubles, when some variables
+           of p are assigned to irrational numbers. An irrational number is replaced by its isolating interval.
+           It succeeds only if the coefficients, the rational values and the bounds of the isolating intervals
+           are small, and the resulting interval does not contain zero.
+           The isolating intervals are not refined: this is a cheap filter before the exact interval evaluation.
+        */
+        bool eval_sign_at_double_interval(polynomial::manager & ext_pm, polynomial_ref const & p, polynomial::var2anum const & x2v, int & r) {
+            m_eval_sign_vars.reset();
+            ext_pm.vars(p, m_eval_sign_vars);
+            bool has_irrational = false;
+            for (polynomial::var x : m_eval_sign_vars) {
+                if (!x2v.contains(x))
+                    return false;
+                if (!x2v(x).is_basic())
+                    has_irrational = true;
+            }
+            if (!has_irrational)
+                return false;
+            unsigned sz = ext_pm.size(p);
+            double lo = 0.0, hi = 0.0;
+            for (unsigned i = 0; i < sz; i++) {
+                double tlo, thi;
+                if (!to_double_interval(ext_pm.coeff(p, i), tlo, thi))
+                    return false;
+                polynomial::monomial * m = ext_pm.get_monomial(p, i);
+                unsigned msz = ext_pm.size(m);
+                for (unsigned j = 0; j < msz; j++) {
+                    anum const & v = x2v(ext_pm.get_var(m, j));
+                    double vlo, vhi;
+                    if (v.is_basic()) {
+                        if (!to_double_interval(basic_value(v), vlo, vhi))
+                            return false;
+                    }
+                    else {
+                        algebraic_cell * c = v.to_algebraic();
+                        double ulo, uhi;
+                        if (!to_double_interval(lower(c), vlo, uhi) || !to_double_interval(upper(c), ulo, vhi))
+                            return false;
+                    }
+                    unsigned k = ext_pm.degree(m, j);
+                    for (unsigned l = 0; l < k; l++)
+                        if (!mul_double_interval(tlo, thi, vlo, vhi, tlo, thi))
+                            return false;
+                }
+                lo += tlo;
+                hi += thi;
+                if (!widen(lo, hi))
+                    return false;
+            }
+            if (lo > 0.0)
+                r = 1;
+            else if (hi < 0.0)
+                r = -1;
+            else
+                return false;
+            return true;
+        }
+
         int eval_sign_at(polynomial_ref const & p, polynomial::var2anum const & x2v) {
             polynomial::manager & ext_pm = p.m();
             TRACE("anum_eval_sign", tout << "evaluating sign of: " << p << "\n";);
+            int sign;
+            if (eval_sign_at_double(ext_pm, p, x2v, sign)) {
+                TRACE("anum_eval_sign", tout << "sign using doubles: " << sign << "\n";);
+                m_eval_sign_double++;
+                return sign;
+            }
+            if (eval_sign_at_double_interval(ext_pm, p, x2v, sign)) {
+                TRACE("anum_eval_sign", tout << "sign using double intervals: " << sign << "\n";);
+                m_eval_sign_double_interval++;
+                return sign;
+            }
             while (true) {
                 bool restart = false;
                 // Optimistic: maybe x2v contains only rational values
@@ -1987,6 +2274,7 @@ namespace algebraic_numbers {
                     scoped_mpq r(qm());
                     ext_pm.eval(p, x2v_basic, r);
                     TRACE("anum_eval_sign", tout << "all variables are assigned to rationals, value of p: " << r << "\n";);
+                    m_eval_sign_rational++;
                     return qm().sign(r);
                 }
                 catch (const opt_var2basic::failed &) {
@@ -2001,12 +2289,14 @@ namespace algebraic_numbers {
 
                 if (ext_pm.is_zero(p_prime)) {
                     // polynomial vanished after substituting rational values.
+                    m_eval_sign_rational++;
                     return 0;
                 }
 
                 if (is_const(p_prime)) {
                     // polynomial became the constant polynomial after substitution.
                     SASSERT(size(p_prime) == 1);
+                    m_eval_sign_rational++;
                     return ext_pm.m().sign(ext_pm.coeff(p_prime, 0));
                 }
 
@@ -2023,6 +2313,7 @@ namespace algebraic_numbers {
                     ext_pm.eval(p_prime, x2v_interval, ri);
                     TRACE("anum_eval_sign", tout << "evaluating using intervals: " << ri << "\n";);
                     if (!bqim().contains_zero(ri)) {
+                        m_eval_sign_interval++;
                         return bqim().is_pos(ri) ? 1 : -1;
                     }
                     // refine intervals if magnitude > m_min_magnitude
@@ -2064,8 +2355,10 @@ namespace algebraic_numbers {
                 // Remark: m_zero_accuracy == 0 means use precise computation.
                 if (m_zero_accuracy > 0) {
                     // assuming the value is 0, since the result is in (-1/2^k, 1/2^k), where m_zero_accuracy = k
+                    m_eval_sign_interval++;
                     return 0;
                 }
+                m_eval_sign_resultant++;
 #if 0
                 // Evaluating sign using algebraic arithmetic
                 scoped_anum ra(m_wrapper);
@@ -2938,6 +3231,10 @@ namespace algebraic_numbers {
         return m_imp->compare(const_cast<numeral&>(a), const_cast<numeral&>(b));
     }
 
+    unsigned manager::locate(numeral const & a, numeral_vector const & roots, bool & is_root) {
+        return m_imp->locate(const_cast<numeral&>(a), roots.size(), const_cast<numeral*>(roots.c_ptr()), is_root);
+    }
+
     bool manager::eq(numeral const & a, numeral const & b) {
         return m_imp->eq(const_cast<numeral&>(a), const_cast<numeral&>(b));
     }
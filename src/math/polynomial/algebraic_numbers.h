@@ -251,6 +251,14 @@ namespace algebraic_numbers {
            Return 1  if a > b
         */
         int compare(numeral const & a, numeral const & b);
+
+        /**
+           \brief Given a vector of roots sorted in increasing order (e.g., produced by isolate_roots),
+           return the number of roots smaller than a. If a is one of the roots, then
+           is_root is set to true and the result is its position in the vector.
+           Only O(log n) comparisons are performed.
+        */
+        unsigned locate(numeral const & a, numeral_vector const & roots, bool & is_root);
         
         /**
            \brief a == b
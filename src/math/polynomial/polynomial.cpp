@@ -3766,6 +3766,21 @@ namespace polynomial {
             r  = R.mk();
         }
 
+        /**
+           \brief Return true if the candidate reconstructed by the CRA should be checked by trial division.
+
+           Trial division of u and v is much more expensive than computing one more modular image.
+           So it is performed for the first image, and after that only when a new prime did not
+           change the candidate, or no more primes are left.
+           The candidate is saved in prev_candidate.
+        */
+        bool is_stable_mod_gcd_candidate(polynomial_ref const & candidate, polynomial_ref & prev_candidate, unsigned prime_idx) {
+            bool r = prev_candidate.get() == nullptr || prime_idx + 1 == NUM_BIG_PRIMES || eq(candidate, prev_candidate);
+            TRACE("mgcd", if (!r) tout << "candidate is not stable, skipping trial division\n";);
+            prev_candidate = candidate;
+            return r;
+        }
+
         void uni_mod_gcd(polynomial const * u, polynomial const * v, polynomial_ref & r) {
             TRACE("mgcd", tout << "univ_modular_gcd\nu: "; u->display(tout, m_manager); tout << "\nv: "; v->display(tout, m_manager); tout << "\n";);
             SASSERT(!m().modular());
@@ -3798,6 +3813,7 @@ namespace polynomial {
             polynomial_ref q(m_wrapper);
 
             polynomial_ref candidate(m_wrapper);
+            polynomial_ref prev_candidate(m_wrapper);
 
             scoped_numeral p(m());
             for (unsigned i = 0; i < NUM_BIG_PRIMES; i++) {
@@ -3841,6 +3857,7 @@ namespace polynomial {
                         TRACE("mgcd", tout << "discarding image\n";);
                         C_star = q;
                         m().set(bound, p);
+                        prev_candidate = nullptr;
                     }
                     else {
                         CRA_combine_images(q, p, C_star, bound, C_star);
@@ -3849,6 +3866,8 @@ namespace polynomial {
                 }
                 candidate = pp(C_star, x);
                 TRACE("mgcd", tout << "candidate:\n" << candidate << "\n";);
+                if (!is_stable_mod_gcd_candidate(candidate, prev_candidate, i))
+                    continue;
                 scoped_numeral lc_candidate(m());
                 lc_candidate = univ_coeff(candidate, degree(candidate, x));
                 if (m().divides(lc_candidate, lc_g) &&
@@ -4281,6 +4300,7 @@ namespace polynomial {
             scoped_numeral bound(m());
             polynomial_ref q(m_wrapper);
             polynomial_ref candidate(m_wrapper);
+            polynomial_ref prev_candidate(m_wrapper);
             scoped_numeral p(m());
 
             for (unsigned i = 0; i < NUM_BIG_PRIMES; i++) {
@@ -4324,6 +4344,7 @@ namespace polynomial {
                         TRACE("mgcd", tout << "discarding image\n";);
                         C_star = q;
                         m().set(bound, p);
+                        prev_candidate = nullptr;
                     }
                     else {
                         CRA_combine_images(q, p, C_star, bound, C_star);
@@ -4332,6 +4353,8 @@ namespace polynomial {
                 }
                 candidate = normalize(C_star);
                 TRACE("mgcd", tout << "candidate:\n" << candidate << "\n";);
+                if (!is_stable_mod_gcd_candidate(candidate, prev_candidate, i))
+                    continue;
                 scoped_numeral lc_candidate(m());
                 lc_candidate = candidate->a(candidate->graded_lex_max_pos());
                 if (m().divides(lc_candidate, lc_g) &&
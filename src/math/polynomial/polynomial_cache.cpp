@@ -85,6 +85,15 @@ namespace polynomial {
     typedef chashtable<psc_chain_entry*, psc_chain_entry::hash_proc, psc_chain_entry::eq_proc> psc_chain_cache;
     typedef chashtable<factor_entry*, factor_entry::hash_proc, factor_entry::eq_proc> factor_cache;
     
+    struct cache_stats {
+        unsigned m_psc_chain_hits;
+        unsigned m_psc_chain_misses;
+        unsigned m_factor_hits;
+        unsigned m_factor_misses;
+        void reset() { memset(this, 0, sizeof(*this)); }
+        cache_stats() { reset(); }
+    };
+
     struct cache::imp { 
         manager &                m;
         polynomial_table         m_poly_table;
@@ -93,6 +102,7 @@ namespace polynomial {
         polynomial_ref_vector    m_cached_polys;
         svector<char>            m_in_cache;
         small_object_allocator & m_allocator;
+        cache_stats              m_stats;
 
         imp(manager & _m):m(_m), m_poly_table(poly_hash_proc(m), poly_eq_proc(m)), m_cached_polys(m), m_allocator(m.allocator()) {
         }
@@ -154,6 +164,7 @@ namespace polynomial {
             psc_chain_entry * entry = new (m_allocator.allocate(sizeof(psc_chain_entry))) psc_chain_entry(p, q, x, h);
             psc_chain_entry * old_entry = m_psc_chain_cache.insert_if_not_there(entry); 
             if (entry != old_entry) {
+                m_stats.m_psc_chain_hits++;
                 entry->~psc_chain_entry();
                 m_allocator.deallocate(sizeof(psc_chain_entry), entry);
                 S.reset();
@@ -162,6 +173,7 @@ namespace polynomial {
                 }
             }
             else {
+                m_stats.m_psc_chain_misses++;
                 m.psc_chain(p, q, x, S);
                 unsigned sz = S.size();
                 entry->m_result_sz = sz;
@@ -181,6 +193,7 @@ namespace polynomial {
             factor_entry * entry = new (m_allocator.allocate(sizeof(factor_entry))) factor_entry(p, h);
             factor_entry * old_entry = m_factor_cache.insert_if_not_there(entry); 
             if (entry != old_entry) {
+                m_stats.m_factor_hits++;
                 entry->~factor_entry();
                 m_allocator.deallocate(sizeof(factor_entry), entry);
                 distinct_factors.reset();
@@ -189,6 +202,7 @@ namespace polynomial {
                 }
             }
             else {
+                m_stats.m_factor_misses++;
                 factors fs(m);
                 m.factor(p, fs);
                 unsigned sz = fs.distinct_factors();
@@ -229,7 +243,20 @@ namespace polynomial {
     
     void cache::reset() {
         manager & _m = m();
+        cache_stats st = m_imp->m_stats;
         dealloc(m_imp);
         m_imp = alloc(imp, _m);
+        m_imp->m_stats = st;
+    }
+
+    void cache::collect_statistics(statistics & st) const {
+        st.update("polynomial cache psc hits", m_imp->m_stats.m_psc_chain_hits);
+        st.update("polynomial cache psc misses", m_imp->m_stats.m_psc_chain_misses);
+        st.update("polynomial cache factor hits", m_imp->m_stats.m_factor_hits);
+        st.update("polynomial cache factor misses", m_imp->m_stats.m_factor_misses);
+    }
+
+    void cache::reset_statistics() {
+        m_imp->m_stats.reset();
     }
 };
@@ -20,6 +20,7 @@ Notes:
 #define POLYNOMIAL_CACHE_H_
 
 #include "math/polynomial/polynomial.h"
+#include "util/statistics.h"
 
 namespace polynomial {
 
@@ -37,7 +38,12 @@ namespace polynomial {
         polynomial * mk_unique(polynomial * p);
         void psc_chain(polynomial const * p, polynomial const * q, var x, polynomial_ref_vector & S);
         void factor(polynomial const * p, polynomial_ref_vector & distinct_factors);
+        /**
+           \brief Remove all cached polynomials and results. The statistics are preserved.
+        */
         void reset();
+        void collect_statistics(statistics & st) const;
+        void reset_statistics();
     };
 };
 
@@ -0,0 +1,938 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    compiled_expr.cpp
+
+Abstract:
+
+    Evaluation of an expression in many models.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#include <algorithm>
+#include "model/compiled_expr.h"
+#include "ast/rewriter/bv_rewriter_params.hpp"
+
+static uint64_t mask(unsigned bits) {
+    return bits >= 64 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << bits) - 1;
+}
+
+static int64_t to_signed(uint64_t w, unsigned bits) {
+    if (bits >= 64) return static_cast<int64_t>(w);
+    uint64_t sign = static_cast<uint64_t>(1) << (bits - 1);
+    return static_cast<int64_t>((w ^ sign) - sign);
+}
+
+// |x| < bound
+static bool is_small(int64_t x, int64_t bound) {
+    return -bound < x && x < bound;
+}
+
+// integer division and remainder with 0 <= r < |b|, for b != 0
+static void div_mod(int64_t a, int64_t b, int64_t & q, int64_t & r) {
+    r = a % b;
+    if (r < 0)
+        r += b < 0 ? -b : b;
+    q = (a - r) / b;
+}
+
+compiled_expr::compiled_expr(ast_manager & m, expr * e):
+    m(m),
+    m_bv(m),
+    m_arith(m),
+    m_root(e, m),
+    m_pinned(m),
+    m_num_fallbacks(0),
+    m_hi_div0(bv_rewriter_params(params_ref()).hi_div0()) {
+    compile(e);
+}
+
+compiled_expr::kind compiled_expr::get_kind(sort * s) const {
+    if (m.is_bool(s))
+        return K_BOOL;
+    if (m_bv.is_bv_sort(s) && m_bv.get_bv_size(s) <= 64)
+        return K_BV;
+    if (m_arith.is_int(s))
+        return K_INT;
+    return K_OTHER;
+}
+
+bool compiled_expr::to_word(kind k, expr * e, uint64_t & w) const {
+    rational val;
+    unsigned sz;
+    switch (k) {
+    case K_BOOL:
+        if (m.is_true(e)) { w = 1; return true; }
+        if (m.is_false(e)) { w = 0; return true; }
+        return false;
+    case K_BV:
+        if (m_bv.is_numeral(e, val, sz) && val.is_uint64()) {
+            w = val.get_uint64();
+            return true;
+        }
+        return false;
+    case K_INT:
+        if (m_arith.is_numeral(e, val) && val.is_int64()) {
+            w = static_cast<uint64_t>(val.get_int64());
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+
+void compiled_expr::compile(expr * e) {
+    ptr_vector<expr> todo;
+    todo.push_back(e);
+    while (!todo.empty()) {
+        expr * t = todo.back();
+        if (m_expr2instr.contains(t)) {
+            todo.pop_back();
+            continue;
+        }
+        bool visited = true;
+        if (is_ground(t)) {
+            for (expr * arg : *to_app(t)) {
+                if (!m_expr2instr.contains(arg)) {
+                    todo.push_back(arg);
+                    visited = false;
+                }
+            }
+        }
+        if (!visited)
+            continue;
+        todo.pop_back();
+        unsigned i = m_instrs.size();
+        m_expr2instr.insert(t, i);
+        m_instrs.push_back(mk_instr(t));
+        m_values.push_back(value());
+        m_values[i].m_is_word = false;
+        m_values[i].m_expr = nullptr;
+        if (m_instrs[i].m_op == CE_VALUE)
+            set_value(i, t);
+    }
+}
+
+compiled_expr::instr compiled_expr::mk_instr(expr * e) {
+    instr ins;
+    sort * s = m.get_sort(e);
+    ins.m_expr = e;
+    ins.m_kind = get_kind(s);
+    ins.m_bits = ins.m_kind == K_BV ? m_bv.get_bv_size(s) : 0;
+    ins.m_arg_bits = 0;
+    ins.m_low = 0;
+    ins.m_args = m_args.size();
+    ins.m_num_args = 0;
+    if (!is_ground(e)) {
+        // quantifiers and terms with free variables
+        ins.m_op = CE_EVAL;
+        return ins;
+    }
+    app * a = to_app(e);
+    for (expr * arg : *a)
+        m_args.push_back(m_expr2instr[arg]);
+    ins.m_num_args = a->get_num_args();
+    if (ins.m_num_args == 0) {
+        if (a->get_family_id() == null_family_id)
+            ins.m_op = CE_CONST;
+        else if (m.is_value(a))
+            ins.m_op = CE_VALUE;
+        else
+            ins.m_op = CE_EVAL;
+        return ins;
+    }
+    ins.m_op = get_opcode(a, ins);
+    return ins;
+}
+
+compiled_expr::opcode compiled_expr::get_opcode(app * a, instr & ins) const {
+    family_id fid = a->get_family_id();
+    decl_kind k = a->get_decl_kind();
+    unsigned n = ins.m_num_args;
+    instr const & arg0 = m_instrs[m_args[ins.m_args]];
+    if (fid == m.get_basic_family_id()) {
+        switch (k) {
+        case OP_NOT:      return CE_NOT;
+        case OP_AND:      return CE_AND;
+        case OP_OR:       return CE_OR;
+        case OP_XOR:      return CE_XOR;
+        case OP_IMPLIES:  return n == 2 ? CE_IMPLIES : CE_APP;
+        case OP_ITE:      return CE_ITE;
+        case OP_EQ:       return n == 2 ? CE_EQ : CE_APP;
+        case OP_DISTINCT: return CE_DISTINCT;
+        default:          return CE_APP;
+        }
+    }
+    if (fid == m_bv.get_fid()) {
+        if (arg0.m_kind != K_BV || (ins.m_kind != K_BV && ins.m_kind != K_BOOL))
+            return CE_APP;
+        ins.m_arg_bits = arg0.m_bits;
+        switch (k) {
+        case OP_BADD:     return CE_BADD;
+        case OP_BSUB:     return CE_BSUB;
+        case OP_BMUL:     return CE_BMUL;
+        case OP_BNEG:     return CE_BNEG;
+        // division by zero follows the hardware interpretation of the bit-vector rewriter;
+        // without it, bvudiv and bvurem by zero are uninterpreted and left to the evaluator
+        case OP_BUDIV:    return m_hi_div0 ? CE_BUDIV : CE_APP;
+        case OP_BUDIV_I:  return CE_BUDIV;
+        case OP_BUREM:    return m_hi_div0 ? CE_BUREM : CE_APP;
+        case OP_BUREM_I:  return CE_BUREM;
+        case OP_BAND:     return CE_BAND;
+        case OP_BOR:      return CE_BOR;
+        case OP_BXOR:     return CE_BXOR;
+        case OP_BNOT:     return CE_BNOT;
+        case OP_BSHL:     return CE_BSHL;
+        case OP_BLSHR:    return CE_BLSHR;
+        case OP_BASHR:    return CE_BASHR;
+        case OP_ULEQ:     return CE_ULEQ;
+        case OP_ULT:      return CE_ULT;
+        case OP_UGEQ:     return CE_UGEQ;
+        case OP_UGT:      return CE_UGT;
+        case OP_SLEQ:     return CE_SLEQ;
+        case OP_SLT:      return CE_SLT;
+        case OP_SGEQ:     return CE_SGEQ;
+        case OP_SGT:      return CE_SGT;
+        case OP_EXTRACT:
+            ins.m_low = m_bv.get_extract_low(a);
+            return CE_EXTRACT;
+        case OP_CONCAT:   return CE_CONCAT;
+        case OP_ZERO_EXT: return CE_ZERO_EXT;
+        case OP_SIGN_EXT: return CE_SIGN_EXT;
+        default:          return CE_APP;
+        }
+    }
+    if (fid == m_arith.get_family_id()) {
+        if (arg0.m_kind != K_INT || (ins.m_kind != K_INT && ins.m_kind != K_BOOL))
+            return CE_APP;
+        switch (k) {
+        case OP_ADD:      return CE_IADD;
+        case OP_SUB:      return CE_ISUB;
+        case OP_MUL:      return CE_IMUL;
+        case OP_IDIV:     return CE_IDIV;
+        case OP_MOD:      return CE_IMOD;
+        case OP_UMINUS:   return CE_INEG;
+        case OP_LE:       return CE_ILE;
+        case OP_LT:       return CE_ILT;
+        case OP_GE:       return CE_IGE;
+        case OP_GT:       return CE_IGT;
+        default:          return CE_APP;
+        }
+    }
+    return CE_APP;
+}
+
+void compiled_expr::set_value(unsigned i, expr * e) {
+    value & v = m_values[i];
+    v.m_expr = e;
+    v.m_is_word = to_word(m_instrs[i].m_kind, e, v.m_word);
+}
+
+expr * compiled_expr::to_expr(unsigned i) {
+    value & v = m_values[i];
+    if (v.m_expr)
+        return v.m_expr;
+    SASSERT(v.m_is_word);
+    instr const & ins = m_instrs[i];
+    expr * e = mk_value(ins.m_kind, ins.m_bits, v.m_word);
+    m_pinned.push_back(e);
+    v.m_expr = e;
+    return e;
+}
+
+expr * compiled_expr::mk_value(kind k, unsigned bits, uint64_t w) {
+    switch (k) {
+    case K_BOOL:
+        return m.mk_bool_val(w != 0);
+    case K_BV:
+        return m_bv.mk_numeral(rational(w, rational::ui64()), bits);
+    case K_INT:
+        return m_arith.mk_int(rational(static_cast<int64_t>(w), rational::i64()));
+    default:
+        UNREACHABLE();
+        return nullptr;
+    }
+}
+
+bool compiled_expr::args_are_words(instr const & ins) const {
+    for (unsigned j = 0; j < ins.m_num_args; ++j) {
+        if (!arg(ins, j).m_is_word)
+            return false;
+    }
+    return true;
+}
+
+bool compiled_expr::eval_bool(instr const & ins, uint64_t & r) const {
+    unsigned n = ins.m_num_args;
+    switch (ins.m_op) {
+    case CE_AND:
+    case CE_OR: {
+        // a single false (true) argument determines a conjunction (disjunction)
+        uint64_t absorb = ins.m_op == CE_AND ? 0 : 1;
+        bool all_words = true;
+        for (unsigned j = 0; j < n; ++j) {
+            value const & a = arg(ins, j);
+            if (!a.m_is_word)
+                all_words = false;
+            else if (a.m_word == absorb) {
+                r = absorb;
+                return true;
+            }
+        }
+        r = 1 - absorb;
+        return all_words;
+    }
+    default:
+        break;
+    }
+    if (!args_are_words(ins))
+        return false;
+    switch (ins.m_op) {
+    case CE_NOT:
+        r = arg(ins, 0).m_word ^ 1;
+        return true;
+    case CE_XOR:
+        r = 0;
+        for (unsigned j = 0; j < n; ++j)
+            r ^= arg(ins, j).m_word;
+        return true;
+    case CE_IMPLIES:
+        r = (arg(ins, 0).m_word == 0 || arg(ins, 1).m_word != 0) ? 1 : 0;
+        return true;
+    case CE_EQ:
+        r = arg(ins, 0).m_word == arg(ins, 1).m_word ? 1 : 0;
+        return true;
+    case CE_DISTINCT:
+        for (unsigned j = 0; j < n; ++j) {
+            for (unsigned k = j + 1; k < n; ++k) {
+                if (arg(ins, j).m_word == arg(ins, k).m_word) {
+                    r = 0;
+                    return true;
+                }
+            }
+        }
+        r = 1;
+        return true;
+    default:
+        UNREACHABLE();
+        return false;
+    }
+}
+
+bool compiled_expr::eval_bv(instr const & ins, uint64_t & r) const {
+    if (!args_are_words(ins))
+        return false;
+    unsigned n = ins.m_num_args;
+    unsigned bits = ins.m_arg_bits;
+    uint64_t msk = mask(ins.m_bits);
+    uint64_t a = arg(ins, 0).m_word;
+    uint64_t b = n > 1 ? arg(ins, 1).m_word : 0;
+    switch (ins.m_op) {
+    case CE_BADD:
+        r = a;
+        for (unsigned j = 1; j < n; ++j)
+            r += arg(ins, j).m_word;
+        r &= msk;
+        return true;
+    case CE_BSUB:
+        r = (a - b) & msk;
+        return true;
+    case CE_BMUL:
+        r = a;
+        for (unsigned j = 1; j < n; ++j)
+            r *= arg(ins, j).m_word;
+        r &= msk;
+        return true;
+    case CE_BNEG:
+        r = (0 - a) & msk;
+        return true;
+    case CE_BUDIV:
+        r = b == 0 ? msk : a / b;
+        return true;
+    case CE_BUREM:
+        r = b == 0 ? a : a % b;
+        return true;
+    case CE_BAND:
+        r = a;
+        for (unsigned j = 1; j < n; ++j)
+            r &= arg(ins, j).m_word;
+        return true;
+    case CE_BOR:
+        r = a;
+        for (unsigned j = 1; j < n; ++j)
+            r |= arg(ins, j).m_word;
+        return true;
+    case CE_BXOR:
+        r = a;
+        for (unsigned j = 1; j < n; ++j)
+            r ^= arg(ins, j).m_word;
+        return true;
+    case CE_BNOT:
+        r = ~a & msk;
+        return true;
+    case CE_BSHL:
+        r = b >= bits ? 0 : (a << b) & msk;
+        return true;
+    case CE_BLSHR:
+        r = b >= bits ? 0 : a >> b;
+        return true;
+    case CE_BASHR: {
+        int64_t s = to_signed(a, bits);
+        if (b >= bits)
+            r = s < 0 ? msk : 0;
+        else
+            r = static_cast<uint64_t>(s >> b) & msk;
+        return true;
+    }
+    case CE_ULEQ: r = a <= b; return true;
+    case CE_ULT:  r = a < b;  return true;
+    case CE_UGEQ: r = a >= b; return true;
+    case CE_UGT:  r = a > b;  return true;
+    case CE_SLEQ: r = to_signed(a, bits) <= to_signed(b, bits); return true;
+    case CE_SLT:  r = to_signed(a, bits) <  to_signed(b, bits); return true;
+    case CE_SGEQ: r = to_signed(a, bits) >= to_signed(b, bits); return true;
+    case CE_SGT:  r = to_signed(a, bits) >  to_signed(b, bits); return true;
+    case CE_EXTRACT:
+        r = (a >> ins.m_low) & msk;
+        return true;
+    case CE_CONCAT:
+        r = 0;
+        for (unsigned j = 0; j < n; ++j)
+            r = (r << m_instrs[m_args[ins.m_args + j]].m_bits) | arg(ins, j).m_word;
+        return true;
+    case CE_ZERO_EXT:
+        r = a;
+        return true;
+    case CE_SIGN_EXT:
+        r = static_cast<uint64_t>(to_signed(a, bits)) & msk;
+        return true;
+    default:
+        UNREACHABLE();
+        return false;
+    }
+}
+
+bool compiled_expr::eval_int(instr const & ins, uint64_t & r) const {
+    if (!args_are_words(ins))
+        return false;
+    // bounds under which the operations cannot overflow;
+    // larger integers are left to the evaluator.
+    const int64_t add_bound = static_cast<int64_t>(1) << 62;
+    const int64_t mul_bound = static_cast<int64_t>(1) << 31;
+    unsigned n = ins.m_num_args;
+    int64_t a = static_cast<int64_t>(arg(ins, 0).m_word);
+    int64_t b = n > 1 ? static_cast<int64_t>(arg(ins, 1).m_word) : 0;
+    int64_t s;
+    switch (ins.m_op) {
+    case CE_IADD:
+    case CE_ISUB:
+        s = a;
+        for (unsigned j = 1; j < n; ++j) {
+            int64_t c = static_cast<int64_t>(arg(ins, j).m_word);
+            if (!is_small(s, add_bound) || !is_small(c, add_bound))
+                return false;
+            s = ins.m_op == CE_IADD ? s + c : s - c;
+        }
+        break;
+    case CE_IMUL:
+        s = a;
+        for (unsigned j = 1; j < n; ++j) {
+            int64_t c = static_cast<int64_t>(arg(ins, j).m_word);
+            if (!is_small(s, mul_bound) || !is_small(c, mul_bound))
+                return false;
+            s *= c;
+        }
+        break;
+    case CE_IDIV:
+    case CE_IMOD: {
+        // division by 0 is left to the evaluator
+        if (b == 0 || !is_small(a, add_bound) || !is_small(b, add_bound))
+            return false;
+        int64_t q, rem;
+        div_mod(a, b, q, rem);
+        s = ins.m_op == CE_IDIV ? q : rem;
+        break;
+    }
+    case CE_INEG:
+        if (!is_small(a, add_bound))
+            return false;
+        s = -a;
+        break;
+    case CE_ILE: s = a <= b; break;
+    case CE_ILT: s = a < b;  break;
+    case CE_IGE: s = a >= b; break;
+    case CE_IGT: s = a > b;  break;
+    default:
+        UNREACHABLE();
+        return false;
+    }
+    r = static_cast<uint64_t>(s);
+    return true;
+}
+
+bool compiled_expr::eval_word(instr const & ins, uint64_t & r) const {
+    if (ins.m_op <= CE_DISTINCT)
+        return eval_bool(ins, r);
+    if (ins.m_op <= CE_SIGN_EXT)
+        return eval_bv(ins, r);
+    return eval_int(ins, r);
+}
+
+void compiled_expr::eval_app(unsigned i, model & mdl) {
+    instr const & ins = m_instrs[i];
+    ptr_buffer<expr> args;
+    for (unsigned j = 0; j < ins.m_num_args; ++j)
+        args.push_back(to_expr(m_args[ins.m_args + j]));
+    expr_ref r(m.mk_app(to_app(ins.m_expr)->get_decl(), args.size(), args.c_ptr()), m);
+    r = mdl(r);
+    m_pinned.push_back(r);
+    ++m_num_fallbacks;
+    set_value(i, r);
+}
+
+expr_ref compiled_expr::operator()(model & mdl, bool model_completion) {
+    model::scoped_model_completion _scm(mdl, model_completion);
+    m_pinned.reset();
+    for (unsigned i = 0; i < m_instrs.size(); ++i) {
+        instr const & ins = m_instrs[i];
+        value & v = m_values[i];
+        switch (ins.m_op) {
+        case CE_VALUE:
+            break;
+        case CE_CONST: {
+            expr * e = mdl.get_const_interp(to_app(ins.m_expr)->get_decl());
+            if (e && m.is_value(e)) {
+                set_value(i, e);
+                break;
+            }
+            // unassigned constants are completed (or left alone) by the evaluator
+            expr_ref r = mdl(ins.m_expr);
+            m_pinned.push_back(r);
+            ++m_num_fallbacks;
+            set_value(i, r);
+            break;
+        }
+        case CE_EVAL: {
+            expr_ref r = mdl(ins.m_expr);
+            m_pinned.push_back(r);
+            ++m_num_fallbacks;
+            set_value(i, r);
+            break;
+        }
+        case CE_APP:
+            eval_app(i, mdl);
+            break;
+        case CE_ITE: {
+            value const & c = arg(ins, 0);
+            if (c.m_is_word)
+                v = arg(ins, c.m_word ? 1 : 2);
+            else
+                eval_app(i, mdl);
+            break;
+        }
+        default: {
+            uint64_t r;
+            if (eval_word(ins, r)) {
+                v.m_is_word = true;
+                v.m_word = r;
+                v.m_expr = nullptr;
+            }
+            else {
+                eval_app(i, mdl);
+            }
+            break;
+        }
+        }
+    }
+    return expr_ref(to_expr(m_instrs.size() - 1), m);
+}
+
+template<typename F>
+static void map1(unsigned n, uint64_t * r, uint64_t const * a, F f) {
+    for (unsigned k = 0; k < n; ++k)
+        r[k] = f(a[k]);
+}
+
+template<typename F>
+static void map2(unsigned n, uint64_t * r, uint64_t const * a, uint64_t const * b, F f) {
+    for (unsigned k = 0; k < n; ++k)
+        r[k] = f(a[k], b[k]);
+}
+
+template<typename F>
+static void fold(unsigned n, uint64_t * r, unsigned num_args, uint64_t const * const * args, F f) {
+    std::copy(args[0], args[0] + n, r);
+    for (unsigned j = 1; j < num_args; ++j)
+        map2(n, r, r, args[j], f);
+}
+
+void compiled_expr::eval_block_bool(unsigned i, unsigned n, uint64_t const * const * args) {
+    instr const & ins = m_instrs[i];
+    uint64_t * r = column(i);
+    unsigned num_args = ins.m_num_args;
+    switch (ins.m_op) {
+    case CE_NOT:
+        map1(n, r, args[0], [](uint64_t x) { return x ^ 1; });
+        break;
+    case CE_AND:
+        fold(n, r, num_args, args, [](uint64_t x, uint64_t y) { return x & y; });
+        break;
+    case CE_OR:
+        fold(n, r, num_args, args, [](uint64_t x, uint64_t y) { return x | y; });
+        break;
+    case CE_XOR:
+        fold(n, r, num_args, args, [](uint64_t x, uint64_t y) { return x ^ y; });
+        break;
+    case CE_IMPLIES:
+        map2(n, r, args[0], args[1], [](uint64_t x, uint64_t y) { return (x ^ 1) | y; });
+        break;
+    case CE_ITE: {
+        uint64_t const * c = args[0], * t = args[1], * e = args[2];
+        for (unsigned k = 0; k < n; ++k)
+            r[k] = c[k] ? t[k] : e[k];
+        break;
+    }
+    case CE_EQ:
+        map2(n, r, args[0], args[1], [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(x == y); });
+        break;
+    case CE_DISTINCT:
+        std::fill(r, r + n, 1);
+        for (unsigned j = 0; j < num_args; ++j) {
+            for (unsigned l = j + 1; l < num_args; ++l) {
+                uint64_t const * a = args[j], * b = args[l];
+                for (unsigned k = 0; k < n; ++k)
+                    r[k] &= static_cast<uint64_t>(a[k] != b[k]);
+            }
+        }
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+void compiled_expr::eval_block_bv(unsigned i, unsigned n, uint64_t const * const * args) {
+    instr const & ins = m_instrs[i];
+    uint64_t * r = column(i);
+    unsigned num_args = ins.m_num_args;
+    unsigned bits = ins.m_arg_bits;
+    uint64_t msk = mask(ins.m_bits);
+    uint64_t const * a = args[0];
+    uint64_t const * b = num_args > 1 ? args[1] : nullptr;
+    switch (ins.m_op) {
+    case CE_BADD:
+        fold(n, r, num_args, args, [](uint64_t x, uint64_t y) { return x + y; });
+        map1(n, r, r, [msk](uint64_t x) { return x & msk; });
+        break;
+    case CE_BSUB:
+        map2(n, r, a, b, [msk](uint64_t x, uint64_t y) { return (x - y) & msk; });
+        break;
+    case CE_BMUL:
+        fold(n, r, num_args, args, [](uint64_t x, uint64_t y) { return x * y; });
+        map1(n, r, r, [msk](uint64_t x) { return x & msk; });
+        break;
+    case CE_BNEG:
+        map1(n, r, a, [msk](uint64_t x) { return (0 - x) & msk; });
+        break;
+    case CE_BUDIV:
+        map2(n, r, a, b, [msk](uint64_t x, uint64_t y) { return y == 0 ? msk : x / y; });
+        break;
+    case CE_BUREM:
+        map2(n, r, a, b, [](uint64_t x, uint64_t y) { return y == 0 ? x : x % y; });
+        break;
+    case CE_BAND:
+        fold(n, r, num_args, args, [](uint64_t x, uint64_t y) { return x & y; });
+        break;
+    case CE_BOR:
+        fold(n, r, num_args, args, [](uint64_t x, uint64_t y) { return x | y; });
+        break;
+    case CE_BXOR:
+        fold(n, r, num_args, args, [](uint64_t x, uint64_t y) { return x ^ y; });
+        break;
+    case CE_BNOT:
+        map1(n, r, a, [msk](uint64_t x) { return ~x & msk; });
+        break;
+    // shift amounts are masked so that the shifts are defined for every lane
+    case CE_BSHL:
+        map2(n, r, a, b, [bits, msk](uint64_t x, uint64_t y) { return y >= bits ? 0 : (x << (y & 63)) & msk; });
+        break;
+    case CE_BLSHR:
+        map2(n, r, a, b, [bits](uint64_t x, uint64_t y) { return y >= bits ? 0 : x >> (y & 63); });
+        break;
+    case CE_BASHR:
+        map2(n, r, a, b, [bits, msk](uint64_t x, uint64_t y) {
+                int64_t s = to_signed(x, bits);
+                uint64_t fill = s < 0 ? msk : 0;
+                return y >= bits ? fill : static_cast<uint64_t>(s >> (y & 63)) & msk;
+            });
+        break;
+    case CE_ULEQ:
+        map2(n, r, a, b, [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(x <= y); });
+        break;
+    case CE_ULT:
+        map2(n, r, a, b, [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(x < y); });
+        break;
+    case CE_UGEQ:
+        map2(n, r, a, b, [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(x >= y); });
+        break;
+    case CE_UGT:
+        map2(n, r, a, b, [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(x > y); });
+        break;
+    case CE_SLEQ:
+        map2(n, r, a, b, [bits](uint64_t x, uint64_t y) { return static_cast<uint64_t>(to_signed(x, bits) <= to_signed(y, bits)); });
+        break;
+    case CE_SLT:
+        map2(n, r, a, b, [bits](uint64_t x, uint64_t y) { return static_cast<uint64_t>(to_signed(x, bits) < to_signed(y, bits)); });
+        break;
+    case CE_SGEQ:
+        map2(n, r, a, b, [bits](uint64_t x, uint64_t y) { return static_cast<uint64_t>(to_signed(x, bits) >= to_signed(y, bits)); });
+        break;
+    case CE_SGT:
+        map2(n, r, a, b, [bits](uint64_t x, uint64_t y) { return static_cast<uint64_t>(to_signed(x, bits) > to_signed(y, bits)); });
+        break;
+    case CE_EXTRACT: {
+        unsigned low = ins.m_low;
+        map1(n, r, a, [low, msk](uint64_t x) { return (x >> low) & msk; });
+        break;
+    }
+    case CE_CONCAT:
+        std::fill(r, r + n, 0);
+        for (unsigned j = 0; j < num_args; ++j) {
+            unsigned w = m_instrs[m_args[ins.m_args + j]].m_bits;
+            map2(n, r, r, args[j], [w](uint64_t x, uint64_t y) { return (x << w) | y; });
+        }
+        break;
+    case CE_ZERO_EXT:
+        std::copy(a, a + n, r);
+        break;
+    case CE_SIGN_EXT:
+        map1(n, r, a, [bits, msk](uint64_t x) { return static_cast<uint64_t>(to_signed(x, bits)) & msk; });
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+void compiled_expr::eval_block_int(unsigned i, unsigned n, uint64_t const * const * args) {
+    instr const & ins = m_instrs[i];
+    uint64_t * r = column(i);
+    unsigned num_args = ins.m_num_args;
+    const int64_t add_bound = static_cast<int64_t>(1) << 62;
+    const int64_t mul_bound = static_cast<int64_t>(1) << 31;
+    switch (ins.m_op) {
+    case CE_IADD:
+    case CE_ISUB:
+    case CE_IMUL: {
+        int64_t bound = ins.m_op == CE_IMUL ? mul_bound : add_bound;
+        std::copy(args[0], args[0] + n, r);
+        for (unsigned j = 1; j < num_args; ++j) {
+            uint64_t const * b = args[j];
+            for (unsigned k = 0; k < n; ++k) {
+                int64_t x = static_cast<int64_t>(r[k]), y = static_cast<int64_t>(b[k]);
+                if (!is_small(x, bound) || !is_small(y, bound)) {
+                    m_slow[k] = true;
+                    r[k] = 0;
+                    continue;
+                }
+                int64_t z = ins.m_op == CE_IADD ? x + y : (ins.m_op == CE_ISUB ? x - y : x * y);
+                r[k] = static_cast<uint64_t>(z);
+            }
+        }
+        break;
+    }
+    case CE_IDIV:
+    case CE_IMOD:
+        for (unsigned k = 0; k < n; ++k) {
+            int64_t x = static_cast<int64_t>(args[0][k]), y = static_cast<int64_t>(args[1][k]);
+            int64_t q, rem;
+            if (y == 0 || !is_small(x, add_bound) || !is_small(y, add_bound)) {
+                m_slow[k] = true;
+                r[k] = 0;
+                continue;
+            }
+            div_mod(x, y, q, rem);
+            r[k] = static_cast<uint64_t>(ins.m_op == CE_IDIV ? q : rem);
+        }
+        break;
+    case CE_INEG:
+        for (unsigned k = 0; k < n; ++k) {
+            int64_t x = static_cast<int64_t>(args[0][k]);
+            if (!is_small(x, add_bound)) {
+                m_slow[k] = true;
+                x = 0;
+            }
+            r[k] = static_cast<uint64_t>(-x);
+        }
+        break;
+    case CE_ILE:
+        map2(n, r, args[0], args[1], [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(static_cast<int64_t>(x) <= static_cast<int64_t>(y)); });
+        break;
+    case CE_ILT:
+        map2(n, r, args[0], args[1], [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(static_cast<int64_t>(x) < static_cast<int64_t>(y)); });
+        break;
+    case CE_IGE:
+        map2(n, r, args[0], args[1], [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(static_cast<int64_t>(x) >= static_cast<int64_t>(y)); });
+        break;
+    case CE_IGT:
+        map2(n, r, args[0], args[1], [](uint64_t x, uint64_t y) { return static_cast<uint64_t>(static_cast<int64_t>(x) > static_cast<int64_t>(y)); });
+        break;
+    default:
+        UNREACHABLE();
+    }
+}
+
+void compiled_expr::eval_block_app(unsigned i, unsigned n, model & mdl, uint64_t const * const * args) {
+    instr const & ins = m_instrs[i];
+    uint64_t * r = column(i);
+    func_decl * f = to_app(ins.m_expr)->get_decl();
+    expr_ref_vector vals(m);
+    expr_ref e(m);
+    for (unsigned k = 0; k < n; ++k) {
+        r[k] = 0;
+        if (m_slow[k])
+            continue;
+        vals.reset();
+        for (unsigned j = 0; j < ins.m_num_args; ++j) {
+            instr const & arg = m_instrs[m_args[ins.m_args + j]];
+            vals.push_back(mk_value(arg.m_kind, arg.m_bits, args[j][k]));
+        }
+        // the arguments are values, so the result does not depend on the assignment
+        e = m.mk_app(f, vals.size(), vals.c_ptr());
+        e = mdl(e);
+        ++m_num_fallbacks;
+        if (!to_word(ins.m_kind, e, r[k]))
+            m_slow[k] = true;
+    }
+}
+
+void compiled_expr::eval_block(unsigned i, unsigned n, model & mdl) {
+    instr const & ins = m_instrs[i];
+    ptr_buffer<uint64_t const> args;
+    for (unsigned j = 0; j < ins.m_num_args; ++j)
+        args.push_back(column(m_args[ins.m_args + j]));
+    if (ins.m_op == CE_APP)
+        eval_block_app(i, n, mdl, args.c_ptr());
+    else if (ins.m_op <= CE_DISTINCT)
+        eval_block_bool(i, n, args.c_ptr());
+    else if (ins.m_op <= CE_SIGN_EXT)
+        eval_block_bv(i, n, args.c_ptr());
+    else
+        eval_block_int(i, n, args.c_ptr());
+}
+
+/**
+   \brief Fill the columns of the instructions whose values are the same for all assignments.
+   Return false if the value of some instruction is not a word.
+*/
+bool compiled_expr::init_block(model & mdl, unsigned num_consts, func_decl * const * consts, unsigned_vector & const2column) {
+    obj_map<func_decl, unsigned> decl2column;
+    for (unsigned j = 0; j < num_consts; ++j)
+        decl2column.insert(consts[j], j);
+    m_block.reset();
+    m_block.resize(m_instrs.size() * batch_size, 0);
+    const2column.reset();
+    const2column.resize(m_instrs.size(), UINT_MAX);
+    model::scoped_model_completion _scm(mdl, true);
+    for (unsigned i = 0; i < m_instrs.size(); ++i) {
+        instr const & ins = m_instrs[i];
+        switch (ins.m_op) {
+        case CE_VALUE:
+            break;
+        case CE_CONST: {
+            func_decl * d = to_app(ins.m_expr)->get_decl();
+            unsigned j;
+            if (decl2column.find(d, j)) {
+                const2column[i] = j;
+                continue;
+            }
+            expr * e = mdl.get_const_interp(d);
+            if (!e || !m.is_value(e)) {
+                expr_ref r = mdl(ins.m_expr);
+                m_pinned.push_back(r);
+                e = r;
+            }
+            set_value(i, e);
+            break;
+        }
+        case CE_EVAL:
+            return false;
+        default:
+            if (ins.m_kind == K_OTHER)
+                return false;
+            continue;
+        }
+        if (!m_values[i].m_is_word)
+            return false;
+        std::fill(column(i), column(i) + batch_size, m_values[i].m_word);
+    }
+    return true;
+}
+
+bool compiled_expr::operator()(model & mdl, unsigned num_consts, func_decl * const * consts,
+                               unsigned num_rows, uint64_t const * const * columns, uint64_t * results) {
+    instr const & root = m_instrs.back();
+    if (root.m_kind == K_OTHER)
+        return false;
+    m_pinned.reset();
+    unsigned_vector const2column;
+    bool use_block = init_block(mdl, num_consts, consts, const2column);
+    model::scoped_model_completion _scm(mdl, true);
+    model_ref row_mdl;
+    for (unsigned row = 0; row < num_rows; row += batch_size) {
+        unsigned n = num_rows - row < batch_size ? num_rows - row : batch_size;
+        m_slow.reset();
+        m_slow.resize(n, !use_block);
+        if (use_block) {
+            for (unsigned i = 0; i < m_instrs.size(); ++i) {
+                instr const & ins = m_instrs[i];
+                unsigned j = const2column[i];
+                if (j != UINT_MAX) {
+                    uint64_t const * src = columns[j] + row;
+                    uint64_t * dst = column(i);
+                    if (ins.m_kind == K_BOOL)
+                        map1(n, dst, src, [](uint64_t x) { return static_cast<uint64_t>(x != 0); });
+                    else if (ins.m_kind == K_BV) {
+                        uint64_t msk = mask(ins.m_bits);
+                        map1(n, dst, src, [msk](uint64_t x) { return x & msk; });
+                    }
+                    else
+                        std::copy(src, src + n, dst);
+                }
+                else if (ins.m_op != CE_VALUE && ins.m_op != CE_CONST) {
+                    eval_block(i, n, mdl);
+                }
+            }
+            uint64_t const * r = column(m_instrs.size() - 1);
+            std::copy(r, r + n, results + row);
+        }
+        // assignments without a word result for some operation are evaluated in a model of their own
+        for (unsigned k = 0; k < n; ++k) {
+            if (!m_slow[k])
+                continue;
+            if (!row_mdl)
+                row_mdl = mdl.copy();
+            for (unsigned j = 0; j < num_consts; ++j) {
+                sort * s = consts[j]->get_range();
+                kind kd = get_kind(s);
+                SASSERT(kd != K_OTHER);
+                unsigned bits = kd == K_BV ? m_bv.get_bv_size(s) : 0;
+                uint64_t w = columns[j][row + k];
+                if (kd == K_BV)
+                    w &= mask(bits);
+                row_mdl->register_decl(consts[j], mk_value(kd, bits, w));
+            }
+            row_mdl->reset_eval_cache();
+            expr_ref v = (*this)(*row_mdl, true);
+            if (!to_word(root.m_kind, v, results[row + k]))
+                return false;
+        }
+    }
+    return true;
+}
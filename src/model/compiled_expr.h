@@ -0,0 +1,167 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    compiled_expr.h
+
+Abstract:
+
+    Evaluation of an expression in many models.
+
+    The model evaluator rewrites the expression from scratch every time
+    it is evaluated. A compiled_expr translates the expression once into
+    a flat sequence of instructions, one per subterm, in topological
+    order. Evaluating the expression in a model runs the instructions
+    in sequence over a vector of values.
+
+    Booleans, bit-vectors of at most 64 bits and integers that fit in a
+    machine word are represented as machine words, and the common
+    Boolean, bit-vector and integer operations are executed directly on
+    the words. Everything else (uninterpreted functions, arrays, reals,
+    integer division by zero, integer overflow, quantifiers, ...) falls
+    back to the model evaluator for the subterm, with the values of the
+    arguments already computed. Bit-vector division by zero uses the
+    hardware interpretation of the rewriter (bvudiv by 0 is all ones,
+    bvurem by 0 is the dividend) when rewriter.hi_div0 is set, and is
+    left to the evaluator otherwise.
+
+    A batch of assignments to a set of constants, given as one column
+    of words per constant, is evaluated block by block: every
+    instruction computes the values of a block of assignments with a
+    loop over the argument columns that the compiler turns into vector
+    instructions. Other applications over words are passed to the model
+    evaluator one assignment at a time. Assignments for which an
+    operation has no word result (integer division by zero, overflow)
+    are evaluated in a model of their own, and so are all assignments
+    of expressions with subterms that are not words.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#ifndef COMPILED_EXPR_H_
+#define COMPILED_EXPR_H_
+
+#include "ast/ast.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/arith_decl_plugin.h"
+#include "util/obj_hashtable.h"
+#include "model/model.h"
+
+class compiled_expr {
+public:
+    enum opcode {
+        CE_VALUE,      // interpreted value, computed when the expression is compiled
+        CE_CONST,      // uninterpreted constant, retrieved from the model
+        CE_EVAL,       // subterm that is evaluated as a whole by the model evaluator
+        CE_APP,        // application that is evaluated by the model evaluator over the values of the arguments
+        CE_NOT, CE_AND, CE_OR, CE_XOR, CE_IMPLIES, CE_ITE, CE_EQ, CE_DISTINCT,
+        CE_BADD, CE_BSUB, CE_BMUL, CE_BNEG, CE_BUDIV, CE_BUREM,
+        CE_BAND, CE_BOR, CE_BXOR, CE_BNOT, CE_BSHL, CE_BLSHR, CE_BASHR,
+        CE_ULEQ, CE_ULT, CE_UGEQ, CE_UGT, CE_SLEQ, CE_SLT, CE_SGEQ, CE_SGT,
+        CE_EXTRACT, CE_CONCAT, CE_ZERO_EXT, CE_SIGN_EXT,
+        CE_IADD, CE_ISUB, CE_IMUL, CE_IDIV, CE_IMOD, CE_INEG, CE_ILE, CE_ILT, CE_IGE, CE_IGT
+    };
+
+    enum kind {
+        K_BOOL,    // 0 or 1
+        K_BV,      // bit-vector of at most 64 bits, zero-extended to 64 bits
+        K_INT,     // integer in two's complement
+        K_OTHER    // always represented as an expression
+    };
+
+    struct instr {
+        opcode   m_op;
+        kind     m_kind;       // kind of the result
+        unsigned m_bits;       // width of bit-vector results
+        unsigned m_arg_bits;   // width of the first argument of bit-vector operations
+        unsigned m_low;        // low bit of extract
+        unsigned m_args;       // position of the arguments in m_args
+        unsigned m_num_args;
+        expr *   m_expr;
+    };
+
+private:
+    struct value {
+        bool     m_is_word;
+        uint64_t m_word;
+        expr *   m_expr;   // expression of the value, if it was already created
+    };
+
+    ast_manager &        m;
+    bv_util              m_bv;
+    arith_util           m_arith;
+    expr_ref             m_root;
+    svector<instr>       m_instrs;
+    unsigned_vector      m_args;
+    obj_map<expr, unsigned> m_expr2instr;
+    svector<value>       m_values;
+    expr_ref_vector      m_pinned;
+    unsigned             m_num_fallbacks;
+    bool                 m_hi_div0;
+
+    static const unsigned batch_size = 128;
+    svector<uint64_t>    m_block;    // values of a block of assignments, batch_size per instruction
+    svector<bool>        m_slow;     // assignments of the block that are evaluated one at a time
+
+    void compile(expr * e);
+    instr mk_instr(expr * e);
+    opcode get_opcode(app * a, instr & ins) const;
+    kind get_kind(sort * s) const;
+    bool to_word(kind k, expr * e, uint64_t & w) const;
+    void set_value(unsigned i, expr * e);
+    expr * to_expr(unsigned i);
+    expr * mk_value(kind k, unsigned bits, uint64_t w);
+    value const & arg(instr const & ins, unsigned j) const { return m_values[m_args[ins.m_args + j]]; }
+    bool args_are_words(instr const & ins) const;
+    bool eval_word(instr const & ins, uint64_t & r) const;
+    bool eval_bool(instr const & ins, uint64_t & r) const;
+    bool eval_bv(instr const & ins, uint64_t & r) const;
+    bool eval_int(instr const & ins, uint64_t & r) const;
+    void eval_app(unsigned i, model & mdl);
+    uint64_t * column(unsigned i) { return m_block.c_ptr() + i * batch_size; }
+    bool init_block(model & mdl, unsigned num_consts, func_decl * const * consts, unsigned_vector & const2column);
+    void eval_block(unsigned i, unsigned n, model & mdl);
+    void eval_block_app(unsigned i, unsigned n, model & mdl, uint64_t const * const * args);
+    void eval_block_bool(unsigned i, unsigned n, uint64_t const * const * args);
+    void eval_block_bv(unsigned i, unsigned n, uint64_t const * const * args);
+    void eval_block_int(unsigned i, unsigned n, uint64_t const * const * args);
+
+public:
+    compiled_expr(ast_manager & m, expr * e);
+
+    /**
+       \brief Evaluate the expression in \c mdl.
+       The result is the same as the result of mdl(e) with the given model completion mode,
+       up to the normal form of terms that are not values.
+    */
+    expr_ref operator()(model & mdl, bool model_completion);
+
+    /**
+       \brief Evaluate the expression for a batch of \c num_rows assignments.
+       In assignment \c k the constant \c consts[j] takes the value \c columns[j][k].
+       The remaining constants are evaluated in \c mdl with model completion.
+       Booleans are 0 or 1, bit-vectors are unsigned and integers are in two's complement.
+       The value of the expression under assignment \c k is stored in \c results[k].
+
+       \pre the constants are Booleans, bit-vectors of at most 64 bits or integers.
+
+       Return false if the expression is not a Boolean, a bit-vector of at most 64 bits
+       or an integer, or if one of its values does not fit in a machine word.
+    */
+    bool operator()(model & mdl, unsigned num_consts, func_decl * const * consts,
+                    unsigned num_rows, uint64_t const * const * columns, uint64_t * results);
+
+    unsigned num_instrs() const { return m_instrs.size(); }
+
+    /**
+       \brief Number of subterms that were evaluated by the model evaluator since the expression was compiled.
+    */
+    unsigned num_fallbacks() const { return m_num_fallbacks; }
+};
+
+#endif
@@ -20,6 +20,7 @@ Revision History:
 #include "ast/ast_pp.h"
 #include "ast/ast_smt2_pp.h"
 #include "ast/ast_util.h"
+#include "ast/arith_decl_plugin.h"
 #include "model/func_interp.h"
 
 func_entry::func_entry(ast_manager & m, unsigned arity, expr * const * args, expr * result):
@@ -74,7 +75,9 @@ func_interp::func_interp(ast_manager & m, unsigned arity):
     m_arity(arity),
     m_else(nullptr),
     m_args_are_values(true),
-    m_interp(nullptr) {
+    m_interp(nullptr),
+    m_arith_fid(m.mk_family_id("arith")),
+    m_has_algebraic(false) {
 }
 
 func_interp::~func_interp() {
@@ -171,6 +174,11 @@ bool func_interp::is_constant() const {
    args_are_values to true if for all entries e e.args_are_values() is true.
 */
 func_entry * func_interp::get_entry(expr * const * args) const {
+    if (m_entries.size() >= index_threshold && !m_has_algebraic && !has_algebraic(args)) {
+        if (m_index.empty())
+            build_index();
+        return find_indexed(args);
+    }
     for (func_entry* curr : m_entries) {
         if (curr->eq_args(m(), m_arity, args))
             return curr;
@@ -178,6 +186,52 @@ func_entry * func_interp::get_entry(expr * const * args) const {
     return nullptr;
 }
 
+bool func_interp::has_algebraic(expr * const * args) const {
+    for (unsigned i = 0; i < m_arity; i++) {
+        if (is_app_of(args[i], m_arith_fid, OP_IRRATIONAL_ALGEBRAIC_NUM))
+            return true;
+    }
+    return false;
+}
+
+unsigned func_interp::hash_args(expr * const * args) const {
+    unsigned h = m_arity;
+    for (unsigned i = 0; i < m_arity; i++)
+        h = combine_hash(h, hash_u(args[i]->get_id()));
+    return h;
+}
+
+void func_interp::build_index() const {
+    unsigned capacity = 2 * index_threshold;
+    while (capacity < 2 * m_entries.size())
+        capacity *= 2;
+    m_index.reset();
+    m_index.resize(capacity, 0);
+    for (unsigned i = 0; i < m_entries.size(); i++)
+        index_insert(i);
+}
+
+void func_interp::index_insert(unsigned idx) const {
+    unsigned mask = m_index.size() - 1;
+    unsigned i = hash_args(m_entries[idx]->get_args()) & mask;
+    while (m_index[i] != 0)
+        i = (i + 1) & mask;
+    m_index[i] = idx + 1;
+}
+
+func_entry * func_interp::find_indexed(expr * const * args) const {
+    unsigned mask = m_index.size() - 1;
+    for (unsigned i = hash_args(args) & mask; m_index[i] != 0; i = (i + 1) & mask) {
+        func_entry * curr = m_entries[m_index[i] - 1];
+        unsigned j = 0;
+        for (; j < m_arity && curr->get_arg(j) == args[j]; j++)
+            ;
+        if (j == m_arity)
+            return curr;
+    }
+    return nullptr;
+}
+
 void func_interp::insert_entry(expr * const * args, expr * r) {
     reset_interp_cache();
     func_entry * entry = get_entry(args);
@@ -208,6 +262,16 @@ void func_interp::insert_new_entry(expr * const * args, expr * r) {
     if (!new_entry->args_are_values())
         m_args_are_values = false;
     m_entries.push_back(new_entry);
+    if (has_algebraic(args)) {
+        m_has_algebraic = true;
+        m_index.reset();
+    }
+    else if (!m_index.empty()) {
+        if (2 * m_entries.size() > m_index.size())
+            build_index();
+        else
+            index_insert(m_entries.size() - 1);
+    }
 }
 
 bool func_interp::eval_else(expr * const * args, expr_ref & result) const {
@@ -265,6 +329,7 @@ void func_interp::compress() {
     if (j < m_entries.size()) {
         reset_interp_cache();
         m_entries.shrink(j);
+        m_index.reset();
     }
     // other compression, if else is a default branch.
     // or function encode identity.
@@ -274,6 +339,7 @@ void func_interp::compress() {
             curr->deallocate(m_manager, m_arity);
         }
         m_entries.reset();
+        m_index.reset();
         reset_interp_cache();
         m_manager.inc_ref(new_else);
         m_manager.dec_ref(m_else);
@@ -284,6 +350,7 @@ void func_interp::compress() {
             curr->deallocate(m_manager, m_arity);
         }
         m_entries.reset();
+        m_index.reset();
         reset_interp_cache();
         expr_ref new_else(m_manager.mk_var(0, m_manager.get_sort(m_else)), m_manager);
         m_manager.inc_ref(new_else);
@@ -73,10 +73,27 @@ class func_interp {
 
     expr *                 m_interp; //!< cache for representing the whole interpretation as a single expression (it uses ite terms).
 
+    /**
+       Large function graphs are indexed by a hash table from argument tuples to entries.
+       The index is built by get_entry once the number of entries reaches index_threshold.
+       It uses pointer equality, so it is not used when arguments can be equal without being
+       the same term (irrational algebraic numbers).
+    */
+    static const unsigned   index_threshold = 32;
+    family_id               m_arith_fid;
+    bool                    m_has_algebraic; //!< true if some entry has an irrational algebraic argument
+    mutable unsigned_vector m_index;         //!< open addressing table of positions in m_entries plus one, 0 is an empty slot
+
     void reset_interp_cache();
 
     expr * get_interp_core() const;
 
+    bool has_algebraic(expr * const * args) const;
+    unsigned hash_args(expr * const * args) const;
+    void build_index() const;
+    void index_insert(unsigned idx) const;
+    func_entry * find_indexed(expr * const * args) const;
+
 public:
     func_interp(ast_manager & m, unsigned arity);
     ~func_interp();
@@ -92,15 +92,15 @@ struct evaluator_cfg : public default_rewriter_cfg {
         m_array_as_stores  = p.array_as_stores();
     }
 
-    bool evaluate(func_decl * f, unsigned num, expr * const * args, expr_ref & result) {
+    br_status evaluate(func_decl * f, unsigned num, expr * const * args, expr_ref & result) {
         func_interp * fi = m_model.get_func_interp(f);
-        return (fi != nullptr) && eval_fi(fi, num, args, result);
+        return fi != nullptr ? eval_fi(fi, num, args, result) : BR_FAILED;
     }
 
     // Try to use the entries to quickly evaluate the fi
-    bool eval_fi(func_interp * fi, unsigned num, expr * const * args, expr_ref & result) {
+    br_status eval_fi(func_interp * fi, unsigned num, expr * const * args, expr_ref & result) {
         if (fi->num_entries() == 0)
-            return false; // let get_macro handle it.
+            return BR_FAILED; // let get_macro handle it.
 
         SASSERT(fi->get_arity() == num);
 
@@ -110,15 +110,23 @@ struct evaluator_cfg : public default_rewriter_cfg {
             actuals_are_values = m.is_value(args[i]);
 
         if (!actuals_are_values)
-            return false; // let get_macro handle it
+            return BR_FAILED; // let get_macro handle it
 
         func_entry * entry = fi->get_entry(args);
         if (entry != nullptr) {
             result = entry->get_result();
-            return true;
+            return BR_REWRITE1;
         }
 
-        return false;
+        // Unique values that differ from the arguments of every entry select the else case.
+        // This avoids evaluating the if-then-else chain of get_interp() for large graphs.
+        bool actuals_are_unique = fi->args_are_values();
+        for (unsigned i = 0; actuals_are_unique && i < num; i++)
+            actuals_are_unique = m.is_unique_value(args[i]);
+        if (actuals_are_unique && fi->eval_else(args, result))
+            return BR_REWRITE_FULL;
+
+        return BR_FAILED;
     }
 
     br_status reduce_app(func_decl * f, unsigned num, expr * const * args, expr_ref & result, proof_ref & result_pr) {
@@ -186,18 +194,21 @@ struct evaluator_cfg : public default_rewriter_cfg {
             result = args[0];
             st = BR_DONE;
         }
-        else if (evaluate(f, num, args, result)) {
+        else if ((st = evaluate(f, num, args, result)) != BR_FAILED) {
             TRACE("model_evaluator", tout << "reduce_app " << f->get_name() << "\n";
                   for (unsigned i = 0; i < num; i++) tout << mk_ismt2_pp(args[i], m) << "\n";
                   tout << "---->\n" << mk_ismt2_pp(result, m) << "\n";);
-            return BR_REWRITE1;
+            return st;
         }
         if (st == BR_FAILED && !m.is_builtin_family_id(fid))
             st = evaluate_partial_theory_func(f, num, args, result, result_pr);
         if (st == BR_DONE && is_app(result)) {
             app* a = to_app(result);
-            if (evaluate(a->get_decl(), a->get_num_args(), a->get_args(), result)) {
-                return BR_REWRITE1;
+            expr_ref r(m);
+            br_status st2 = evaluate(a->get_decl(), a->get_num_args(), a->get_args(), r);
+            if (st2 != BR_FAILED) {
+                result = r;
+                return st2;
             }
         }
         CTRACE("model_evaluator", st != BR_FAILED, tout << result << "\n";);
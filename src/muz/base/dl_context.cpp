@@ -290,6 +290,10 @@ namespace datalog {
     void context::set_unbound_compressor(bool f) { m_unbound_compressor = f; }
     bool context::similarity_compressor() const { return m_params->datalog_similarity_compressor(); }
     unsigned context::similarity_compressor_threshold() const { return m_params->datalog_similarity_compressor_threshold(); }
+    unsigned context::join_threads() const { return m_params->datalog_join_threads(); }
+    bool context::multiway_join() const { return m_params->datalog_multiway_join(); }
+    bool context::incremental() const { return m_params->datalog_incremental(); }
+    bool context::bdd_interleave() const { return m_params->datalog_bdd_interleave(); }
     unsigned context::soft_timeout() const { return m_fparams.m_timeout; }
     unsigned context::initial_restart_timeout() const { return m_params->datalog_initial_restart_timeout(); }
     bool context::generate_explanations() const { return m_params->datalog_generate_explanations(); }
@@ -668,6 +672,27 @@ namespace datalog {
         add_table_fact(pred, fact);
     }
 
+    void context::remove_fact(func_decl * pred, const relation_fact & fact) {
+        if (get_engine() != DATALOG_ENGINE || !incremental()) {
+            throw default_exception("facts can only be retracted by the datalog engine with datalog.incremental=true");
+        }
+        ensure_engine();
+        m_rel->remove_fact(pred, fact);
+    }
+
+    void context::remove_table_fact(func_decl * pred, unsigned num_args, unsigned args[]) {
+        if (pred->get_arity() != num_args) {
+            std::ostringstream out;
+            out << "mismatched number of arguments passed to " << mk_ismt2_pp(pred, m) << " " << num_args << " passed";
+            throw default_exception(out.str());
+        }
+        relation_fact fact(m);
+        for (unsigned i = 0; i < num_args; ++i) {
+            fact.push_back(m_decl_util.mk_numeral(args[i], pred->get_domain()[i]));
+        }
+        remove_fact(pred, fact);
+    }
+
     void context::close() {
         SASSERT(!m_closed);
         if (!m_rule_set.close()) {
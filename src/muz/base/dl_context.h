@@ -123,6 +123,7 @@ namespace datalog {
         virtual bool result_contains_fact(relation_fact const& f) = 0;
         virtual void add_fact(func_decl* pred, relation_fact const& fact) = 0;
         virtual void add_fact(func_decl* pred, table_fact const& fact) = 0;
+        virtual void remove_fact(func_decl* pred, relation_fact const& fact) = 0;
         virtual bool has_facts(func_decl * pred) const = 0;
         virtual void store_relation(func_decl * pred, relation_base * rel) = 0;
         virtual void inherit_predicate_kind(func_decl* new_pred, func_decl* orig_pred) = 0;
@@ -264,6 +265,10 @@ namespace datalog {
         symbol print_aig() const;
         symbol tab_selection() const;
         unsigned similarity_compressor_threshold() const;
+        unsigned join_threads() const;
+        bool multiway_join() const;
+        bool incremental() const;
+        bool bdd_interleave() const;
         unsigned soft_timeout() const;
         unsigned initial_restart_timeout() const;
         bool generate_explanations() const;
@@ -385,6 +390,11 @@ namespace datalog {
 
         void add_fact(app * head);
         void add_fact(func_decl * pred, const relation_fact & fact);
+        /**
+           \brief Retract a fact that was added with \c add_fact or \c add_table_fact.
+           Requires the datalog engine with datalog.incremental enabled.
+        */
+        void remove_fact(func_decl * pred, const relation_fact & fact);
 
         bool has_facts(func_decl * pred) const;
 
@@ -454,6 +464,7 @@ namespace datalog {
          */
         void add_table_fact(func_decl * pred, const table_fact & fact);
         void add_table_fact(func_decl * pred, unsigned num_args, unsigned args[]);
+        void remove_table_fact(func_decl * pred, unsigned num_args, unsigned args[]);
 
         /**
            \brief To be called after all rules are added.
@@ -0,0 +1,795 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    dl_bdd_relation.cpp
+
+Abstract:
+
+    Relation represented by a binary decision diagram.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#include "muz/rel/dl_bdd_relation.h"
+#include "muz/rel/dl_relation_manager.h"
+#include "muz/base/dl_context.h"
+#include "ast/ast_util.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/var_subst.h"
+
+namespace datalog {
+
+    bdd_relation::bdd_relation(bdd_relation_plugin& p, relation_signature const& sig):
+        relation_base(p, sig),
+        m_elems(p.m_bdd.mk_false()) {
+        for (unsigned i = 0; i < sig.size(); ++i) {
+            m_num_bits.push_back(p.num_sort_bits(sig[i]));
+        }
+    }
+
+    bdd_relation_plugin& bdd_relation::get_plugin() const {
+        return static_cast<bdd_relation_plugin&>(relation_base::get_plugin());
+    }
+
+    void bdd_relation::reset() {
+        m_elems = get_plugin().m_bdd.mk_false();
+    }
+
+    sat::bdd bdd_relation::fact2bdd(relation_fact const& f) const {
+        bdd_relation_plugin& p = get_plugin();
+        sat::bdd result = p.m_bdd.mk_true();
+        for (unsigned i = 0; i < f.size(); ++i) {
+            uint64_t v;
+            VERIFY(p.is_numeral(f[i], v));
+            result &= p.mk_eq(p.mk_col(i, num_bits(i)), p.mk_value(v, num_bits(i)));
+        }
+        return result;
+    }
+
+    void bdd_relation::add_fact(const relation_fact & f) {
+        m_elems |= fact2bdd(f);
+    }
+
+    bool bdd_relation::contains_fact(const relation_fact & f) const {
+        bdd_relation_plugin& p = get_plugin();
+        svector<uint64_t> values;
+        for (unsigned i = 0; i < f.size(); ++i) {
+            uint64_t v;
+            VERIFY(p.is_numeral(f[i], v));
+            values.push_back(v);
+        }
+        sat::bdd b = m_elems;
+        while (!b.is_true() && !b.is_false()) {
+            unsigned col, bit;
+            p.get_column(b.var(), col, bit);
+            b = ((values[col] >> bit) & 1) ? b.hi() : b.lo();
+        }
+        return b.is_true();
+    }
+
+    bdd_relation * bdd_relation::clone() const {
+        bdd_relation* result = bdd_relation_plugin::get(get_plugin().mk_empty(get_signature()));
+        result->m_elems = m_elems;
+        return result;
+    }
+
+    bdd_relation * bdd_relation::complement(func_decl* f) const {
+        bdd_relation_plugin& p = get_plugin();
+        bdd_relation* result = bdd_relation_plugin::get(p.mk_empty(get_signature()));
+        result->m_elems = p.mk_domain(get_signature()) && !m_elems;
+        return result;
+    }
+
+    void bdd_relation::to_formula(expr_ref& fml) const {
+        bdd_relation_plugin& p = get_plugin();
+        ast_manager& m = p.get_ast_manager();
+        relation_signature const& sig = get_signature();
+        expr_ref_vector disj(m);
+        p.enumerate(*this, [&](svector<uint64_t> const& values) {
+                expr_ref_vector conjs(m);
+                for (unsigned i = 0; i < values.size(); ++i) {
+                    conjs.push_back(m.mk_eq(m.mk_var(i, sig[i]), p.mk_numeral(values[i], sig[i])));
+                }
+                disj.push_back(mk_and(m, conjs.size(), conjs.c_ptr()));
+            });
+        fml = mk_or(m, disj.size(), disj.c_ptr());
+    }
+
+    void bdd_relation::display(std::ostream& out) const {
+        out << "bdd with " << m_elems.bdd_size() << " nodes\n";
+        get_plugin().enumerate(*this, [&](svector<uint64_t> const& values) {
+                out << "(";
+                for (unsigned i = 0; i < values.size(); ++i) {
+                    out << (i > 0 ? ", " : "") << values[i];
+                }
+                out << ")\n";
+            });
+    }
+
+    unsigned bdd_relation::get_size_estimate_rows() const {
+        double sz = m_elems.dnf_size();
+        return sz > UINT_MAX ? UINT_MAX : static_cast<unsigned>(sz);
+    }
+
+    unsigned bdd_relation::get_size_estimate_bytes() const {
+        return sizeof(*this) + 4 * sizeof(unsigned) * m_elems.bdd_size();
+    }
+
+    // -------------
+
+    bdd_relation_plugin::bdd_relation_plugin(relation_manager& rm):
+        relation_plugin(bdd_relation_plugin::get_name(), rm),
+        m(rm.get_context().get_manager()),
+        bv(m),
+        dl(m),
+        m_bdd(0),
+        m_interleave(rm.get_context().bdd_interleave()) {
+        // relations are bounded by the memory limit, and the variable order stays as configured
+        m_bdd.set_max_num_nodes(UINT_MAX / 2);
+    }
+
+    bdd_relation& bdd_relation_plugin::get(relation_base& r) {
+        SASSERT(r.get_plugin().get_name() == get_name());
+        return static_cast<bdd_relation&>(r);
+    }
+
+    bdd_relation* bdd_relation_plugin::get(relation_base* r) {
+        return r ? &get(*r) : nullptr;
+    }
+
+    bdd_relation const & bdd_relation_plugin::get(relation_base const& r) {
+        SASSERT(r.get_plugin().get_name() == get_name());
+        return static_cast<bdd_relation const&>(r);
+    }
+
+    unsigned bdd_relation_plugin::num_sort_bits(sort* s) const {
+        unsigned num_bits = 0;
+        if (bv.is_bv_sort(s))
+            return bv.get_bv_size(s);
+        if (m.is_bool(s))
+            return 1;
+        uint64_t sz;
+        if (dl.try_get_size(s, sz)) {
+            while (sz > 0) ++num_bits, sz /= 2;
+            return num_bits;
+        }
+        UNREACHABLE();
+        return 0;
+    }
+
+    bool bdd_relation_plugin::is_numeral(expr* e, uint64_t& v) const {
+        rational r;
+        unsigned num_bits;
+        if (bv.is_numeral(e, r, num_bits)) {
+            if (!r.is_uint64()) return false;
+            v = r.get_uint64();
+            return true;
+        }
+        if (m.is_true(e)) {
+            v = 1;
+            return true;
+        }
+        if (m.is_false(e)) {
+            v = 0;
+            return true;
+        }
+        return dl.is_numeral(e, v);
+    }
+
+    expr* bdd_relation_plugin::mk_numeral(uint64_t v, sort* s) {
+        if (bv.is_bv_sort(s)) {
+            return bv.mk_numeral(rational(v, rational::ui64()), s);
+        }
+        if (m.is_bool(s)) {
+            return m.mk_bool_val(v != 0);
+        }
+        SASSERT(dl.is_finite_sort(s));
+        return dl.mk_numeral(v, s);
+    }
+
+    unsigned bdd_relation_plugin::get_var(unsigned col, unsigned bit) const {
+        SASSERT(col < max_columns && bit < max_bits);
+        return m_interleave ? bit * max_columns + col : col * max_bits + bit;
+    }
+
+    void bdd_relation_plugin::get_column(unsigned var, unsigned& col, unsigned& bit) const {
+        if (m_interleave) {
+            col = var % max_columns;
+            bit = var / max_columns;
+        }
+        else {
+            col = var / max_bits;
+            bit = var % max_bits;
+        }
+    }
+
+    bdd_relation_plugin::term bdd_relation_plugin::mk_col(unsigned col, unsigned num_bits) {
+        term t;
+        t.m_is_col = true;
+        t.m_col = col;
+        t.m_value = 0;
+        t.m_num_bits = num_bits;
+        return t;
+    }
+
+    bdd_relation_plugin::term bdd_relation_plugin::mk_value(uint64_t v, unsigned num_bits) {
+        term t;
+        t.m_is_col = false;
+        t.m_col = 0;
+        t.m_value = v;
+        t.m_num_bits = num_bits;
+        return t;
+    }
+
+    sat::bdd bdd_relation_plugin::mk_bit(term const& t, unsigned bit) {
+        if (bit >= t.m_num_bits)
+            return m_bdd.mk_false();
+        if (t.m_is_col)
+            return m_bdd.mk_var(get_var(t.m_col, bit));
+        return ((t.m_value >> bit) & 1) ? m_bdd.mk_true() : m_bdd.mk_false();
+    }
+
+    sat::bdd bdd_relation_plugin::mk_eq(term const& t1, term const& t2) {
+        sat::bdd result = m_bdd.mk_true();
+        unsigned n = std::max(t1.m_num_bits, t2.m_num_bits);
+        for (unsigned i = 0; i < n; ++i) {
+            result &= !(mk_bit(t1, i) ^ mk_bit(t2, i));
+        }
+        return result;
+    }
+
+    /**
+       \brief Unsigned comparison t1 < t2, built from the least significant bits.
+    */
+    sat::bdd bdd_relation_plugin::mk_lt(term const& t1, term const& t2) {
+        sat::bdd result = m_bdd.mk_false();
+        unsigned n = std::max(t1.m_num_bits, t2.m_num_bits);
+        for (unsigned i = 0; i < n; ++i) {
+            sat::bdd b1 = mk_bit(t1, i), b2 = mk_bit(t2, i);
+            result = (!b1 && b2) || (!(b1 ^ b2) && result);
+        }
+        return result;
+    }
+
+    /**
+       \brief The tuples whose values are within the sizes of the finite sorts of the columns.
+    */
+    sat::bdd bdd_relation_plugin::mk_domain(relation_signature const& sig) {
+        sat::bdd result = m_bdd.mk_true();
+        for (unsigned i = 0; i < sig.size(); ++i) {
+            uint64_t sz;
+            unsigned num_bits = num_sort_bits(sig[i]);
+            if (!bv.is_bv_sort(sig[i]) && !m.is_bool(sig[i]) && dl.try_get_size(sig[i], sz)) {
+                result &= mk_lt(mk_col(i, num_bits), mk_value(sz, num_bits));
+            }
+        }
+        return result;
+    }
+
+    sat::bdd bdd_relation_plugin::mk_exists(sat::bdd const& b, unsigned col, unsigned num_bits) {
+        unsigned_vector vars;
+        for (unsigned i = 0; i < num_bits; ++i) {
+            vars.push_back(get_var(col, i));
+            m_bdd.mk_var(vars.back());
+        }
+        return m_bdd.mk_exists(vars.size(), vars.c_ptr(), b);
+    }
+
+    sat::bdd bdd_relation_plugin::mk_move(sat::bdd const& b, unsigned num_cols, unsigned_vector const& num_bits,
+                                          unsigned_vector const& src, unsigned_vector const& dst) {
+        unsigned_vector from, to, bits;
+        unsigned top = num_cols;
+        for (unsigned i = 0; i < src.size(); ++i) {
+            top = std::max(top, std::max(src[i], dst[i]) + 1);
+            if (src[i] != dst[i]) {
+                from.push_back(src[i]);
+                to.push_back(dst[i]);
+                bits.push_back(num_bits[i]);
+            }
+        }
+        // moving the columns one by one overwrites a column that is yet to be moved
+        // unless the columns are first moved to unused columns
+        bool overlap = false;
+        for (unsigned i = 0; !overlap && i < to.size(); ++i) {
+            for (unsigned j = i + 1; !overlap && j < from.size(); ++j) {
+                overlap = to[i] == from[j];
+            }
+        }
+        sat::bdd result = b;
+        if (overlap) {
+            for (unsigned i = 0; i < from.size(); ++i) {
+                result = mk_exists(result && mk_eq(mk_col(from[i], bits[i]), mk_col(top + i, bits[i])), from[i], bits[i]);
+                from[i] = top + i;
+            }
+        }
+        for (unsigned i = 0; i < from.size(); ++i) {
+            result = mk_exists(result && mk_eq(mk_col(from[i], bits[i]), mk_col(to[i], bits[i])), from[i], bits[i]);
+        }
+        return result;
+    }
+
+    sat::bdd bdd_relation_plugin::mk_project(sat::bdd const& b, unsigned_vector const& num_bits,
+                                             unsigned removed_cnt, unsigned const* removed) {
+        sat::bdd result = b;
+        svector<bool> is_removed(num_bits.size(), false);
+        for (unsigned i = 0; i < removed_cnt; ++i) {
+            is_removed[removed[i]] = true;
+            result = mk_exists(result, removed[i], num_bits[removed[i]]);
+        }
+        unsigned_vector src, dst, bits;
+        for (unsigned i = 0; i < num_bits.size(); ++i) {
+            if (!is_removed[i]) {
+                dst.push_back(src.size());
+                src.push_back(i);
+                bits.push_back(num_bits[i]);
+            }
+        }
+        return mk_move(result, num_bits.size(), bits, src, dst);
+    }
+
+    /**
+       \brief The columns of \c t2 follow the columns of \c t1 in the join.
+    */
+    sat::bdd bdd_relation_plugin::mk_join(bdd_relation const& t1, bdd_relation const& t2,
+                                          unsigned col_cnt, unsigned const* cols1, unsigned const* cols2) {
+        unsigned n1 = t1.get_signature().size();
+        unsigned n2 = t2.get_signature().size();
+        unsigned_vector src, dst, bits;
+        for (unsigned j = n2; j-- > 0; ) {
+            src.push_back(j);
+            dst.push_back(n1 + j);
+            bits.push_back(t2.num_bits(j));
+        }
+        sat::bdd result = t1.get_bdd() && mk_move(t2.get_bdd(), n2, bits, src, dst);
+        for (unsigned i = 0; i < col_cnt; ++i) {
+            result &= mk_eq(mk_col(cols1[i], t1.num_bits(cols1[i])), mk_col(n1 + cols2[i], t2.num_bits(cols2[i])));
+        }
+        return result;
+    }
+
+    bool bdd_relation_plugin::compile_term(bdd_relation const& r, expr* e, term& t) {
+        uint64_t v;
+        if (is_var(e)) {
+            unsigned col = to_var(e)->get_idx();
+            if (col >= r.get_signature().size())
+                return false;
+            t = mk_col(col, r.num_bits(col));
+            return true;
+        }
+        if (is_numeral(e, v)) {
+            t = mk_value(v, num_sort_bits(m.get_sort(e)));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+       \brief Compile the Boolean combinations of equalities and unsigned comparisons between
+       columns and constants in \c e. Return false if \c e contains other conditions.
+    */
+    bool bdd_relation_plugin::compile_condition(bdd_relation const& r, expr* e, sat::bdd& result) {
+        expr *e1, *e2, *e3;
+        term t1, t2;
+        if (m.is_true(e)) {
+            result = m_bdd.mk_true();
+            return true;
+        }
+        if (m.is_false(e)) {
+            result = m_bdd.mk_false();
+            return true;
+        }
+        if (m.is_and(e) || m.is_or(e)) {
+            bool is_and = m.is_and(e);
+            result = is_and ? m_bdd.mk_true() : m_bdd.mk_false();
+            for (expr* arg : *to_app(e)) {
+                sat::bdd b = m_bdd.mk_true();
+                if (!compile_condition(r, arg, b))
+                    return false;
+                result = is_and ? (result && b) : (result || b);
+            }
+            return true;
+        }
+        if (m.is_not(e, e1)) {
+            if (!compile_condition(r, e1, result))
+                return false;
+            result = !result;
+            return true;
+        }
+        if (m.is_ite(e, e1, e2, e3)) {
+            sat::bdd c = m_bdd.mk_true(), th = m_bdd.mk_true(), el = m_bdd.mk_true();
+            if (!compile_condition(r, e1, c) || !compile_condition(r, e2, th) || !compile_condition(r, e3, el))
+                return false;
+            result = m_bdd.mk_ite(c, th, el);
+            return true;
+        }
+        if (is_var(e) && m.is_bool(e) && compile_term(r, e, t1)) {
+            result = mk_bit(t1, 0);
+            return true;
+        }
+        if (m.is_eq(e, e1, e2)) {
+            if (compile_term(r, e1, t1) && compile_term(r, e2, t2)) {
+                result = mk_eq(t1, t2);
+                return true;
+            }
+            sat::bdd b1 = m_bdd.mk_true(), b2 = m_bdd.mk_true();
+            if (m.is_bool(e1) && compile_condition(r, e1, b1) && compile_condition(r, e2, b2)) {
+                result = !(b1 ^ b2);
+                return true;
+            }
+            return false;
+        }
+        if (m.is_distinct(e)) {
+            app* a = to_app(e);
+            result = m_bdd.mk_true();
+            for (unsigned i = 0; i < a->get_num_args(); ++i) {
+                for (unsigned j = i + 1; j < a->get_num_args(); ++j) {
+                    if (!compile_term(r, a->get_arg(i), t1) || !compile_term(r, a->get_arg(j), t2))
+                        return false;
+                    result &= !mk_eq(t1, t2);
+                }
+            }
+            return true;
+        }
+        if (is_app(e) && to_app(e)->get_num_args() == 2 &&
+            compile_term(r, to_app(e)->get_arg(0), t1) && compile_term(r, to_app(e)->get_arg(1), t2)) {
+            app* a = to_app(e);
+            if (dl.is_lt(a)) {
+                result = mk_lt(t1, t2);
+                return true;
+            }
+            if (a->get_family_id() != bv.get_fid())
+                return false;
+            switch (a->get_decl_kind()) {
+            case OP_ULT: result = mk_lt(t1, t2); return true;
+            case OP_UGT: result = mk_lt(t2, t1); return true;
+            case OP_ULEQ: result = !mk_lt(t2, t1); return true;
+            case OP_UGEQ: result = !mk_lt(t1, t2); return true;
+            default: return false;
+            }
+        }
+        return false;
+    }
+
+    void bdd_relation_plugin::enumerate(bdd_relation const& r, std::function<void(svector<uint64_t> const&)> const& proc) {
+        svector<uint64_t> values(r.num_bits().size(), static_cast<uint64_t>(0));
+        svector<uint64_t> fixed(r.num_bits().size(), static_cast<uint64_t>(0));
+        enumerate(r.get_bdd(), r.num_bits(), values, fixed, proc);
+    }
+
+    /**
+       \brief Enumerate the tuples on the paths of \c b: the bits that a path does not test
+       take both values.
+    */
+    void bdd_relation_plugin::enumerate(sat::bdd const& b, unsigned_vector const& num_bits, svector<uint64_t>& values,
+                                        svector<uint64_t>& fixed, std::function<void(svector<uint64_t> const&)> const& proc) {
+        if (b.is_false())
+            return;
+        if (b.is_true()) {
+            expand(0, 0, num_bits, values, fixed, proc);
+            return;
+        }
+        unsigned col, bit;
+        get_column(b.var(), col, bit);
+        uint64_t mask = static_cast<uint64_t>(1) << bit;
+        fixed[col] |= mask;
+        values[col] &= ~mask;
+        enumerate(b.lo(), num_bits, values, fixed, proc);
+        values[col] |= mask;
+        enumerate(b.hi(), num_bits, values, fixed, proc);
+        values[col] &= ~mask;
+        fixed[col] &= ~mask;
+    }
+
+    void bdd_relation_plugin::expand(unsigned col, unsigned bit, unsigned_vector const& num_bits, svector<uint64_t>& values,
+                                     svector<uint64_t> const& fixed, std::function<void(svector<uint64_t> const&)> const& proc) {
+        if (col == num_bits.size()) {
+            proc(values);
+            return;
+        }
+        if (bit == num_bits[col]) {
+            expand(col + 1, 0, num_bits, values, fixed, proc);
+            return;
+        }
+        uint64_t mask = static_cast<uint64_t>(1) << bit;
+        if (fixed[col] & mask) {
+            expand(col, bit + 1, num_bits, values, fixed, proc);
+            return;
+        }
+        values[col] &= ~mask;
+        expand(col, bit + 1, num_bits, values, fixed, proc);
+        values[col] |= mask;
+        expand(col, bit + 1, num_bits, values, fixed, proc);
+        values[col] &= ~mask;
+    }
+
+    bool bdd_relation_plugin::can_handle_signature(const relation_signature & sig) {
+        if (sig.size() > max_columns / 2)
+            return false;
+        for (unsigned i = 0; i < sig.size(); ++i) {
+            sort* s = sig[i];
+            if (bv.is_bv_sort(s) ? bv.get_bv_size(s) > max_bits : !m.is_bool(s) && !dl.is_finite_sort(s))
+                return false;
+        }
+        return true;
+    }
+
+    relation_base * bdd_relation_plugin::mk_empty(const relation_signature & sig) {
+        return alloc(bdd_relation, *this, sig);
+    }
+
+    relation_base * bdd_relation_plugin::mk_full(func_decl* p, const relation_signature & sig) {
+        bdd_relation* r = get(mk_empty(sig));
+        r->m_elems = mk_domain(sig);
+        return r;
+    }
+
+    class bdd_relation_plugin::join_fn : public convenient_relation_join_fn {
+    public:
+        join_fn(bdd_relation const& t1, bdd_relation const& t2, unsigned col_cnt,
+                const unsigned * cols1, const unsigned * cols2)
+            : convenient_relation_join_fn(t1.get_signature(), t2.get_signature(), col_cnt, cols1, cols2) {}
+
+        relation_base * operator()(const relation_base & _r1, const relation_base & _r2) override {
+            bdd_relation const& r1 = get(_r1);
+            bdd_relation const& r2 = get(_r2);
+            bdd_relation_plugin& p = r1.get_plugin();
+            bdd_relation* result = get(p.mk_empty(get_result_signature()));
+            result->m_elems = p.mk_join(r1, r2, m_cols1.size(), m_cols1.c_ptr(), m_cols2.c_ptr());
+            return result;
+        }
+    };
+
+    relation_join_fn * bdd_relation_plugin::mk_join_fn(
+        const relation_base & t1, const relation_base & t2,
+        unsigned col_cnt, const unsigned * cols1, const unsigned * cols2) {
+        if (!check_kind(t1) || !check_kind(t2) ||
+            t1.get_signature().size() + t2.get_signature().size() > max_columns / 2) {
+            return nullptr;
+        }
+        return alloc(join_fn, get(t1), get(t2), col_cnt, cols1, cols2);
+    }
+
+    /**
+       \brief Join and project in one relational product, without materializing the join.
+    */
+    class bdd_relation_plugin::join_project_fn : public convenient_relation_join_project_fn {
+    public:
+        join_project_fn(bdd_relation const& t1, bdd_relation const& t2, unsigned col_cnt,
+                        const unsigned * cols1, const unsigned * cols2,
+                        unsigned removed_col_cnt, const unsigned * removed_cols)
+            : convenient_relation_join_project_fn(t1.get_signature(), t2.get_signature(), col_cnt, cols1, cols2,
+                                                  removed_col_cnt, removed_cols) {}
+
+        relation_base * operator()(const relation_base & _r1, const relation_base & _r2) override {
+            bdd_relation const& r1 = get(_r1);
+            bdd_relation const& r2 = get(_r2);
+            bdd_relation_plugin& p = r1.get_plugin();
+            bdd_relation* result = get(p.mk_empty(get_result_signature()));
+            unsigned_vector num_bits(r1.num_bits());
+            num_bits.append(r2.num_bits());
+            sat::bdd join = p.mk_join(r1, r2, m_cols1.size(), m_cols1.c_ptr(), m_cols2.c_ptr());
+            result->m_elems = p.mk_project(join, num_bits, m_removed_cols.size(), m_removed_cols.c_ptr());
+            return result;
+        }
+    };
+
+    relation_join_fn * bdd_relation_plugin::mk_join_project_fn(
+        relation_base const& t1, relation_base const& t2,
+        unsigned joined_col_cnt, const unsigned * cols1, const unsigned * cols2,
+        unsigned removed_col_cnt, const unsigned * removed_cols) {
+        if (!check_kind(t1) || !check_kind(t2) ||
+            t1.get_signature().size() + t2.get_signature().size() > max_columns / 2) {
+            return nullptr;
+        }
+        return alloc(join_project_fn, get(t1), get(t2), joined_col_cnt, cols1, cols2, removed_col_cnt, removed_cols);
+    }
+
+    class bdd_relation_plugin::project_fn : public convenient_relation_project_fn {
+    public:
+        project_fn(bdd_relation const& t, unsigned removed_col_cnt, const unsigned * removed_cols)
+            : convenient_relation_project_fn(t.get_signature(), removed_col_cnt, removed_cols) {}
+
+        relation_base * operator()(const relation_base & _r) override {
+            bdd_relation const& r = get(_r);
+            bdd_relation_plugin& p = r.get_plugin();
+            bdd_relation* result = get(p.mk_empty(get_result_signature()));
+            result->m_elems = p.mk_project(r.get_bdd(), r.num_bits(), m_removed_cols.size(), m_removed_cols.c_ptr());
+            return result;
+        }
+    };
+
+    relation_transformer_fn * bdd_relation_plugin::mk_project_fn(
+        const relation_base & t, unsigned col_cnt,
+        const unsigned * removed_cols) {
+        if (!check_kind(t))
+            return nullptr;
+        return alloc(project_fn, get(t), col_cnt, removed_cols);
+    }
+
+    class bdd_relation_plugin::rename_fn : public convenient_relation_rename_fn {
+    public:
+        rename_fn(bdd_relation const& t, unsigned cycle_len, const unsigned * cycle)
+            : convenient_relation_rename_fn(t.get_signature(), cycle_len, cycle) {}
+
+        relation_base * operator()(const relation_base & _r) override {
+            bdd_relation const& r = get(_r);
+            bdd_relation_plugin& p = r.get_plugin();
+            bdd_relation* result = get(p.mk_empty(get_result_signature()));
+            unsigned_vector src, dst, num_bits;
+            for (unsigned i = 0; i < m_cycle.size(); ++i) {
+                src.push_back(m_cycle[i]);
+                dst.push_back(m_cycle[(i + 1) % m_cycle.size()]);
+                num_bits.push_back(r.num_bits(m_cycle[i]));
+            }
+            result->m_elems = p.mk_move(r.get_bdd(), r.get_signature().size(), num_bits, src, dst);
+            return result;
+        }
+    };
+
+    relation_transformer_fn * bdd_relation_plugin::mk_rename_fn(
+        const relation_base & t, unsigned cycle_len, const unsigned * permutation_cycle) {
+        if (!check_kind(t))
+            return nullptr;
+        return alloc(rename_fn, get(t), cycle_len, permutation_cycle);
+    }
+
+    class bdd_relation_plugin::union_fn : public relation_union_fn {
+    public:
+        void operator()(relation_base & _r, const relation_base & _src, relation_base * _delta) override {
+            bdd_relation& r = get(_r);
+            bdd_relation const& src = get(_src);
+            if (_delta) {
+                bdd_relation& d = get(*_delta);
+                d.m_elems = d.m_elems || (src.get_bdd() && !r.get_bdd());
+            }
+            r.m_elems = r.m_elems || src.get_bdd();
+        }
+    };
+
+    relation_union_fn * bdd_relation_plugin::mk_union_fn(
+        const relation_base & tgt, const relation_base & src,
+        const relation_base * delta) {
+        if (!check_kind(tgt) || !check_kind(src) || (delta && !check_kind(*delta)))
+            return nullptr;
+        return alloc(union_fn);
+    }
+
+    relation_union_fn * bdd_relation_plugin::mk_widen_fn(
+        const relation_base & tgt, const relation_base & src,
+        const relation_base * delta) {
+        return mk_union_fn(tgt, src, delta);
+    }
+
+    class bdd_relation_plugin::filter_identical_fn : public relation_mutator_fn {
+        unsigned_vector m_cols;
+    public:
+        filter_identical_fn(unsigned col_cnt, const unsigned * identical_cols)
+            : m_cols(col_cnt, identical_cols) {}
+
+        void operator()(relation_base & _r) override {
+            bdd_relation& r = get(_r);
+            bdd_relation_plugin& p = r.get_plugin();
+            for (unsigned i = 1; i < m_cols.size(); ++i) {
+                r.m_elems &= p.mk_eq(p.mk_col(m_cols[0], r.num_bits(m_cols[0])), p.mk_col(m_cols[i], r.num_bits(m_cols[i])));
+            }
+        }
+    };
+
+    relation_mutator_fn * bdd_relation_plugin::mk_filter_identical_fn(
+        const relation_base & t, unsigned col_cnt,
+        const unsigned * identical_cols) {
+        if (!check_kind(t))
+            return nullptr;
+        return alloc(filter_identical_fn, col_cnt, identical_cols);
+    }
+
+    class bdd_relation_plugin::filter_equal_fn : public relation_mutator_fn {
+        unsigned m_col;
+        uint64_t m_value;
+    public:
+        filter_equal_fn(unsigned col, uint64_t value): m_col(col), m_value(value) {}
+
+        void operator()(relation_base & _r) override {
+            bdd_relation& r = get(_r);
+            bdd_relation_plugin& p = r.get_plugin();
+            unsigned num_bits = r.num_bits(m_col);
+            r.m_elems &= p.mk_eq(p.mk_col(m_col, num_bits), p.mk_value(m_value, num_bits));
+        }
+    };
+
+    relation_mutator_fn * bdd_relation_plugin::mk_filter_equal_fn(
+        const relation_base & t, const relation_element & value, unsigned col) {
+        uint64_t v;
+        if (!check_kind(t) || !is_numeral(value, v))
+            return nullptr;
+        return alloc(filter_equal_fn, col, v);
+    }
+
+    class bdd_relation_plugin::filter_interpreted_fn : public relation_mutator_fn {
+        app_ref m_condition;
+    public:
+        filter_interpreted_fn(ast_manager& m, app* condition): m_condition(condition, m) {}
+
+        void operator()(relation_base & _r) override {
+            bdd_relation& r = get(_r);
+            bdd_relation_plugin& p = r.get_plugin();
+            sat::bdd cond = p.m_bdd.mk_true();
+            if (p.compile_condition(r, m_condition, cond)) {
+                r.m_elems &= cond;
+                return;
+            }
+            // evaluate other conditions on the tuples
+            ast_manager& m = m_condition.get_manager();
+            relation_signature const& sig = r.get_signature();
+            th_rewriter rw(m);
+            var_subst sub(m, false);
+            sat::bdd result = p.m_bdd.mk_false();
+            p.enumerate(r, [&](svector<uint64_t> const& values) {
+                    expr_ref_vector args(m);
+                    for (unsigned i = 0; i < values.size(); ++i) {
+                        args.push_back(p.mk_numeral(values[i], sig[i]));
+                    }
+                    expr_ref c = sub(m_condition, args.size(), args.c_ptr());
+                    rw(c);
+                    if (m.is_true(c)) {
+                        sat::bdd tuple = p.m_bdd.mk_true();
+                        for (unsigned i = 0; i < values.size(); ++i) {
+                            tuple &= p.mk_eq(p.mk_col(i, r.num_bits(i)), p.mk_value(values[i], r.num_bits(i)));
+                        }
+                        result |= tuple;
+                    }
+                });
+            r.m_elems = result;
+        }
+    };
+
+    relation_mutator_fn * bdd_relation_plugin::mk_filter_interpreted_fn(const relation_base & t, app * condition) {
+        if (!check_kind(t))
+            return nullptr;
+        return alloc(filter_interpreted_fn, m, condition);
+    }
+
+    class bdd_relation_plugin::negation_filter_fn : public relation_intersection_filter_fn {
+        unsigned_vector m_t_cols;
+        unsigned_vector m_neg_cols;
+    public:
+        negation_filter_fn(unsigned joined_col_cnt, const unsigned * t_cols, const unsigned * neg_cols)
+            : m_t_cols(joined_col_cnt, t_cols), m_neg_cols(joined_col_cnt, neg_cols) {}
+
+        void operator()(relation_base & _t, const relation_base & _neg) override {
+            bdd_relation& t = get(_t);
+            bdd_relation const& neg = get(_neg);
+            bdd_relation_plugin& p = t.get_plugin();
+            // the tuples of t that match a tuple of neg are those of the join projected on t
+            unsigned n = t.get_signature().size();
+            unsigned_vector removed;
+            for (unsigned i = 0; i < neg.get_signature().size(); ++i) {
+                removed.push_back(n + i);
+            }
+            unsigned_vector num_bits(t.num_bits());
+            num_bits.append(neg.num_bits());
+            sat::bdd join = p.mk_join(t, neg, m_t_cols.size(), m_t_cols.c_ptr(), m_neg_cols.c_ptr());
+            sat::bdd matched = p.mk_project(join, num_bits, removed.size(), removed.c_ptr());
+            t.m_elems &= !matched;
+        }
+    };
+
+    relation_intersection_filter_fn * bdd_relation_plugin::mk_filter_by_negation_fn(
+        const relation_base& t,
+        const relation_base& neg, unsigned joined_col_cnt, const unsigned *t_cols,
+        const unsigned *negated_cols) {
+        if (!check_kind(t) || !check_kind(neg) ||
+            t.get_signature().size() + neg.get_signature().size() > max_columns / 2) {
+            return nullptr;
+        }
+        return alloc(negation_filter_fn, joined_col_cnt, t_cols, negated_cols);
+    }
+
+};
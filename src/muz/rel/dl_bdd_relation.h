@@ -0,0 +1,174 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    dl_bdd_relation.h
+
+Abstract:
+
+    Relation represented by a binary decision diagram.
+
+    Every column of a finite sort is encoded by the bits of its values.
+    A relation is the BDD of the characteristic function of its tuples
+    over these bits, so relations with many regular tuples, as they occur
+    in program analyses, are stored in a fraction of their size, and joins
+    and projections operate on the compressed representation.
+
+    The bits of column c are the BDD variables of c. With
+    datalog.bdd_interleave the bits of all columns are interleaved, most
+    significant bits first, which keeps equalities between columns small.
+    Otherwise the bits are ordered column by column.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#ifndef DL_BDD_RELATION_H_
+#define DL_BDD_RELATION_H_
+
+#include <functional>
+#include "ast/bv_decl_plugin.h"
+#include "ast/dl_decl_plugin.h"
+#include "sat/sat_bdd.h"
+#include "muz/rel/dl_base.h"
+
+namespace datalog {
+
+    class bdd_relation_plugin;
+
+    class bdd_relation : public relation_base {
+        friend class bdd_relation_plugin;
+        sat::bdd        m_elems;
+        unsigned_vector m_num_bits;    // number of bits of each column
+
+        sat::bdd fact2bdd(relation_fact const& f) const;
+    public:
+        bdd_relation(bdd_relation_plugin& p, relation_signature const& s);
+        bdd_relation_plugin& get_plugin() const;
+        void reset() override;
+        void add_fact(const relation_fact & f) override;
+        bool contains_fact(const relation_fact & f) const override;
+        bdd_relation * clone() const override;
+        bdd_relation * complement(func_decl*) const override;
+        void to_formula(expr_ref& fml) const override;
+        bool empty() const override { return m_elems.is_false(); }
+        void display(std::ostream& out) const override;
+        bool is_precise() const override { return true; }
+        unsigned get_size_estimate_rows() const override;
+        unsigned get_size_estimate_bytes() const override;
+
+        sat::bdd const& get_bdd() const { return m_elems; }
+        unsigned num_bits(unsigned col) const { return m_num_bits[col]; }
+        unsigned_vector const& num_bits() const { return m_num_bits; }
+    };
+
+    class bdd_relation_plugin : public relation_plugin {
+        friend class bdd_relation;
+        class join_fn;
+        class join_project_fn;
+        class project_fn;
+        class rename_fn;
+        class union_fn;
+        class filter_equal_fn;
+        class filter_identical_fn;
+        class filter_interpreted_fn;
+        class negation_filter_fn;
+
+        /**
+           \brief A column or a constant in a condition.
+        */
+        struct term {
+            bool     m_is_col;
+            unsigned m_col;
+            uint64_t m_value;
+            unsigned m_num_bits;
+        };
+
+        // the interleaved order leaves room for temporary columns of the same number
+        static const unsigned max_columns = 256;
+        static const unsigned max_bits = 64;
+
+        ast_manager&     m;
+        bv_util          bv;
+        dl_decl_util     dl;
+        sat::bdd_manager m_bdd;
+        bool             m_interleave;
+
+        static bdd_relation& get(relation_base& r);
+        static bdd_relation* get(relation_base* r);
+        static bdd_relation const & get(relation_base const& r);
+
+        unsigned num_sort_bits(sort* s) const;
+        bool is_numeral(expr* e, uint64_t& v) const;
+        expr* mk_numeral(uint64_t v, sort* s);
+
+        unsigned get_var(unsigned col, unsigned bit) const;
+        void get_column(unsigned var, unsigned& col, unsigned& bit) const;
+
+        sat::bdd mk_bit(term const& t, unsigned bit);
+        sat::bdd mk_eq(term const& t1, term const& t2);
+        sat::bdd mk_lt(term const& t1, term const& t2);
+        term mk_col(unsigned col, unsigned num_bits);
+        term mk_value(uint64_t v, unsigned num_bits);
+        sat::bdd mk_domain(relation_signature const& sig);
+        sat::bdd mk_exists(sat::bdd const& b, unsigned col, unsigned num_bits);
+        /**
+           \brief Move the columns src[i] of \c b, which have num_bits[i] bits, to the columns dst[i].
+           The target columns that are not also source columns must be unused in \c b,
+           and \c b may only use the columns below \c num_cols.
+        */
+        sat::bdd mk_move(sat::bdd const& b, unsigned num_cols, unsigned_vector const& num_bits,
+                         unsigned_vector const& src, unsigned_vector const& dst);
+        /**
+           \brief Remove the columns \c removed (in increasing order) of \c b and shift the remaining
+           columns to the front.
+        */
+        sat::bdd mk_project(sat::bdd const& b, unsigned_vector const& num_bits,
+                            unsigned removed_cnt, unsigned const* removed);
+        sat::bdd mk_join(bdd_relation const& t1, bdd_relation const& t2,
+                         unsigned col_cnt, unsigned const* cols1, unsigned const* cols2);
+        bool compile_condition(bdd_relation const& r, expr* e, sat::bdd& result);
+        bool compile_term(bdd_relation const& r, expr* e, term& t);
+        void enumerate(bdd_relation const& r, std::function<void(svector<uint64_t> const&)> const& proc);
+        void enumerate(sat::bdd const& b, unsigned_vector const& num_bits, svector<uint64_t>& values,
+                       svector<uint64_t>& fixed, std::function<void(svector<uint64_t> const&)> const& proc);
+        void expand(unsigned col, unsigned bit, unsigned_vector const& num_bits, svector<uint64_t>& values,
+                    svector<uint64_t> const& fixed, std::function<void(svector<uint64_t> const&)> const& proc);
+    public:
+        bdd_relation_plugin(relation_manager& rm);
+        static symbol get_name() { return symbol("bdd"); }
+        bool can_handle_signature(const relation_signature & s) override;
+        relation_base * mk_empty(const relation_signature & s) override;
+        relation_base * mk_full(func_decl* p, const relation_signature & s) override;
+        relation_join_fn * mk_join_fn(const relation_base & t1, const relation_base & t2,
+            unsigned col_cnt, const unsigned * cols1, const unsigned * cols2) override;
+        relation_join_fn * mk_join_project_fn(
+            relation_base const& t1, relation_base const& t2,
+            unsigned joined_col_cnt, const unsigned * cols1, const unsigned * cols2,
+            unsigned removed_col_cnt, const unsigned * removed_cols) override;
+        relation_transformer_fn * mk_project_fn(const relation_base & t, unsigned col_cnt,
+            const unsigned * removed_cols) override;
+        relation_transformer_fn * mk_rename_fn(const relation_base & t, unsigned permutation_cycle_len,
+            const unsigned * permutation_cycle) override;
+        relation_union_fn * mk_union_fn(const relation_base & tgt, const relation_base & src,
+            const relation_base * delta) override;
+        relation_union_fn * mk_widen_fn(const relation_base & tgt, const relation_base & src,
+            const relation_base * delta) override;
+        relation_mutator_fn * mk_filter_identical_fn(const relation_base & t, unsigned col_cnt,
+            const unsigned * identical_cols) override;
+        relation_mutator_fn * mk_filter_equal_fn(const relation_base & t, const relation_element & value,
+            unsigned col) override;
+        relation_mutator_fn * mk_filter_interpreted_fn(const relation_base & t, app * condition) override;
+        relation_intersection_filter_fn * mk_filter_by_negation_fn(
+            const relation_base& t,
+            const relation_base& neg, unsigned joined_col_cnt, const unsigned *t_cols,
+            const unsigned *negated_cols) override;
+    };
+};
+
+#endif /* DL_BDD_RELATION_H_ */
@@ -0,0 +1,489 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    dl_column_table.cpp
+
+Abstract:
+
+    Table stored column-wise.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#include "util/hash.h"
+#include "util/map.h"
+#include "util/thread_pool.h"
+#include "muz/base/dl_context.h"
+#include "muz/rel/dl_column_table.h"
+#include "muz/rel/dl_relation_manager.h"
+
+namespace datalog {
+
+    // -----------------------------------
+    //
+    // column_table
+    //
+    // -----------------------------------
+
+    column_table::column_table(column_table_plugin & plugin, const table_signature & sig):
+        table_base(plugin, sig),
+        m_num_rows(0),
+        m_index(DEFAULT_HASHTABLE_INITIAL_CAPACITY, row_hash_proc(*this), row_eq_proc(*this)) {
+        m_columns.resize(sig.size());
+        for (column & c : m_columns)
+            c.resize(1, 0);
+    }
+
+    unsigned column_table::hash_row(unsigned r) const {
+        unsigned h = 17;
+        for (column const & c : m_columns)
+            h = combine_hash(h, hash_ull(c[r]));
+        return h;
+    }
+
+    bool column_table::eq_rows(unsigned r1, unsigned r2) const {
+        for (column const & c : m_columns)
+            if (c[r1] != c[r2])
+                return false;
+        return true;
+    }
+
+    void column_table::set_scratch(const table_element * f) const {
+        unsigned n = num_cols();
+        for (unsigned i = 0; i < n; ++i)
+            m_columns[i][m_num_rows] = f[i];
+    }
+
+    void column_table::copy_row(unsigned src, unsigned dst) {
+        for (column & c : m_columns)
+            c[dst] = c[src];
+    }
+
+    void column_table::resize_rows(unsigned n) {
+        for (column & c : m_columns)
+            c.resize(n + 1, 0);
+        m_num_rows = n;
+    }
+
+    void column_table::rebuild_index(unsigned n) {
+        m_index.reset();
+        unsigned j = 0;
+        for (unsigned r = 0; r < n; ++r) {
+            if (r != j)
+                copy_row(r, j);
+            if (m_index.insert_if_not_there(j) == j)
+                ++j;
+        }
+        resize_rows(j);
+    }
+
+    void column_table::compact(unsigned_vector const & rows) {
+        unsigned n = rows.size();
+        if (n == m_num_rows)
+            return;
+        for (column & c : m_columns) {
+            table_element * data = c.c_ptr();
+            for (unsigned i = 0; i < n; ++i)
+                data[i] = data[rows[i]];
+        }
+        rebuild_index(n);
+    }
+
+    void column_table::add_fact(const table_fact & f) {
+        set_scratch(f.c_ptr());
+        if (m_index.insert_if_not_there(m_num_rows) == m_num_rows) {
+            for (column & c : m_columns)
+                c.push_back(0);
+            ++m_num_rows;
+        }
+    }
+
+    void column_table::remove_fact(const table_element * fact) {
+        set_scratch(fact);
+        unsigned r;
+        if (!m_index.find(m_num_rows, r))
+            return;
+        m_index.remove(r);
+        unsigned last = m_num_rows - 1;
+        if (r != last) {
+            m_index.remove(last);
+            copy_row(last, r);
+            m_index.insert(r);
+        }
+        resize_rows(last);
+    }
+
+    bool column_table::contains_fact(const table_fact & f) const {
+        set_scratch(f.c_ptr());
+        return m_index.contains(m_num_rows);
+    }
+
+    void column_table::reset() {
+        m_index.reset();
+        resize_rows(0);
+    }
+
+    table_base * column_table::clone() const {
+        column_table * res = static_cast<column_table *>(get_plugin().mk_empty(get_signature()));
+        res->m_columns = m_columns;
+        res->rebuild_index(m_num_rows);
+        return res;
+    }
+
+    class column_table::our_iterator_core : public iterator_core {
+        const column_table & m_table;
+        unsigned             m_row;
+
+        class our_row : public row_interface {
+            const our_iterator_core & m_parent;
+        public:
+            our_row(const our_iterator_core & parent) : row_interface(parent.m_table), m_parent(parent) {}
+
+            void get_fact(table_fact & result) const override {
+                unsigned n = m_parent.m_table.num_cols();
+                result.reset();
+                for (unsigned i = 0; i < n; ++i)
+                    result.push_back(m_parent.m_table.m_columns[i][m_parent.m_row]);
+            }
+            table_element operator[](unsigned col) const override {
+                return m_parent.m_table.m_columns[col][m_parent.m_row];
+            }
+        };
+
+        our_row m_row_obj;
+
+    public:
+        our_iterator_core(const column_table & t, bool finished) :
+            m_table(t), m_row(finished ? t.m_num_rows : 0), m_row_obj(*this) {}
+
+        bool is_finished() const override {
+            return m_row == m_table.m_num_rows;
+        }
+
+        row_interface & operator*() override {
+            SASSERT(!is_finished());
+            return m_row_obj;
+        }
+
+        void operator++() override {
+            SASSERT(!is_finished());
+            ++m_row;
+        }
+    };
+
+    table_base::iterator column_table::begin() const {
+        return mk_iterator(alloc(our_iterator_core, *this, false));
+    }
+
+    table_base::iterator column_table::end() const {
+        return mk_iterator(alloc(our_iterator_core, *this, true));
+    }
+
+    // -----------------------------------
+    //
+    // column_table_plugin
+    //
+    // -----------------------------------
+
+    column_table const & column_table_plugin::get(table_base const & t) { return static_cast<column_table const &>(t); }
+    column_table & column_table_plugin::get(table_base & t) { return static_cast<column_table &>(t); }
+    column_table * column_table_plugin::get(table_base * t) { return static_cast<column_table *>(t); }
+
+    table_base * column_table_plugin::mk_empty(const table_signature & s) {
+        SASSERT(can_handle_signature(s));
+        return alloc(column_table, *this, s);
+    }
+
+    /**
+       \brief Hash join.
+
+       The hashes of the join keys of the smaller table are computed column by column,
+       and the rows with the same hash are chained. The larger table probes the chains,
+       and the result is gathered column by column from the matching pairs of rows.
+       With datalog.join_threads > 1, large probes are split into tasks of the shared thread pool.
+    */
+    class column_table_plugin::join_fn : public convenient_table_join_fn {
+        unsigned_vector m_hashes;
+        unsigned_vector m_next;
+        unsigned_vector m_rows1;
+        unsigned_vector m_rows2;
+
+        void hash_keys(column_table const & t, unsigned_vector const & cols) {
+            unsigned n = t.m_num_rows;
+            m_hashes.reset();
+            m_hashes.resize(n, 17);
+            unsigned * hs = m_hashes.c_ptr();
+            for (unsigned c : cols) {
+                table_element const * data = t.m_columns[c].c_ptr();
+                for (unsigned r = 0; r < n; ++r)
+                    hs[r] = combine_hash(hs[r], hash_ull(data[r]));
+            }
+        }
+
+        static bool eq_keys(column_table const & t1, unsigned r1, unsigned_vector const & cols1,
+                            column_table const & t2, unsigned r2, unsigned_vector const & cols2) {
+            for (unsigned i = 0; i < cols1.size(); ++i)
+                if (t1.m_columns[cols1[i]][r1] != t2.m_columns[cols2[i]][r2])
+                    return false;
+            return true;
+        }
+
+        static void gather(column_table const & src, unsigned_vector const & rows, column_table & dst, unsigned offset) {
+            unsigned n = rows.size();
+            for (unsigned c = 0; c < src.num_cols(); ++c) {
+                table_element const * s = src.m_columns[c].c_ptr();
+                table_element * d = dst.m_columns[c + offset].c_ptr();
+                for (unsigned i = 0; i < n; ++i)
+                    d[i] = s[rows[i]];
+            }
+        }
+
+        /**
+           \brief Collect the matches of probe row r.
+           Only reads shared state, so that rows can be probed concurrently.
+        */
+        void probe_row(column_table const & build, unsigned_vector const & build_cols,
+                       column_table const & probe, unsigned_vector const & probe_cols,
+                       u_map<unsigned> const & heads, unsigned r,
+                       unsigned_vector & build_rows, unsigned_vector & probe_rows) const {
+            unsigned b;
+            if (!heads.find(m_hashes[r], b))
+                return;
+            for (; b != UINT_MAX; b = m_next[b]) {
+                if (eq_keys(build, b, build_cols, probe, r, probe_cols)) {
+                    build_rows.push_back(b);
+                    probe_rows.push_back(r);
+                }
+            }
+        }
+
+        unsigned m_num_threads;
+        unsigned m_min_rows_per_thread;
+
+    public:
+        join_fn(const table_signature & t1_sig, const table_signature & t2_sig,
+                unsigned col_cnt, const unsigned * cols1, const unsigned * cols2, unsigned num_threads)
+            : convenient_table_join_fn(t1_sig, t2_sig, col_cnt, cols1, cols2),
+              m_num_threads(std::max(1u, num_threads)),
+              m_min_rows_per_thread(4096) {}
+
+        table_base * operator()(const table_base & _t1, const table_base & _t2) override {
+            column_table const & t1 = get(_t1);
+            column_table const & t2 = get(_t2);
+            bool build_first = t1.m_num_rows <= t2.m_num_rows;
+            column_table const & build = build_first ? t1 : t2;
+            column_table const & probe = build_first ? t2 : t1;
+            unsigned_vector const & build_cols = build_first ? m_cols1 : m_cols2;
+            unsigned_vector const & probe_cols = build_first ? m_cols2 : m_cols1;
+            unsigned_vector & build_rows = build_first ? m_rows1 : m_rows2;
+            unsigned_vector & probe_rows = build_first ? m_rows2 : m_rows1;
+            m_rows1.reset();
+            m_rows2.reset();
+
+            hash_keys(build, build_cols);
+            u_map<unsigned> heads;
+            m_next.reset();
+            m_next.resize(build.m_num_rows, UINT_MAX);
+            for (unsigned r = 0; r < build.m_num_rows; ++r) {
+                unsigned h = m_hashes[r];
+                unsigned prev;
+                if (heads.find(h, prev))
+                    m_next[r] = prev;
+                heads.insert(h, r);
+            }
+
+            hash_keys(probe, probe_cols);
+            thread_pool & pool = thread_pool::get();
+            // the calling thread executes tasks of the group while it waits
+            unsigned num_threads = std::min(m_num_threads, pool.num_workers() + 1);
+            num_threads = std::min(num_threads, probe.m_num_rows / m_min_rows_per_thread);
+            if (num_threads <= 1 || thread_pool::in_parallel()) {
+                for (unsigned r = 0; r < probe.m_num_rows; ++r)
+                    probe_row(build, build_cols, probe, probe_cols, heads, r, build_rows, probe_rows);
+            }
+            else {
+                // the probe rows are partitioned by the hash of their keys,
+                // every task collects the matches of its partition separately,
+                // and the matches are appended in the order of the partitions.
+                vector<unsigned_vector> parts(num_threads);
+                for (unsigned r = 0; r < probe.m_num_rows; ++r)
+                    parts[m_hashes[r] % num_threads].push_back(r);
+                vector<unsigned_vector> part_build_rows(num_threads), part_probe_rows(num_threads);
+                thread_pool::task_group tasks(pool);
+                for (unsigned i = 0; i < num_threads; ++i) {
+                    tasks.add([&, i]() {
+                        for (unsigned r : parts[i])
+                            probe_row(build, build_cols, probe, probe_cols, heads, r,
+                                      part_build_rows[i], part_probe_rows[i]);
+                    });
+                }
+                tasks.wait();
+                for (unsigned i = 0; i < num_threads; ++i) {
+                    build_rows.append(part_build_rows[i]);
+                    probe_rows.append(part_probe_rows[i]);
+                }
+            }
+
+            column_table * res = get(t1.get_plugin().mk_empty(get_result_signature()));
+            res->resize_rows(m_rows1.size());
+            gather(t1, m_rows1, *res, 0);
+            gather(t2, m_rows2, *res, t1.num_cols());
+            res->rebuild_index(m_rows1.size());
+            return res;
+        }
+    };
+
+    table_join_fn * column_table_plugin::mk_join_fn(const table_base & t1, const table_base & t2,
+            unsigned col_cnt, const unsigned * cols1, const unsigned * cols2) {
+        if (t1.get_kind() != get_kind() || t2.get_kind() != get_kind()) {
+            return nullptr;
+        }
+        return alloc(join_fn, t1.get_signature(), t2.get_signature(), col_cnt, cols1, cols2,
+                     get_context().join_threads());
+    }
+
+    class column_table_plugin::project_fn : public convenient_table_project_fn {
+    public:
+        project_fn(const table_signature & orig_sig, unsigned removed_col_cnt, const unsigned * removed_cols)
+            : convenient_table_project_fn(orig_sig, removed_col_cnt, removed_cols) {}
+
+        table_base * operator()(const table_base & _t) override {
+            column_table const & t = get(_t);
+            column_table * res = get(t.get_plugin().mk_empty(get_result_signature()));
+            unsigned r_idx = 0, tgt_i = 0;
+            for (unsigned i = 0; i < t.num_cols(); ++i) {
+                if (r_idx < m_removed_cols.size() && i == m_removed_cols[r_idx]) {
+                    ++r_idx;
+                    continue;
+                }
+                res->m_columns[tgt_i++] = t.m_columns[i];
+            }
+            SASSERT(tgt_i == res->num_cols());
+            res->rebuild_index(t.m_num_rows);
+            return res;
+        }
+    };
+
+    table_transformer_fn * column_table_plugin::mk_project_fn(const table_base & t, unsigned col_cnt,
+            const unsigned * removed_cols) {
+        if (t.get_kind() != get_kind() || col_cnt == t.get_signature().size()) {
+            return nullptr;
+        }
+        return alloc(project_fn, t.get_signature(), col_cnt, removed_cols);
+    }
+
+    class column_table_plugin::union_fn : public table_union_fn {
+        table_fact m_fact;
+    public:
+        void operator()(table_base & _tgt, const table_base & _src, table_base * delta) override {
+            column_table & tgt = get(_tgt);
+            column_table const & src = get(_src);
+            unsigned n = src.num_cols();
+            for (unsigned r = 0; r < src.m_num_rows; ++r) {
+                unsigned s = tgt.m_num_rows;
+                for (unsigned i = 0; i < n; ++i)
+                    tgt.m_columns[i][s] = src.m_columns[i][r];
+                if (tgt.m_index.insert_if_not_there(s) != s)
+                    continue;
+                for (column_table::column & c : tgt.m_columns)
+                    c.push_back(0);
+                ++tgt.m_num_rows;
+                if (delta) {
+                    m_fact.reset();
+                    for (unsigned i = 0; i < n; ++i)
+                        m_fact.push_back(src.m_columns[i][r]);
+                    delta->add_fact(m_fact);
+                }
+            }
+        }
+    };
+
+    table_union_fn * column_table_plugin::mk_union_fn(const table_base & tgt, const table_base & src,
+            const table_base * delta) {
+        if (tgt.get_kind() != get_kind() || src.get_kind() != get_kind() ||
+            (delta && delta->get_kind() != get_kind()) ||
+            tgt.get_signature() != src.get_signature() ||
+            (delta && delta->get_signature() != tgt.get_signature())) {
+            return nullptr;
+        }
+        return alloc(union_fn);
+    }
+
+    class column_table_plugin::filter_equal_fn : public table_mutator_fn {
+        table_element   m_value;
+        unsigned        m_col;
+        unsigned_vector m_rows;
+    public:
+        filter_equal_fn(const table_element & value, unsigned col) : m_value(value), m_col(col) {}
+
+        void operator()(table_base & _t) override {
+            column_table & t = get(_t);
+            unsigned n = t.m_num_rows;
+            table_element const * data = t.m_columns[m_col].c_ptr();
+            table_element v = m_value;
+            m_rows.reset();
+            m_rows.resize(n);
+            unsigned * rows = m_rows.c_ptr();
+            unsigned k = 0;
+            // branch free selection loop
+            for (unsigned r = 0; r < n; ++r) {
+                rows[k] = r;
+                k += (data[r] == v);
+            }
+            m_rows.shrink(k);
+            t.compact(m_rows);
+        }
+    };
+
+    table_mutator_fn * column_table_plugin::mk_filter_equal_fn(const table_base & t, const table_element & value,
+            unsigned col) {
+        if (t.get_kind() != get_kind()) {
+            return nullptr;
+        }
+        return alloc(filter_equal_fn, value, col);
+    }
+
+    class column_table_plugin::filter_identical_fn : public table_mutator_fn {
+        unsigned_vector m_cols;
+        unsigned_vector m_rows;
+    public:
+        filter_identical_fn(unsigned col_cnt, const unsigned * identical_cols) : m_cols(col_cnt, identical_cols) {}
+
+        void operator()(table_base & _t) override {
+            column_table & t = get(_t);
+            unsigned n = t.m_num_rows;
+            m_rows.reset();
+            for (unsigned r = 0; r < n; ++r)
+                m_rows.push_back(r);
+            table_element const * first = t.m_columns[m_cols[0]].c_ptr();
+            for (unsigned i = 1; i < m_cols.size(); ++i) {
+                table_element const * data = t.m_columns[m_cols[i]].c_ptr();
+                unsigned * rows = m_rows.c_ptr();
+                unsigned k = 0;
+                for (unsigned j = 0; j < m_rows.size(); ++j) {
+                    unsigned r = rows[j];
+                    rows[k] = r;
+                    k += (data[r] == first[r]);
+                }
+                m_rows.shrink(k);
+            }
+            t.compact(m_rows);
+        }
+    };
+
+    table_mutator_fn * column_table_plugin::mk_filter_identical_fn(const table_base & t, unsigned col_cnt,
+            const unsigned * identical_cols) {
+        if (t.get_kind() != get_kind() || col_cnt < 2) {
+            return nullptr;
+        }
+        return alloc(filter_identical_fn, col_cnt, identical_cols);
+    }
+
+};
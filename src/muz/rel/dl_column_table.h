@@ -0,0 +1,147 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    dl_column_table.h
+
+Abstract:
+
+    Table stored column-wise.
+
+    Every column is a contiguous array of table elements, so that selections,
+    projections and the build and probe phases of joins are tight loops over
+    arrays instead of row by row accesses to packed records.
+    A hash index over row positions keeps the rows unique.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#ifndef DL_COLUMN_TABLE_H_
+#define DL_COLUMN_TABLE_H_
+
+#include "util/hashtable.h"
+#include "util/vector.h"
+#include "muz/rel/dl_base.h"
+
+namespace datalog {
+
+    class column_table;
+
+    class column_table_plugin : public table_plugin {
+        friend class column_table;
+        class join_fn;
+        class project_fn;
+        class filter_equal_fn;
+        class filter_identical_fn;
+        class union_fn;
+
+        static column_table const & get(table_base const & t);
+        static column_table & get(table_base & t);
+        static column_table * get(table_base * t);
+    public:
+        typedef column_table table;
+
+        column_table_plugin(relation_manager & manager)
+            : table_plugin(symbol("column"), manager) {}
+
+        bool can_handle_signature(const table_signature & s) override {
+            return !s.empty() && s.functional_columns() == 0;
+        }
+
+        table_base * mk_empty(const table_signature & s) override;
+
+    protected:
+        table_join_fn * mk_join_fn(const table_base & t1, const table_base & t2,
+            unsigned col_cnt, const unsigned * cols1, const unsigned * cols2) override;
+        table_transformer_fn * mk_project_fn(const table_base & t, unsigned col_cnt,
+            const unsigned * removed_cols) override;
+        table_union_fn * mk_union_fn(const table_base & tgt, const table_base & src,
+            const table_base * delta) override;
+        table_mutator_fn * mk_filter_identical_fn(const table_base & t, unsigned col_cnt,
+            const unsigned * identical_cols) override;
+        table_mutator_fn * mk_filter_equal_fn(const table_base & t, const table_element & value,
+            unsigned col) override;
+    };
+
+    class column_table : public table_base {
+        friend class column_table_plugin;
+        friend class column_table_plugin::join_fn;
+        friend class column_table_plugin::project_fn;
+        friend class column_table_plugin::filter_equal_fn;
+        friend class column_table_plugin::filter_identical_fn;
+        friend class column_table_plugin::union_fn;
+
+        typedef svector<table_element> column;
+
+        class row_hash_proc {
+            column_table const & m_table;
+        public:
+            row_hash_proc(column_table const & t): m_table(t) {}
+            unsigned operator()(unsigned r) const { return m_table.hash_row(r); }
+        };
+
+        class row_eq_proc {
+            column_table const & m_table;
+        public:
+            row_eq_proc(column_table const & t): m_table(t) {}
+            bool operator()(unsigned r1, unsigned r2) const { return m_table.eq_rows(r1, r2); }
+        };
+
+        typedef hashtable<unsigned, row_hash_proc, row_eq_proc> row_index;
+
+        class our_iterator_core;
+
+        /**
+           Invariant: every column has m_num_rows + 1 elements. The last position is
+           a scratch row used to look up facts that are not (yet) in the table.
+        */
+        mutable vector<column> m_columns;
+        unsigned               m_num_rows;
+        row_index              m_index;
+
+        column_table(column_table_plugin & plugin, const table_signature & sig);
+
+        unsigned num_cols() const { return m_columns.size(); }
+        unsigned hash_row(unsigned r) const;
+        bool eq_rows(unsigned r1, unsigned r2) const;
+        void set_scratch(const table_element * f) const;
+        void copy_row(unsigned src, unsigned dst);
+        void resize_rows(unsigned n);
+        /**
+           \brief Index the first n rows, dropping the duplicates among them.
+           Operations that fill the columns directly call it to restore the invariant.
+        */
+        void rebuild_index(unsigned n);
+        /**
+           \brief Keep only the rows whose positions are listed (in increasing order) in \c rows.
+        */
+        void compact(unsigned_vector const & rows);
+    public:
+        column_table_plugin & get_plugin() const {
+            return static_cast<column_table_plugin &>(table_base::get_plugin());
+        }
+
+        void add_fact(const table_fact & f) override;
+        void remove_fact(const table_element * fact) override;
+        bool contains_fact(const table_fact & f) const override;
+        void reset() override;
+        table_base * clone() const override;
+        bool empty() const override { return m_num_rows == 0; }
+
+        iterator begin() const override;
+        iterator end() const override;
+
+        unsigned get_size_estimate_rows() const override { return m_num_rows; }
+        unsigned get_size_estimate_bytes() const override { return m_num_rows * num_cols() * sizeof(table_element); }
+        bool knows_exact_size() const override { return true; }
+    };
+
+};
+
+#endif /* DL_COLUMN_TABLE_H_ */
@@ -36,7 +36,7 @@ namespace datalog {
         m_pred_regs.reset();
     }
 
-    void compiler::ensure_predicate_loaded(func_decl * pred, instruction_block & acc) {
+    void compiler::ensure_predicate_loaded(func_decl * pred, instruction_block & acc, bool take) {
         pred2idx::obj_map_entry * e = m_pred_regs.insert_if_not_there2(pred, UINT_MAX);
         if(e->get_data().m_value!=UINT_MAX) {
             //predicate is already loaded
@@ -47,7 +47,12 @@ namespace datalog {
         reg_idx reg = get_fresh_register(sig);
         e->get_data().m_value=reg;
 
-        acc.push_back(instruction::mk_load(m_context.get_manager(), pred, reg));
+        if (take) {
+            acc.push_back(instruction::mk_take(m_context.get_manager(), pred, reg));
+        }
+        else {
+            acc.push_back(instruction::mk_load(m_context.get_manager(), pred, reg));
+        }
     }
 
     void compiler::make_join(reg_idx t1, reg_idx t2, const variable_intersection & vars, reg_idx & result, 
@@ -59,6 +64,110 @@ namespace datalog {
         acc.push_back(instruction::mk_join(t1, t2, vars.size(), vars.get_cols1(), vars.get_cols2(), result));
     }
 
+    /**
+       \brief Join the positive tails of \c r with a multi-way join. Constant arguments are
+       selected first, and the result has one column per variable in the order of their
+       first occurrence. The variables of these columns are stored in \c result_expr.
+    */
+    void compiler::make_join_multi(rule * r, const reg_idx * tail_regs, reg_idx & result,
+            expr_ref_vector & result_expr, instruction_block & acc) {
+        unsigned pt_len = r->get_positive_tail_size();
+        svector<reg_idx> tails;
+        vector<unsigned_vector> cols;
+        relation_signature res_sig;
+        u_map<unsigned> var2col;
+        for (unsigned i = 0; i < pt_len; ++i) {
+            app * a = r->get_tail(i);
+            reg_idx t = tail_regs[i];
+            bool dealloc = false;
+            unsigned_vector tail_cols;
+            for (expr * arg : *a) {
+                if (is_app(arg)) {
+                    SASSERT(m_context.get_manager().is_value(arg));
+                    make_select_equal_and_project(t, to_app(arg), tail_cols.size(), t, dealloc, acc);
+                    dealloc = true;
+                    continue;
+                }
+                unsigned v = to_var(arg)->get_idx();
+                unsigned col;
+                if (!var2col.find(v, col)) {
+                    col = res_sig.size();
+                    var2col.insert(v, col);
+                    res_sig.push_back(m_reg_signatures[t][tail_cols.size()]);
+                    result_expr.push_back(arg);
+                }
+                tail_cols.push_back(col);
+            }
+            tails.push_back(t);
+            cols.push_back(tail_cols);
+        }
+        result = get_fresh_register(res_sig);
+        acc.push_back(instruction::mk_join_multi(tails.size(), tails.c_ptr(), cols, result));
+        for (unsigned i = 0; i < pt_len; ++i) {
+            if (tails[i] != tail_regs[i])
+                make_dealloc_non_void(tails[i], acc);
+        }
+    }
+
+    /**
+       \brief Join the positive tails of \c r from left to right with binary joins. Constant arguments
+       are selected first, and the columns of a tail whose variables occur in the previous tails are
+       projected away by the join. The variables of the columns of the result are stored in \c result_expr;
+       a variable that occurs several times in the first tail where it occurs keeps a column per occurrence.
+    */
+    void compiler::make_join_chain(rule * r, const reg_idx * tail_regs, reg_idx & result,
+            expr_ref_vector & result_expr, instruction_block & acc) {
+        ast_manager & m = m_context.get_manager();
+        unsigned pt_len = r->get_positive_tail_size();
+        bool dealloc = false;
+        for (unsigned i = 0; i < pt_len; ++i) {
+            app * a = r->get_tail(i);
+            reg_idx t = tail_regs[i];
+            bool t_dealloc = false;
+            expr_ref_vector t_expr(m);
+            for (expr * arg : *a) {
+                if (is_app(arg)) {
+                    SASSERT(m.is_value(arg));
+                    make_select_equal_and_project(t, to_app(arg), t_expr.size(), t, t_dealloc, acc);
+                    t_dealloc = true;
+                }
+                else {
+                    t_expr.push_back(arg);
+                }
+            }
+            if (i == 0) {
+                result = t;
+                dealloc = t_dealloc;
+                result_expr.append(t_expr);
+                continue;
+            }
+            variable_intersection vars(m);
+            vars.populate(result_expr, t_expr);
+            // the columns of the tail that are equal to columns of the previous tails
+            unsigned_vector joined_cols(vars.size(), vars.get_cols2());
+            unsigned_vector removed_cols;
+            unsigned ofs = result_expr.size();
+            for (unsigned j = 0; j < t_expr.size(); ++j) {
+                if (joined_cols.contains(j))
+                    removed_cols.push_back(ofs + j);
+                else
+                    result_expr.push_back(t_expr.get(j));
+            }
+            reg_idx joined;
+            if (removed_cols.empty())
+                make_join(result, t, vars, joined, false, acc);
+            else
+                make_join_project(result, t, vars, removed_cols, joined, false, acc);
+            if (dealloc)
+                make_dealloc_non_void(result, acc);
+            if (t_dealloc)
+                make_dealloc_non_void(t, acc);
+            result = joined;
+            dealloc = true;
+        }
+        SASSERT(dealloc);
+    }
+
     void compiler::make_join_project(reg_idx t1, reg_idx t2, const variable_intersection & vars, 
             const unsigned_vector & removed_cols, reg_idx & result, bool reuse_t1, instruction_block & acc) {
         relation_signature aux_sig;
@@ -459,7 +568,10 @@ namespace datalog {
         TRACE("dl", r->display(m_context, tout); );
 
         unsigned pt_len = r->get_positive_tail_size();
-        SASSERT(pt_len<=2); //we require rules to be processed by the mk_simple_joins rule transformer plugin
+        //we require rules to be processed by the mk_simple_joins rule transformer plugin,
+        //which leaves more than two positive tails only for multi-way joins. Incremental 
+        //updates compile the rules as they are given.
+        SASSERT(pt_len<=2 || m_context.multiway_join() || m_context.incremental());
 
         reg_idx single_res;
         expr_ref_vector single_res_expr(m);
@@ -471,7 +583,13 @@ namespace datalog {
         // whether to dealloc the previous result
         bool dealloc = true;
 
-        if(pt_len == 2) {
+        if (pt_len > 2 && m_context.multiway_join()) {
+            make_join_multi(r, tail_regs, single_res, single_res_expr, acc);
+        }
+        else if (pt_len > 2) {
+            make_join_chain(r, tail_regs, single_res, single_res_expr, acc);
+        }
+        else if(pt_len == 2) {
             reg_idx t1_reg=tail_regs[0];
             reg_idx t2_reg=tail_regs[1];
             app * a1 = r->get_tail(0);
@@ -1290,6 +1408,271 @@ namespace datalog {
         }
     }
 
+    void compiler::collect_dependent_preds(func_decl_set & preds) const {
+        bool change = true;
+        while (change) {
+            change = false;
+            for (rule * r : m_rule_set) {
+                func_decl * head = r->get_decl();
+                if (preds.contains(head)) {
+                    continue;
+                }
+                for (unsigned i = 0; i < r->get_uninterpreted_tail_size(); ++i) {
+                    if (preds.contains(r->get_decl(i))) {
+                        preds.insert(head);
+                        change = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    void compiler::compile_rule_update(rule * r, reg_idx head_reg, const pred2idx & deltas, 
+            reg_idx delta_reg, instruction_block & acc) {
+        unsigned pt_len = r->get_positive_tail_size();
+        unsigned ut_len = r->get_uninterpreted_tail_size();
+        svector<reg_idx> tail_regs;
+        for (unsigned j = 0; j < ut_len; ++j) {
+            tail_regs.push_back(m_pred_regs.find(r->get_decl(j)));
+        }
+        for (unsigned j = 0; j < pt_len; ++j) {
+            reg_idx tail_delta;
+            if (deltas.find(r->get_decl(j), tail_delta)) {
+                flet<reg_idx> _tail_reg(tail_regs[j], tail_delta);
+                compile_rule_evaluation_run(r, head_reg, tail_regs.c_ptr(), delta_reg, false, acc);
+            }
+        }
+    }
+
+    void compiler::compile_rederivation(rule * r, func_decl * deleted, reg_idx delta_reg, instruction_block & acc) {
+        ast_manager & m = m_context.get_manager();
+        rule_manager & rm = m_context.get_rule_manager();
+        app * head = r->get_head();
+        app_ref deleted_head(m.mk_app(deleted, head->get_num_args(), head->get_args()), m);
+        ptr_vector<app> tail;
+        svector<bool> neg;
+        tail.push_back(deleted_head);
+        neg.push_back(false);
+        for (unsigned i = 0; i < r->get_tail_size(); ++i) {
+            tail.push_back(r->get_tail(i));
+            neg.push_back(r->is_neg_tail(i));
+        }
+        rule_ref nr(rm.mk(head, tail.size(), tail.c_ptr(), neg.c_ptr(), r->name(), false), rm);
+        nr->set_accounting_parent_object(m_context, r);
+        svector<reg_idx> tail_regs;
+        for (unsigned j = 0; j < nr->get_uninterpreted_tail_size(); ++j) {
+            tail_regs.push_back(m_pred_regs.find(nr->get_decl(j)));
+        }
+        compile_rule_evaluation_run(nr, m_pred_regs.find(head->get_decl()), tail_regs.c_ptr(), delta_reg, false, acc);
+    }
+
+    void compiler::compile_stratum_update(const func_decl_vector & heads, bool over_delete, pred2idx & deltas,
+            const pred2pred * deleted, instruction_block & acc) {
+        pred2idx lower_deltas(deltas);
+        pred2idx src, tgt;
+        svector<reg_idx> loop_control_regs;
+        bool recursive = false;
+        for (func_decl * p : heads) {
+            lower_deltas.remove(p);
+            relation_signature sig = m_reg_signatures[m_pred_regs.find(p)];
+            if (!deltas.contains(p)) {
+                deltas.insert(p, get_fresh_register(sig));
+            }
+            //the facts already in deltas still have to be propagated within the stratum
+            reg_idx src_reg = get_fresh_register(sig);
+            acc.push_back(instruction::mk_clone(deltas.find(p), src_reg));
+            src.insert(p, src_reg);
+            tgt.insert(p, get_fresh_register(sig));
+            loop_control_regs.push_back(src_reg);
+            for (rule * r : m_rule_set.get_predicate_rules(p)) {
+                for (unsigned i = 0; !recursive && i < r->get_positive_tail_size(); ++i) {
+                    recursive = heads.contains(r->get_decl(i));
+                }
+            }
+        }
+
+        for (func_decl * p : heads) {
+            reg_idx head_reg = over_delete ? deltas.find(p) : m_pred_regs.find(p);
+            func_decl * deleted_p = nullptr;
+            for (rule * r : m_rule_set.get_predicate_rules(p)) {
+                if (deleted && deleted->find(p, deleted_p)) {
+                    compile_rederivation(r, deleted_p, src.find(p), acc);
+                }
+                compile_rule_update(r, head_reg, lower_deltas, src.find(p), acc);
+            }
+            if (!over_delete) {
+                make_union(src.find(p), deltas.find(p), execution_context::void_register, false, acc);
+            }
+        }
+
+        if (recursive) {
+            instruction_block * loop_body = alloc(instruction_block);
+            loop_body->set_observer(&m_instruction_observer);
+            for (func_decl * p : heads) {
+                reg_idx head_reg = over_delete ? deltas.find(p) : m_pred_regs.find(p);
+                for (rule * r : m_rule_set.get_predicate_rules(p)) {
+                    compile_rule_update(r, head_reg, src, tgt.find(p), *loop_body);
+                }
+            }
+            for (func_decl * p : heads) {
+                if (!over_delete) {
+                    make_union(tgt.find(p), deltas.find(p), execution_context::void_register, false, *loop_body);
+                }
+                loop_body->push_back(instruction::mk_move(tgt.find(p), src.find(p)));
+            }
+            loop_body->set_observer(nullptr);
+            acc.push_back(instruction::mk_while_loop(loop_control_regs.size(), 
+                loop_control_regs.c_ptr(), loop_body));
+        }
+
+        for (func_decl * p : heads) {
+            make_dealloc_non_void(src.find(p), acc);
+        }
+    }
+
+    bool compiler::do_update_compilation(const pred2pred & inserted, const pred2pred & retracted,
+            const pred2pred & base, pred2pred & deleted, func_decl_ref_vector & pinned,
+            instruction_block & execution_code, instruction_block & termination_code) {
+        ast_manager & m = m_context.get_manager();
+
+        func_decl_set affected, over_deleted;
+        for (auto const & kv : inserted) {
+            affected.insert(kv.m_key);
+        }
+        for (auto const & kv : retracted) {
+            affected.insert(kv.m_key);
+            over_deleted.insert(kv.m_key);
+        }
+        collect_dependent_preds(affected);
+        collect_dependent_preds(over_deleted);
+
+        //a change that reaches a negated tail can remove facts when facts are added and
+        //the other way around
+        for (rule * r : m_rule_set) {
+            if (!affected.contains(r->get_decl())) {
+                continue;
+            }
+            for (unsigned i = r->get_positive_tail_size(); i < r->get_uninterpreted_tail_size(); ++i) {
+                if (affected.contains(r->get_decl(i))) {
+                    return false;
+                }
+            }
+        }
+
+        instruction_block & acc = execution_code;
+        acc.set_observer(&m_instruction_observer);
+
+        //move the relations that take part in the update into registers
+        for (func_decl * p : affected) {
+            ensure_predicate_loaded(p, acc, true);
+            for (rule * r : m_rule_set.get_predicate_rules(p)) {
+                for (unsigned i = 0; i < r->get_uninterpreted_tail_size(); ++i) {
+                    ensure_predicate_loaded(r->get_decl(i), acc, true);
+                }
+            }
+        }
+        for (auto const & kv : m_pred_regs) {
+            termination_code.push_back(instruction::mk_store(m, kv.m_key, kv.m_value));
+        }
+
+        rule_set::pred_set_vector const & strats = m_rule_set.get_stratifier().get_strats();
+
+        //over-delete: collect every fact with a derivation that uses a retracted fact
+        pred2idx deleted_regs;
+        pred2pred deleted_preds;
+        for (auto const & kv : retracted) {
+            relation_signature sig = m_reg_signatures[m_pred_regs.find(kv.m_key)];
+            reg_idx reg = get_fresh_register(sig);
+            acc.push_back(instruction::mk_load(m, kv.m_value, reg));
+            deleted_regs.insert(kv.m_key, reg);
+        }
+        if (!retracted.empty()) {
+            for (func_decl_set * strat : strats) {
+                func_decl_vector heads;
+                for (func_decl * p : *strat) {
+                    if (over_deleted.contains(p) && !m_rule_set.get_predicate_rules(p).empty()) {
+                        heads.push_back(p);
+                    }
+                }
+                if (!heads.empty()) {
+                    compile_stratum_update(heads, true, deleted_regs, nullptr, acc);
+                }
+            }
+            for (auto const & kv : deleted_regs) {
+                func_decl * p = kv.m_key;
+                unsigned_vector cols;
+                for (unsigned i = 0; i < p->get_arity(); ++i) {
+                    cols.push_back(i);
+                }
+                acc.push_back(instruction::mk_filter_by_negation(m_pred_regs.find(p), kv.m_value, 
+                    cols.size(), cols.c_ptr(), cols.c_ptr()));
+                //the predicate of the deleted facts is created once and reused by later updates,
+                //it is registered again because a query restores the predicates of the context
+                func_decl * d = nullptr;
+                if (!deleted.find(p, d)) {
+                    d = m.mk_fresh_func_decl(p->get_name(), symbol("deleted"), p->get_arity(), 
+                        p->get_domain(), m.mk_bool_sort());
+                    pinned.push_back(d);
+                    deleted.insert(p, d);
+                }
+                m_context.register_predicate(d, false);
+                m_pred_regs.insert(d, kv.m_value);
+                deleted_preds.insert(p, d);
+            }
+        }
+
+        //the added facts, and the deleted facts that were given directly, are new facts
+        pred2idx new_regs;
+        for (auto const & kv : inserted) {
+            relation_signature sig = m_reg_signatures[m_pred_regs.find(kv.m_key)];
+            reg_idx reg = get_fresh_register(sig);
+            reg_idx new_reg = get_fresh_register(sig);
+            acc.push_back(instruction::mk_load(m, kv.m_value, reg));
+            make_union(reg, m_pred_regs.find(kv.m_key), new_reg, false, acc);
+            make_dealloc_non_void(reg, acc);
+            new_regs.insert(kv.m_key, new_reg);
+        }
+        for (auto const & kv : deleted_regs) {
+            func_decl * base_p = nullptr;
+            if (!base.find(kv.m_key, base_p)) {
+                continue;
+            }
+            relation_signature sig = m_reg_signatures[m_pred_regs.find(kv.m_key)];
+            reg_idx reg = get_fresh_register(sig);
+            if (!new_regs.contains(kv.m_key)) {
+                new_regs.insert(kv.m_key, get_fresh_register(sig));
+            }
+            acc.push_back(instruction::mk_load(m, base_p, reg));
+            make_union(reg, m_pred_regs.find(kv.m_key), new_regs.find(kv.m_key), false, acc);
+            make_dealloc_non_void(reg, acc);
+        }
+
+        //re-derive and propagate the new facts
+        for (func_decl_set * strat : strats) {
+            func_decl_vector heads;
+            for (func_decl * p : *strat) {
+                if (affected.contains(p) && !m_rule_set.get_predicate_rules(p).empty()) {
+                    heads.push_back(p);
+                }
+            }
+            if (!heads.empty()) {
+                compile_stratum_update(heads, false, new_regs, &deleted_preds, acc);
+            }
+        }
+
+        for (auto const & kv : deleted_regs) {
+            make_dealloc_non_void(kv.m_value, acc);
+        }
+        for (auto const & kv : new_regs) {
+            make_dealloc_non_void(kv.m_value, acc);
+        }
+        acc.set_observer(nullptr);
+
+        TRACE("dl", execution_code.display(execution_context(m_context), tout););
+        return true;
+    }
+
     void compiler::do_compilation(instruction_block & execution_code, 
             instruction_block & termination_code) {
 
@@ -147,6 +147,10 @@ namespace datalog {
 
         void make_join(reg_idx t1, reg_idx t2, const variable_intersection & vars, reg_idx & result, 
             bool reuse_t1, instruction_block & acc);
+        void make_join_multi(rule * r, const reg_idx * tail_regs, reg_idx & result,
+            expr_ref_vector & result_expr, instruction_block & acc);
+        void make_join_chain(rule * r, const reg_idx * tail_regs, reg_idx & result,
+            expr_ref_vector & result_expr, instruction_block & acc);
         void make_min(reg_idx source, reg_idx & target, const unsigned_vector & group_by_cols,
             unsigned min_col, instruction_block & acc);
         void make_join_project(reg_idx t1, reg_idx t2, const variable_intersection & vars, 
@@ -190,7 +194,11 @@ namespace datalog {
         
         void make_duplicate_column(reg_idx src, unsigned col, reg_idx & result, bool reuse, instruction_block & acc);
         
-        void ensure_predicate_loaded(func_decl * pred, instruction_block & acc);
+        /**
+           \brief Allocate a register for \c pred and load its relation. If \c take is true, the
+           relation is moved out of the relation manager instead of copied.
+        */
+        void ensure_predicate_loaded(func_decl * pred, instruction_block & acc, bool take = false);
 
         /**
            \brief For rule \c r with two positive uninterpreted predicates put into \c res indexes of 
@@ -255,6 +263,36 @@ namespace datalog {
 
         bool all_saturated(const func_decl_set & preds) const;
 
+        /**
+           \brief Extend \c preds by the heads of the rules that depend on them.
+        */
+        void collect_dependent_preds(func_decl_set & preds) const;
+
+        /**
+           \brief Into \c acc add the evaluations of \c r with one positive tail replaced by its
+           delta in \c deltas. The results are added to \c head_reg and the new ones to \c delta_reg.
+        */
+        void compile_rule_update(rule * r, reg_idx head_reg, const pred2idx & deltas, reg_idx delta_reg,
+            instruction_block & acc);
+
+        /**
+           \brief Into \c acc add the evaluation of \c r restricted to the head facts in the relation
+           of \c deleted, i.e., of the deleted facts that can still be derived using \c r.
+        */
+        void compile_rederivation(rule * r, func_decl * deleted, reg_idx delta_reg, instruction_block & acc);
+
+        /**
+           \brief Propagate \c deltas through the rules of the stratum \c heads.
+
+           On entry \c deltas[p] contains facts already added to the predicates p of the stratum. On
+           exit it also contains the facts that were derived for them. If \c over_delete is true, the
+           derived facts are collected only in \c deltas, and the rules are evaluated against the
+           relations before the change. Otherwise they are added to the relations of \c heads, and
+           the facts in \c deleted[p] are re-derived from the remaining facts first.
+        */
+        void compile_stratum_update(const func_decl_vector & heads, bool over_delete, pred2idx & deltas,
+            const obj_map<func_decl, func_decl*> * deleted, instruction_block & acc);
+
         void reset();
 
         explicit compiler(context & ctx, rule_set const & rules, instruction_block & top_level_code) 
@@ -271,6 +309,14 @@ namespace datalog {
         void do_compilation(instruction_block & execution_code, 
             instruction_block & termination_code);
 
+    public:
+        typedef obj_map<func_decl, func_decl*> pred2pred;
+
+    private:
+        bool do_update_compilation(const pred2pred & inserted, const pred2pred & retracted,
+            const pred2pred & base, pred2pred & deleted, func_decl_ref_vector & pinned,
+            instruction_block & execution_code, instruction_block & termination_code);
+
     public:
 
         static void compile(context & ctx, rule_set const & rules, instruction_block & execution_code, 
@@ -279,6 +325,30 @@ namespace datalog {
                 .do_compilation(execution_code, termination_code);
         }
 
+        /**
+           \brief Compile code that updates the relations of the predicates of \c rules, which
+           hold the fixpoint of \c rules, after the facts in the relation of \c inserted[p] were
+           added to and the facts in the relation of \c retracted[p] were removed from the
+           predicate p. The relation of \c base[p] holds the facts that were given directly for
+           a predicate p that has rules; they remain when their derivations are gone.
+
+           Insertions are propagated semi-naively from their deltas. Retractions delete the
+           facts with a derivation that uses a retracted fact, and then re-derive the deleted
+           facts that still follow from the remaining ones (DRed). The re-derivation refers to the
+           deleted facts of a predicate p through the predicate \c deleted[p]. Missing entries are
+           added to \c deleted and \c pinned, so that later updates reuse them.
+
+           Return false if the change reaches a negated tail. Such changes need a full evaluation.
+        */
+        static bool compile_update(context & ctx, rule_set const & rules, const pred2pred & inserted,
+                const pred2pred & retracted, const pred2pred & base, pred2pred & deleted,
+                func_decl_ref_vector & pinned, instruction_block & execution_code,
+                instruction_block & termination_code) {
+            return compiler(ctx, rules, execution_code)
+                .do_update_compilation(inserted, retracted, base, deleted, pinned, execution_code,
+                                       termination_code);
+        }
+
     };
 
 
@@ -23,6 +23,8 @@ Revision History:
 #include "muz/base/dl_util.h"
 #include "muz/rel/dl_instruction.h"
 #include "muz/rel/rel_context.h"
+#include "muz/rel/dl_table_relation.h"
+#include "muz/rel/dl_leapfrog_join.h"
 #include "util/debug.h"
 #include "util/warning.h"
 
@@ -134,6 +136,7 @@ namespace datalog {
         st.update("dl.filter_by_negation", m_stats.m_filter_by_negation);
         st.update("dl.select_equal_project", m_stats.m_select_equal_project);
         st.update("dl.join_project", m_stats.m_join_project);
+        st.update("dl.join_multi", m_stats.m_join_multi);
         st.update("dl.project_rename", m_stats.m_project_rename);
         st.update("dl.union", m_stats.m_union);
         st.update("dl.filter_interpreted_project", m_stats.m_filter_interp_project);
@@ -187,11 +190,12 @@ namespace datalog {
 
     class instr_io : public instruction {
         bool m_store;
+        bool m_take; //when loading, move the relation out of the relation manager instead of cloning it
         func_decl_ref m_pred;
         reg_idx m_reg;
     public:
-        instr_io(bool store, func_decl_ref const& pred, reg_idx reg)
-            : m_store(store), m_pred(pred), m_reg(reg) {}
+        instr_io(bool store, func_decl_ref const& pred, reg_idx reg, bool take = false)
+            : m_store(store), m_take(take), m_pred(pred), m_reg(reg) {}
         bool perform(execution_context & ctx) override {
             log_verbose(ctx);            
             if (m_store) {
@@ -207,6 +211,18 @@ namespace datalog {
                     dctx.store_relation(m_pred, empty_rel);
                 }
             }
+            else if (m_take) {
+                relation_base * rel = ctx.get_rel_context().get_rmanager().release_relation(m_pred);
+                if (rel && !rel->fast_empty()) {
+                    ctx.set_reg(m_reg, rel);
+                }
+                else {
+                    if (rel) {
+                        rel->deallocate();
+                    }
+                    ctx.make_empty(m_reg);
+                }
+            }
             else {
                 relation_base& rel = ctx.get_rel_context().get_relation(m_pred);
                 if (!rel.fast_empty()) {
@@ -227,7 +243,7 @@ namespace datalog {
                 out << "store " << m_reg << " into " << rel_name;
             }
             else {
-                out << "load " << rel_name << " into " << m_reg;
+                out << (m_take ? "take " : "load ") << rel_name << " into " << m_reg;
             }
         }
     };
@@ -240,6 +256,10 @@ namespace datalog {
         return alloc(instr_io, true, func_decl_ref(pred, m), src);
     }
 
+    instruction * instruction::mk_take(ast_manager & m, func_decl * pred, reg_idx tgt) {
+        return alloc(instr_io, false, func_decl_ref(pred, m), tgt, true);
+    }
+
 
     class instr_dealloc : public instruction {
         reg_idx m_reg;
@@ -885,6 +905,158 @@ namespace datalog {
                 removed_cols, result);
     }
 
+    class instr_join_multi : public instruction {
+        svector<reg_idx>        m_tails;
+        vector<unsigned_vector> m_cols;
+        unsigned                m_num_vars;
+        reg_idx                 m_res;
+
+        void get_result_signature(execution_context & ctx, relation_signature & sig) const {
+            relation_sort s = nullptr;
+            sig.resize(m_num_vars, s);
+            for (unsigned i = 0; i < m_tails.size(); ++i) {
+                relation_signature const & tsig = ctx.reg(m_tails[i])->get_signature();
+                for (unsigned j = 0; j < m_cols[i].size(); ++j)
+                    sig[m_cols[i][j]] = tsig[j];
+            }
+        }
+
+        /**
+           \brief Join tables of table relations with a leapfrog triejoin.
+        */
+        relation_base * join_tables(execution_context & ctx) {
+            relation_manager & rm = ctx.reg(m_tails[0])->get_manager();
+            relation_signature sig;
+            get_result_signature(ctx, sig);
+            table_signature tsig;
+            if (!rm.relation_signature_to_table(sig, tsig))
+                return nullptr;
+            ptr_vector<table_base const> tables;
+            for (reg_idx t : m_tails)
+                tables.push_back(&static_cast<table_relation const &>(*ctx.reg(t)).get_table());
+            table_plugin * tp = &tables[0]->get_plugin();
+            if (!tp->can_handle_signature(tsig))
+                tp = &rm.get_appropriate_plugin(tsig);
+            leapfrog_join join(m_num_vars, m_cols);
+            table_base * result = join(*tp, tsig, tables.size(), tables.c_ptr());
+            return rm.get_table_relation_plugin(result->get_plugin()).mk_from_table(sig, result);
+        }
+
+        /**
+           \brief Join arbitrary relations with a sequence of binary joins, then enforce
+           the equalities between columns of the same variable and keep one column per variable.
+        */
+        relation_base * join_relations(execution_context & ctx) {
+            relation_manager & rm = ctx.reg(m_tails[0])->get_manager();
+            relation_base * acc = ctx.reg(m_tails[0])->clone();
+            unsigned_vector col2var(m_cols[0]);
+            for (unsigned i = 1; i < m_tails.size(); ++i) {
+                relation_base const & r = *ctx.reg(m_tails[i]);
+                unsigned_vector cols1, cols2;
+                for (unsigned j = 0; j < m_cols[i].size(); ++j) {
+                    unsigned idx = col2var.size();
+                    for (unsigned k = 0; idx == col2var.size() && k < col2var.size(); ++k) {
+                        if (col2var[k] == m_cols[i][j])
+                            idx = k;
+                    }
+                    if (idx < col2var.size()) {
+                        cols1.push_back(idx);
+                        cols2.push_back(j);
+                    }
+                }
+                scoped_ptr<relation_join_fn> fn = rm.mk_join_fn(*acc, r, cols1, cols2);
+                if (!fn) {
+                    throw default_exception(default_exception::fmt(),
+                                            "trying to perform unsupported join operation on relations of kinds %s and %s",
+                                            acc->get_plugin().get_name().bare_str(), r.get_plugin().get_name().bare_str());
+                }
+                relation_base * next = (*fn)(*acc, r);
+                acc->deallocate();
+                acc = next;
+                col2var.append(m_cols[i]);
+            }
+            unsigned_vector removed;
+            for (unsigned v = 0; v < m_num_vars; ++v) {
+                unsigned_vector identical;
+                for (unsigned k = 0; k < col2var.size(); ++k) {
+                    if (col2var[k] == v)
+                        identical.push_back(k);
+                }
+                SASSERT(!identical.empty());
+                if (identical.size() > 1) {
+                    scoped_ptr<relation_mutator_fn> fn = rm.mk_filter_identical_fn(*acc, identical.size(), identical.c_ptr());
+                    (*fn)(*acc);
+                }
+                for (unsigned k = 1; k < identical.size(); ++k)
+                    removed.push_back(identical[k]);
+            }
+            if (!removed.empty()) {
+                std::sort(removed.begin(), removed.end());
+                scoped_ptr<relation_transformer_fn> fn = rm.mk_project_fn(*acc, removed);
+                relation_base * next = (*fn)(*acc);
+                acc->deallocate();
+                acc = next;
+            }
+            // the columns of the variables are now ordered by their first occurrence,
+            // which is the order of the variables.
+            return acc;
+        }
+
+    public:
+        instr_join_multi(unsigned num_tails, const reg_idx * tails, vector<unsigned_vector> const & cols, reg_idx result)
+            : m_tails(num_tails, tails), m_cols(cols), m_num_vars(0), m_res(result) {
+            for (unsigned_vector const & c : cols)
+                for (unsigned v : c)
+                    m_num_vars = std::max(m_num_vars, v + 1);
+        }
+        bool perform(execution_context & ctx) override {
+            log_verbose(ctx);
+            for (reg_idx t : m_tails) {
+                if (!ctx.reg(t) || ctx.reg(t)->fast_empty()) {
+                    ctx.make_empty(m_res);
+                    return true;
+                }
+            }
+            ++ctx.m_stats.m_join_multi;
+            bool from_tables = true;
+            for (reg_idx t : m_tails)
+                from_tables &= ctx.reg(t)->from_table();
+            relation_base * result = nullptr;
+            if (from_tables && m_num_vars > 0)
+                result = join_tables(ctx);
+            if (!result)
+                result = join_relations(ctx);
+            ctx.set_reg(m_res, result);
+            TRACE("dl", tout << "multi-way join: " << ctx.reg(m_res)->get_size_estimate_rows() << "\n";);
+            if (ctx.reg(m_res)->fast_empty()) {
+                ctx.make_empty(m_res);
+            }
+            return true;
+        }
+        void make_annotations(execution_context & ctx) override {
+            std::string a = "join";
+            for (reg_idx t : m_tails) {
+                std::string s = "rel";
+                ctx.get_register_annotation(t, s);
+                a += " " + s;
+            }
+            ctx.set_register_annotation(m_res, a);
+        }
+        void display_head_impl(execution_context const & ctx, std::ostream & out) const override {
+            out << "join";
+            for (unsigned i = 0; i < m_tails.size(); ++i) {
+                out << (i == 0 ? " " : " and ") << m_tails[i];
+                print_container(m_cols[i], out);
+            }
+            out << " into " << m_res;
+        }
+    };
+
+    instruction * instruction::mk_join_multi(unsigned num_tails, const reg_idx * tails,
+        vector<unsigned_vector> const & cols, reg_idx result) {
+        return alloc(instr_join_multi, num_tails, tails, cols, result);
+    }
+
     class instr_select_equal_and_project : public instruction {
         reg_idx m_src;
         reg_idx m_result;
@@ -87,6 +87,7 @@ namespace datalog {
             unsigned m_filter_by_negation;
             unsigned m_select_equal_project;
             unsigned m_join_project;
+            unsigned m_join_multi;
             unsigned m_project_rename;
             unsigned m_union;
             unsigned m_filter_interp_project;
@@ -257,6 +258,11 @@ namespace datalog {
            is set to zero after the operation.
         */
         static instruction * mk_store(ast_manager & m, func_decl * pred, reg_idx src);
+        /**
+           \brief Like \c mk_load, but moves the relation of \c pred into the register instead of
+           copying it. The relation must be put back with \c mk_store.
+        */
+        static instruction * mk_take(ast_manager & m, func_decl * pred, reg_idx tgt);
         static instruction * mk_dealloc(reg_idx reg); //maybe not necessary
         static instruction * mk_clone(reg_idx from, reg_idx to);
         static instruction * mk_move(reg_idx from, reg_idx to);
@@ -284,6 +290,12 @@ namespace datalog {
         static instruction * mk_join_project(reg_idx rel1, reg_idx rel2, unsigned joined_col_cnt,
             const unsigned * cols1, const unsigned * cols2, unsigned removed_col_cnt, 
             const unsigned * removed_cols, reg_idx result);
+        /**
+           \brief Join of several relations where column j of tails[i] is bound to the
+           variable cols[i][j]. The result has one column per variable.
+        */
+        static instruction * mk_join_multi(unsigned num_tails, const reg_idx * tails,
+            vector<unsigned_vector> const & cols, reg_idx result);
         static instruction * mk_min(reg_idx source, reg_idx target, const unsigned_vector & group_by_cols,
             unsigned min_col);
         static instruction * mk_rename(reg_idx src, unsigned cycle_len, const unsigned * permutation_cycle, 
@@ -0,0 +1,235 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    dl_leapfrog_join.cpp
+
+Abstract:
+
+    Worst-case optimal multi-way join of tables (leapfrog triejoin).
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#include <algorithm>
+#include "muz/rel/dl_leapfrog_join.h"
+
+namespace datalog {
+
+    leapfrog_join::leapfrog_join(unsigned num_vars, vector<unsigned_vector> const & cols):
+        m_num_vars(num_vars),
+        m_cols(cols),
+        m_result(nullptr) {
+        m_tries.resize(cols.size());
+        m_participants.resize(num_vars);
+        for (unsigned i = 0; i < cols.size(); ++i) {
+            trie & t = m_tries[i];
+            unsigned_vector const & c = cols[i];
+            for (unsigned j = 0; j < c.size(); ++j) {
+                if (!t.m_vars.contains(c[j]))
+                    t.m_vars.push_back(c[j]);
+            }
+            std::sort(t.m_vars.begin(), t.m_vars.end());
+            for (unsigned d = 0; d < t.m_vars.size(); ++d) {
+                unsigned v = t.m_vars[d];
+                SASSERT(v < num_vars);
+                t.m_first.push_back(c.size());
+                for (unsigned j = 0; j < c.size() && t.m_first.back() == c.size(); ++j) {
+                    if (c[j] == v)
+                        t.m_first.back() = j;
+                }
+                m_participants[v].push_back(participant(i, d));
+            }
+        }
+        m_binding.resize(num_vars, 0);
+        m_pos.resize(num_vars);
+        m_lo.resize(num_vars);
+        m_hi.resize(num_vars);
+        for (unsigned v = 0; v < num_vars; ++v) {
+            unsigned n = m_participants[v].size();
+            m_pos[v].resize(n);
+            m_lo[v].resize(n);
+            m_hi[v].resize(n);
+        }
+    }
+
+    struct leapfrog_row_lt {
+        svector<table_element> const & m_rows;
+        unsigned m_width;
+        leapfrog_row_lt(svector<table_element> const & rows, unsigned width): m_rows(rows), m_width(width) {}
+        bool operator()(unsigned r1, unsigned r2) const {
+            table_element const * a = m_rows.c_ptr() + r1 * m_width;
+            table_element const * b = m_rows.c_ptr() + r2 * m_width;
+            for (unsigned i = 0; i < m_width; ++i) {
+                if (a[i] != b[i])
+                    return a[i] < b[i];
+            }
+            return false;
+        }
+    };
+
+    /**
+       \brief Build the trie of the i-th table: keep the rows that agree on the columns bound to
+       the same variable, project them on the variables, sort and remove duplicates.
+    */
+    void leapfrog_join::load(unsigned i, table_base const & tbl) {
+        trie & t = m_tries[i];
+        unsigned_vector const & cols = m_cols[i];
+        unsigned width = t.m_vars.size();
+        unsigned_vector depth;
+        for (unsigned j = 0; j < cols.size(); ++j) {
+            unsigned d = 0;
+            while (t.m_vars[d] != cols[j])
+                ++d;
+            depth.push_back(d);
+        }
+        svector<table_element> rows;
+        unsigned num_rows = 0;
+        table_fact f;
+        table_base::iterator it = tbl.begin(), end = tbl.end();
+        for (; it != end; ++it) {
+            it->get_fact(f);
+            bool consistent = true;
+            for (unsigned j = 0; consistent && j < cols.size(); ++j)
+                consistent = f[j] == f[t.m_first[depth[j]]];
+            if (!consistent)
+                continue;
+            for (unsigned d = 0; d < width; ++d)
+                rows.push_back(f[t.m_first[d]]);
+            ++num_rows;
+        }
+        unsigned_vector perm;
+        for (unsigned r = 0; r < num_rows; ++r)
+            perm.push_back(r);
+        std::sort(perm.begin(), perm.end(), leapfrog_row_lt(rows, width));
+        t.m_rows.reset();
+        t.m_num_rows = 0;
+        for (unsigned k = 0; k < num_rows; ++k) {
+            table_element const * r = rows.c_ptr() + perm[k] * width;
+            if (t.m_num_rows > 0) {
+                table_element const * last = t.m_rows.c_ptr() + (t.m_num_rows - 1) * width;
+                if (std::equal(r, r + width, last))
+                    continue;
+            }
+            t.m_rows.append(width, r);
+            ++t.m_num_rows;
+        }
+        t.m_lo = 0;
+        t.m_hi = t.m_num_rows;
+    }
+
+    /**
+       \brief Return the first row in [lo, hi) whose key at depth is at least v.
+    */
+    unsigned leapfrog_join::seek(trie const & t, unsigned depth, unsigned lo, unsigned hi, table_element v) const {
+        while (lo < hi) {
+            unsigned mid = lo + (hi - lo) / 2;
+            if (t.key(mid, depth) < v)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    /**
+       \brief Return the first row in [lo, hi) whose key at depth is larger than v.
+    */
+    unsigned leapfrog_join::upper(trie const & t, unsigned depth, unsigned lo, unsigned hi, table_element v) const {
+        while (lo < hi) {
+            unsigned mid = lo + (hi - lo) / 2;
+            if (t.key(mid, depth) <= v)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    void leapfrog_join::join(unsigned var) {
+        if (var == m_num_vars) {
+            m_result->add_fact(m_binding);
+            return;
+        }
+        svector<participant> const & ps = m_participants[var];
+        unsigned n = ps.size();
+        SASSERT(n > 0);
+        unsigned_vector & pos = m_pos[var];
+        unsigned_vector & lo = m_lo[var];
+        unsigned_vector & hi = m_hi[var];
+        for (unsigned k = 0; k < n; ++k) {
+            trie const & t = m_tries[ps[k].m_trie];
+            if (t.m_lo == t.m_hi)
+                return;
+            pos[k] = lo[k] = t.m_lo;
+            hi[k] = t.m_hi;
+        }
+        while (true) {
+            table_element max = 0;
+            for (unsigned k = 0; k < n; ++k)
+                max = std::max(max, m_tries[ps[k].m_trie].key(pos[k], ps[k].m_depth));
+            bool all_eq = true;
+            for (unsigned k = 0; k < n; ++k) {
+                trie const & t = m_tries[ps[k].m_trie];
+                pos[k] = seek(t, ps[k].m_depth, pos[k], hi[k], max);
+                if (pos[k] == hi[k])
+                    goto done;
+                all_eq &= t.key(pos[k], ps[k].m_depth) == max;
+            }
+            if (!all_eq)
+                continue;
+            for (unsigned k = 0; k < n; ++k) {
+                trie & t = m_tries[ps[k].m_trie];
+                t.m_lo = pos[k];
+                t.m_hi = upper(t, ps[k].m_depth, pos[k], hi[k], max);
+            }
+            m_binding[var] = max;
+            join(var + 1);
+            bool exhausted = false;
+            for (unsigned k = 0; k < n; ++k) {
+                trie & t = m_tries[ps[k].m_trie];
+                pos[k] = t.m_hi;
+                exhausted |= pos[k] == hi[k];
+            }
+            if (exhausted)
+                goto done;
+        }
+    done:
+        for (unsigned k = 0; k < n; ++k) {
+            trie & t = m_tries[ps[k].m_trie];
+            t.m_lo = lo[k];
+            t.m_hi = hi[k];
+        }
+    }
+
+    table_base * leapfrog_join::operator()(table_plugin & plugin, table_signature const & sig,
+                                           unsigned num_tables, table_base const * const * tables) {
+        SASSERT(num_tables == m_tries.size());
+        SASSERT(sig.size() == m_num_vars);
+        m_result = plugin.mk_empty(sig);
+        for (unsigned i = 0; i < num_tables; ++i) {
+            load(i, *tables[i]);
+            if (m_tries[i].m_num_rows == 0)
+                break;
+        }
+        bool empty = false;
+        for (trie const & t : m_tries)
+            empty |= t.m_num_rows == 0;
+        if (!empty)
+            join(0);
+        for (trie & t : m_tries) {
+            t.m_rows.finalize();
+            t.m_num_rows = 0;
+        }
+        table_base * result = m_result;
+        m_result = nullptr;
+        return result;
+    }
+
+};
@@ -0,0 +1,86 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    dl_leapfrog_join.h
+
+Abstract:
+
+    Worst-case optimal multi-way join of tables (leapfrog triejoin).
+
+    Every table is sorted into a trie following a global order of the
+    variables. The join binds one variable at a time by intersecting the
+    values that the tables containing the variable admit at the current
+    trie level. Unlike a sequence of binary joins, the intermediate
+    results never exceed the size bound of the output, which matters for
+    cyclic rule bodies such as triangles.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#ifndef DL_LEAPFROG_JOIN_H_
+#define DL_LEAPFROG_JOIN_H_
+
+#include "util/vector.h"
+#include "muz/rel/dl_base.h"
+
+namespace datalog {
+
+    class leapfrog_join {
+        struct trie {
+            unsigned_vector        m_vars;   // variables of the table in increasing order
+            unsigned_vector        m_first;  // first column of the table bound to each of m_vars
+            svector<table_element> m_rows;   // sorted and distinct tuples with m_vars.size() elements
+            unsigned               m_num_rows;
+            unsigned               m_lo;     // current range of tuples
+            unsigned               m_hi;
+            trie(): m_num_rows(0), m_lo(0), m_hi(0) {}
+            table_element key(unsigned row, unsigned depth) const { return m_rows[row * m_vars.size() + depth]; }
+        };
+
+        struct participant {
+            unsigned m_trie;
+            unsigned m_depth;
+            participant(unsigned t, unsigned d): m_trie(t), m_depth(d) {}
+        };
+
+        unsigned                    m_num_vars;
+        vector<unsigned_vector>     m_cols;
+        vector<trie>                m_tries;
+        vector<svector<participant> > m_participants;
+        // positions and ranges of the participants of every variable, allocated once
+        vector<unsigned_vector>     m_pos;
+        vector<unsigned_vector>     m_lo;
+        vector<unsigned_vector>     m_hi;
+        table_fact                  m_binding;
+        table_base *                m_result;
+
+        void load(unsigned i, table_base const & t);
+        unsigned seek(trie const & t, unsigned depth, unsigned lo, unsigned hi, table_element v) const;
+        unsigned upper(trie const & t, unsigned depth, unsigned lo, unsigned hi, table_element v) const;
+        void join(unsigned var);
+
+    public:
+        /**
+           \brief Column j of the i-th table is bound to the variable cols[i][j].
+           Variables range over 0, ..., num_vars-1, and every variable occurs in some table.
+        */
+        leapfrog_join(unsigned num_vars, vector<unsigned_vector> const & cols);
+
+        /**
+           \brief Return a new table of \c plugin with one column per variable that contains
+           every assignment to the variables consistent with all tables.
+        */
+        table_base * operator()(table_plugin & plugin, table_signature const & sig,
+                                unsigned num_tables, table_base const * const * tables);
+    };
+
+};
+
+#endif /* DL_LEAPFROG_JOIN_H_ */
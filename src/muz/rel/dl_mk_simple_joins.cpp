@@ -684,10 +684,36 @@ namespace datalog {
         }
 
 
+        /**
+           \brief Rules with three or more positive tails whose arguments are variables
+           are left to the multi-way join of the compiler.
+        */
+        bool use_multiway_join(rule * r) const {
+            if (!m_context.multiway_join() || r->get_positive_tail_size() < 3) {
+                return false;
+            }
+            for (unsigned i = 0; i < r->get_positive_tail_size(); i++) {
+                for (expr * arg : *r->get_tail(i)) {
+                    if (!is_var(arg)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
     public:
         rule_set * run(rule_set const & source) {
 
             for (rule * r : source) {
+                if (use_multiway_join(r)) {
+                    ptr_vector<app> & rule_content =
+                        m_rules_content.insert_if_not_there2(r, ptr_vector<app>())->get_data().m_value;
+                    for (unsigned i = 0; i < r->get_positive_tail_size(); i++) {
+                        rule_content.push_back(r->get_tail(i));
+                    }
+                    continue;
+                }
                 register_rule(r);
             }
 
@@ -703,7 +729,7 @@ namespace datalog {
             for (auto& kv : m_rules_content) {
                 rule * orig_r = kv.m_key;
                 ptr_vector<app> content = kv.m_value;
-                SASSERT(content.size() <= 2);
+                SASSERT(content.size() <= 2 || use_multiway_join(orig_r));
                 if (content.size() == orig_r->get_positive_tail_size()) {
                     //rule did not change
                     result->add_rule(orig_r);
@@ -115,6 +115,15 @@ namespace datalog {
         e->get_data().m_value = rel;
     }
 
+    relation_base * relation_manager::release_relation(func_decl * pred) {
+        relation_base * res = nullptr;
+        if (m_relations.find(pred, res)) {
+            m_relations.remove(pred);
+            get_context().get_manager().dec_ref(pred);
+        }
+        return res;
+    }
+
     void relation_manager::collect_non_empty_predicates(decl_set & res) const {
         for (auto const& kv : m_relations) {
             if (!kv.m_value->fast_empty()) {
@@ -146,6 +146,11 @@ namespace datalog {
            takes over the relation object.
         */
         void store_relation(func_decl * pred, relation_base * rel);
+        /**
+           \brief Remove the relation of \c pred from the \c relation_manager and return it, or
+           return 0 if there is none. The caller takes over the relation object.
+        */
+        relation_base * release_relation(func_decl * pred);
 
         bool is_saturated(func_decl * pred) const { return m_saturated_rels.contains(pred); }
         void mark_saturated(func_decl * pred) { m_saturated_rels.insert(pred); }
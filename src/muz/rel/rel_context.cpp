@@ -33,9 +33,11 @@ Revision History:
 #include "muz/rel/karr_relation.h"
 #include "muz/rel/dl_finite_product_relation.h"
 #include "muz/rel/udoc_relation.h"
+#include "muz/rel/dl_bdd_relation.h"
 #include "muz/rel/check_relation.h"
 #include "muz/rel/dl_lazy_table.h"
 #include "muz/rel/dl_sparse_table.h"
+#include "muz/rel/dl_column_table.h"
 #include "muz/rel/dl_table.h"
 #include "muz/rel/dl_table_relation.h"
 #include "muz/rel/aig_exporter.h"
@@ -98,7 +100,11 @@ namespace datalog {
           m_answer(m), 
           m_last_result_relation(nullptr),
           m_ectx(ctx),
-          m_sw(0) {
+          m_sw(0),
+          m_fact_preds(m),
+          m_up_to_date(false),
+          m_num_updates(0),
+          m_num_rebuilds(0) {
 
         // register plugins for builtin tables
 
@@ -107,6 +113,7 @@ namespace datalog {
         rm.register_plugin(alloc(sparse_table_plugin, rm));
         rm.register_plugin(alloc(hashtable_table_plugin, rm));
         rm.register_plugin(alloc(bitvector_table_plugin, rm));
+        rm.register_plugin(alloc(column_table_plugin, rm));
         rm.register_plugin(lazy_table_plugin::mk_sparse(rm));
 
         // register plugins for builtin relations
@@ -115,6 +122,7 @@ namespace datalog {
         rm.register_plugin(alloc(interval_relation_plugin, rm));
         if (m_context.karr()) rm.register_plugin(alloc(karr_relation_plugin, rm));
         rm.register_plugin(alloc(udoc_plugin, rm));
+        rm.register_plugin(alloc(bdd_relation_plugin, rm));
         rm.register_plugin(alloc(check_relation_plugin, rm));
     }
 
@@ -237,8 +245,18 @@ namespace datalog {
             m_context.set_output_predicate(rels[i]);
         }
         m_context.close();
-        reset_negated_tables();
-        lbool res = saturate(_scoped_query);
+        lbool res;
+        if (m_context.incremental()) {
+            res = maintain();
+            if (res == l_true) {
+                m_context.set_status(OK);
+            }
+        }
+        else {
+            release_maintained();
+            reset_negated_tables();
+            res = saturate(_scoped_query);
+        }
 
         switch(res) {
         case l_true: {
@@ -331,6 +349,20 @@ namespace datalog {
         setup_default_relation();
         get_rmanager().reset_saturated_marks();
         scoped_query _scoped_query(m_context);
+        if (m_context.incremental()) {
+            // bring the relations up to date and evaluate only the query against them
+            m_context.ensure_closed();
+            lbool res = maintain();
+            if (res != l_true) {
+                return res;
+            }
+            m_context.reopen();
+            rule_set no_rules(m_context);
+            m_context.replace_rules(no_rules);
+        }
+        else {
+            release_maintained();
+        }
         rule_manager& rm = m_context.get_rule_manager();
         func_decl_ref query_pred(m);
         try {
@@ -342,7 +374,9 @@ namespace datalog {
         }
         
         m_context.close();
-        reset_negated_tables();
+        if (!m_context.incremental()) {
+            reset_negated_tables();
+        }
         
         if (m_context.generate_explanations()) {
             m_context.transform_rules(alloc(mk_explanations, m_context));
@@ -444,7 +478,15 @@ namespace datalog {
     }
 
     void rel_context::restrict_predicates(func_decl_set const& predicates) {
-        get_rmanager().restrict_predicates(predicates);
+        if (m_fact_preds.empty()) {
+            get_rmanager().restrict_predicates(predicates);
+            return;
+        }
+        func_decl_set preds(predicates);
+        for (func_decl * p : m_fact_preds) {
+            preds.insert(p);
+        }
+        get_rmanager().restrict_predicates(preds);
     }
 
     relation_base & rel_context::get_relation(func_decl * pred)  { return get_rmanager().get_relation(pred); }
@@ -548,7 +590,18 @@ namespace datalog {
  
     void rel_context::add_fact(func_decl* pred, relation_fact const& fact) {
         get_rmanager().reset_saturated_marks();
-        get_relation(pred).add_fact(fact);
+        if (m_maintained) {
+            func_decl * retracted = nullptr;
+            if (m_retracted.find(pred, retracted)) {
+                remove_facts(get_relation(retracted), fact);
+            }
+            if (!m_maintained->get_predicate_rules(pred).empty() || !get_relation(pred).contains_fact(fact)) {
+                get_fact_relation(m_inserted, pred, "inserted").add_fact(fact);
+            }
+        }
+        else {
+            get_relation(pred).add_fact(fact);
+        }
         if (m_context.print_aig().size()) {
             m_table_facts.push_back(std::make_pair(pred, fact));
         }
@@ -557,7 +610,7 @@ namespace datalog {
     void rel_context::add_fact(func_decl* pred, table_fact const& fact) {
         get_rmanager().reset_saturated_marks();
         relation_base & rel0 = get_relation(pred);
-        if (rel0.from_table()) {
+        if (rel0.from_table() && !m_maintained) {
             table_relation & rel = static_cast<table_relation &>(rel0);
             rel.add_table_fact(fact);
             // TODO: table facts?
@@ -571,6 +624,258 @@ namespace datalog {
         }
     }
 
+    void rel_context::remove_fact(func_decl* pred, relation_fact const& fact) {
+        get_rmanager().reset_saturated_marks();
+        if (m_maintained) {
+            func_decl * inserted = nullptr;
+            if (m_inserted.find(pred, inserted)) {
+                remove_facts(get_relation(inserted), fact);
+            }
+            if (get_relation(pred).contains_fact(fact)) {
+                get_fact_relation(m_retracted, pred, "retracted").add_fact(fact);
+            }
+        }
+        else {
+            remove_facts(get_relation(pred), fact);
+        }
+    }
+
+    relation_base & rel_context::get_fact_relation(pred2pred & preds, func_decl * pred, char const * suffix) {
+        func_decl * p = nullptr;
+        if (!preds.find(pred, p)) {
+            p = m.mk_fresh_func_decl(pred->get_name(), symbol(suffix), pred->get_arity(), 
+                                     pred->get_domain(), m.mk_bool_sort());
+            m_fact_preds.push_back(p);
+            preds.insert(pred, p);
+            relation_base & rel = get_relation(pred);
+            store_relation(p, rel.get_plugin().mk_empty(rel));
+        }
+        return get_relation(p);
+    }
+
+    void rel_context::add_facts(relation_base & tgt, relation_base const & facts) {
+        scoped_ptr<relation_union_fn> fn = get_rmanager().mk_union_fn(tgt, facts);
+        if (!fn) {
+            throw default_exception("relation does not support adding facts incrementally");
+        }
+        (*fn)(tgt, facts);
+    }
+
+    void rel_context::remove_facts(relation_base & tgt, relation_base const & facts) {
+        unsigned_vector cols;
+        for (unsigned i = 0; i < tgt.get_signature().size(); ++i) {
+            cols.push_back(i);
+        }
+        scoped_ptr<relation_intersection_filter_fn> fn = get_rmanager().mk_filter_by_negation_fn(tgt, facts, cols, cols);
+        if (!fn) {
+            throw default_exception("relation does not support retracting facts");
+        }
+        (*fn)(tgt, facts);
+    }
+
+    void rel_context::remove_facts(relation_base & tgt, relation_fact const & fact) {
+        scoped_rel<relation_base> facts = tgt.get_plugin().mk_empty(tgt);
+        facts->add_fact(fact);
+        remove_facts(tgt, *facts);
+    }
+
+    bool rel_context::has_pending_changes() {
+        for (auto const & kv : m_inserted) {
+            if (!get_relation(kv.m_value).fast_empty()) {
+                return true;
+            }
+        }
+        for (auto const & kv : m_retracted) {
+            if (!get_relation(kv.m_value).fast_empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void rel_context::reset_pending_changes() {
+        for (auto const & kv : m_inserted) {
+            get_relation(kv.m_value).reset();
+        }
+        for (auto const & kv : m_retracted) {
+            get_relation(kv.m_value).reset();
+        }
+    }
+
+    /**
+       \brief Add the pending changes to the relations, and to the given facts of the
+       predicates that have rules.
+    */
+    void rel_context::apply_pending_changes() {
+        for (auto const & kv : m_retracted) {
+            relation_base const & facts = get_relation(kv.m_value);
+            if (facts.fast_empty()) {
+                continue;
+            }
+            remove_facts(get_relation(kv.m_key), facts);
+            func_decl * base = nullptr;
+            if (m_base.find(kv.m_key, base)) {
+                remove_facts(get_relation(base), facts);
+            }
+        }
+        for (auto const & kv : m_inserted) {
+            relation_base const & facts = get_relation(kv.m_value);
+            if (facts.fast_empty()) {
+                continue;
+            }
+            add_facts(get_relation(kv.m_key), facts);
+            if (m_maintained && !m_maintained->get_predicate_rules(kv.m_key).empty()) {
+                add_facts(get_fact_relation(m_base, kv.m_key, "base"), facts);
+            }
+        }
+        reset_pending_changes();
+    }
+
+    /**
+       \brief Hand the relations back to the non-incremental evaluation.
+    */
+    void rel_context::release_maintained() {
+        if (!m_maintained) {
+            return;
+        }
+        apply_pending_changes();
+        for (auto const & kv : m_base) {
+            get_relation(kv.m_value).reset();
+        }
+        m_maintained = nullptr;
+        m_up_to_date = false;
+    }
+
+    static bool same_rules(rule_set const & r1, rule_set const & r2) {
+        if (r1.get_num_rules() != r2.get_num_rules()) {
+            return false;
+        }
+        for (unsigned i = 0; i < r1.get_num_rules(); ++i) {
+            if (r1.get_rule(i) != r2.get_rule(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    lbool rel_context::maintain() {
+        rule_set const & rules = m_context.get_rules();
+        if (!m_maintained || !m_up_to_date || !same_rules(*m_maintained, rules)) {
+            return rebuild();
+        }
+        if (!has_pending_changes()) {
+            return l_true;
+        }
+        pred2pred inserted, retracted;
+        for (auto const & kv : m_retracted) {
+            relation_base const & facts = get_relation(kv.m_value);
+            if (facts.fast_empty()) {
+                continue;
+            }
+            retracted.insert(kv.m_key, kv.m_value);
+            func_decl * base = nullptr;
+            if (m_base.find(kv.m_key, base)) {
+                remove_facts(get_relation(base), facts);
+            }
+        }
+        for (auto const & kv : m_inserted) {
+            relation_base const & facts = get_relation(kv.m_value);
+            if (facts.fast_empty()) {
+                continue;
+            }
+            inserted.insert(kv.m_key, kv.m_value);
+            if (!rules.get_predicate_rules(kv.m_key).empty()) {
+                add_facts(get_fact_relation(m_base, kv.m_key, "base"), facts);
+            }
+        }
+        instruction_block code, termination_code;
+        if (!compiler::compile_update(m_context, rules, inserted, retracted, m_base, m_deleted, m_fact_preds,
+                                       code, termination_code)) {
+            TRACE("dl", tout << "the change reaches a negated tail\n";);
+            return rebuild();
+        }
+        m_up_to_date = false;
+        lbool res = run(code, termination_code);
+        if (res == l_true) {
+            reset_pending_changes();
+            m_up_to_date = true;
+            ++m_num_updates;
+        }
+        return res;
+    }
+
+    lbool rel_context::rebuild() {
+        rule_set const & rules = m_context.get_rules();
+        apply_pending_changes();
+        // the relations of the predicates that had rules drop their derived facts, the
+        // relations of the predicates that get rules keep their facts as given facts
+        scoped_ptr<rule_set> old_rules = m_maintained.detach();
+        func_decl_set heads;
+        for (rule * r : rules) {
+            heads.insert(r->get_decl());
+        }
+        if (old_rules) {
+            for (rule * r : *old_rules) {
+                heads.insert(r->get_decl());
+            }
+        }
+        for (func_decl * p : heads) {
+            bool had_rules = old_rules && !old_rules->get_predicate_rules(p).empty();
+            bool has_rules = !rules.get_predicate_rules(p).empty();
+            relation_base & rel = get_relation(p);
+            func_decl * base = nullptr;
+            if (had_rules) {
+                rel.reset();
+                if (m_base.find(p, base)) {
+                    add_facts(rel, get_relation(base));
+                }
+            }
+            else if (has_rules) {
+                relation_base & given = get_fact_relation(m_base, p, "base");
+                given.reset();
+                add_facts(given, rel);
+            }
+            if (!has_rules && m_base.find(p, base)) {
+                get_relation(base).reset();
+            }
+        }
+        m_maintained = alloc(rule_set, rules);
+        m_up_to_date = false;
+        get_rmanager().reset_saturated_marks();
+        instruction_block code, termination_code;
+        compiler::compile(m_context, rules, code, termination_code);
+        lbool res = run(code, termination_code);
+        if (res == l_true) {
+            m_up_to_date = true;
+            ++m_num_rebuilds;
+        }
+        return res;
+    }
+
+    lbool rel_context::run(instruction_block & code, instruction_block & termination_code) {
+        ::stopwatch sw;
+        sw.start();
+        m_ectx.reset();
+        bool done;
+        try {
+            done = code.perform(m_ectx);
+        }
+        catch (z3_exception &) {
+            termination_code.perform(m_ectx);
+            m_ectx.reset();
+            throw;
+        }
+        VERIFY(termination_code.perform(m_ectx) || m_context.canceled());
+        m_ectx.reset();
+        sw.stop();
+        m_sw += sw.get_seconds();
+        if (!done || m_context.canceled()) {
+            m_context.set_status(m_context.canceled() ? CANCELED : MEMOUT);
+            return l_undef;
+        }
+        return l_true;
+    }
+
     bool rel_context::has_facts(func_decl * pred) const {
         relation_base* r = try_get_relation(pred);
         return r && !r->empty();
@@ -582,6 +887,9 @@ namespace datalog {
 
     void rel_context::collect_statistics(statistics& st) const {
         st.update("saturation time", m_sw);
+        st.update("incremental updates", m_num_updates);
+        st.update("incremental rebuilds", m_num_rebuilds);
+        st.update("incremental deleted predicates", m_deleted.size());
         m_code.collect_statistics(st);
         m_ectx.collect_statistics(st);
     }
@@ -43,6 +43,18 @@ namespace datalog {
         instruction_block  m_code;
         double             m_sw;
 
+        // state of datalog.incremental
+        typedef obj_map<func_decl, func_decl*> pred2pred;
+        scoped_ptr<rule_set> m_maintained;  // rules of the predicates that have their given facts in m_base
+        pred2pred          m_inserted;      // facts added since the relations were last updated
+        pred2pred          m_retracted;     // facts removed since the relations were last updated
+        pred2pred          m_base;          // facts given directly for predicates with rules
+        pred2pred          m_deleted;       // over-deleted facts of a predicate during an update
+        func_decl_ref_vector m_fact_preds;  // predicates of the relations in the maps above
+        bool               m_up_to_date;    // the relations hold the fixpoint of m_maintained
+        unsigned           m_num_updates;
+        unsigned           m_num_rebuilds;
+
         class scoped_query;
 
         void reset_negated_tables();
@@ -53,6 +65,26 @@ namespace datalog {
 
         void setup_default_relation();
 
+        relation_base & get_fact_relation(pred2pred & preds, func_decl * pred, char const * suffix);
+        void add_facts(relation_base & tgt, relation_base const & facts);
+        void remove_facts(relation_base & tgt, relation_base const & facts);
+        void remove_facts(relation_base & tgt, relation_fact const & fact);
+        bool has_pending_changes();
+        void reset_pending_changes();
+        void apply_pending_changes();
+        void release_maintained();
+
+        /**
+           \brief Bring the relations up to date with the facts and the rules of the context,
+           incrementally if possible.
+        */
+        lbool maintain();
+        /**
+           \brief Recompute the fixpoint of the rules from the facts that were given directly.
+        */
+        lbool rebuild();
+        lbool run(instruction_block & code, instruction_block & termination_code);
+
     public:
         rel_context(context& ctx);
 
@@ -105,6 +137,7 @@ namespace datalog {
         */
         void add_fact(func_decl* pred, relation_fact const& fact) override;
         void add_fact(func_decl* pred, table_fact const& fact) override;
+        void remove_fact(func_decl* pred, relation_fact const& fact) override;
 
         /** \brief check if facts were added to relation
         */
@@ -768,6 +768,12 @@ void pred_transformer::collect_statistics(statistics& st) const
     st.update("SPACER num ctp blocked", m_stats.m_num_ctp_blocked);
     st.update("SPACER num is_invariant", m_stats.m_num_is_invariant);
     st.update("SPACER num lemma jumped", m_stats.m_num_lemma_level_jump);
+    // -- number of new lemmas dropped because a stronger lemma exists
+    st.update("SPACER num subsumed lemmas", m_stats.m_num_subsumed_lemmas);
+    // -- number of active lemmas removed because a stronger lemma was added
+    st.update("SPACER num removed lemmas", m_stats.m_num_removed_lemmas);
+    // -- number of lemmas pushed without a solver call
+    st.update("SPACER num subsumed pushes", m_stats.m_num_subsumed_pushes);
 
     // -- time in rule initialization
     st.update ("time.spacer.init_rules.pt.init", m_initialize_watch.get_seconds ());
@@ -2006,58 +2012,78 @@ bool pred_transformer::frames::add_lemma(lemma *new_lemma)
         return true;
     }
 
-    unsigned i = 0;
-    for (auto *old_lemma : m_lemmas) {
-        if (old_lemma->get_expr() == new_lemma->get_expr()) {
-            m_pt.get_context().new_lemma_eh(m_pt, new_lemma);
-
-            // register existing lemma with the pob
-            if (new_lemma->has_pob()) {
-                pob_ref &pob = new_lemma->get_pob();
-                if (!pob->lemmas().contains(old_lemma))
-                    pob->add_lemma(old_lemma);
-            }
+    // the formula index tells whether new_lemma is already active
+    if (m_expr2lemma.contains(new_lemma->get_expr())) {
+        unsigned i = 0;
+        for (auto *old_lemma : m_lemmas) {
+            if (old_lemma->get_expr() == new_lemma->get_expr()) {
+                m_pt.get_context().new_lemma_eh(m_pt, new_lemma);
+
+                // register existing lemma with the pob
+                if (new_lemma->has_pob()) {
+                    pob_ref &pob = new_lemma->get_pob();
+                    if (!pob->lemmas().contains(old_lemma))
+                        pob->add_lemma(old_lemma);
+                }
 
-            // extend bindings if needed
-            if (!new_lemma->get_bindings().empty()) {
-                old_lemma->add_binding(new_lemma->get_bindings());
-            }
-            // if the lemma is at a higher level, skip it,
-            if (old_lemma->level() >= new_lemma->level()) {
-                TRACE("spacer", tout << "Already at a higher level: "
-                      << pp_level(old_lemma->level()) << "\n";);
-                // but, since the instances might be new, assert the
-                // instances that have been copied into m_lemmas[i]
+                // extend bindings if needed
                 if (!new_lemma->get_bindings().empty()) {
-                    m_pt.add_lemma_core(old_lemma, true);
+                    old_lemma->add_binding(new_lemma->get_bindings());
                 }
-                if (is_infty_level(old_lemma->level())) {
-                    old_lemma->bump();
-                    if (old_lemma->get_bumped() >= 100) {
-                        IF_VERBOSE(1, verbose_stream() << "Adding lemma to oo "
-                                   << old_lemma->get_bumped() << " "
-                                   << mk_pp(old_lemma->get_expr(),
-                                            m_pt.get_ast_manager()) << "\n";);
-                        throw default_exception("Stuck on a lemma");
+                // if the lemma is at a higher level, skip it,
+                if (old_lemma->level() >= new_lemma->level()) {
+                    TRACE("spacer", tout << "Already at a higher level: "
+                          << pp_level(old_lemma->level()) << "\n";);
+                    // but, since the instances might be new, assert the
+                    // instances that have been copied into m_lemmas[i]
+                    if (!new_lemma->get_bindings().empty()) {
+                        m_pt.add_lemma_core(old_lemma, true);
+                    }
+                    if (is_infty_level(old_lemma->level())) {
+                        old_lemma->bump();
+                        if (old_lemma->get_bumped() >= 100) {
+                            IF_VERBOSE(1, verbose_stream() << "Adding lemma to oo "
+                                       << old_lemma->get_bumped() << " "
+                                       << mk_pp(old_lemma->get_expr(),
+                                                m_pt.get_ast_manager()) << "\n";);
+                            throw default_exception("Stuck on a lemma");
+                        }
                     }
+                    // no new lemma added
+                    return false;
                 }
-                // no new lemma added
-                return false;
-            }
 
-            // update level of the existing lemma
-            old_lemma->set_level(new_lemma->level());
-            // assert lemma in the solver
-            m_pt.add_lemma_core(old_lemma, false);
-            // move the lemma to its new place to maintain sortedness
-            unsigned sz = m_lemmas.size();
-            for (unsigned j = i;
-                 (j + 1) < sz && m_lt(m_lemmas[j + 1], m_lemmas[j]); ++j) {
-                m_lemmas.swap (j, j+1);
+                // update level of the existing lemma
+                old_lemma->set_level(new_lemma->level());
+                // assert lemma in the solver
+                m_pt.add_lemma_core(old_lemma, false);
+                // move the lemma to its new place to maintain sortedness
+                unsigned sz = m_lemmas.size();
+                for (unsigned j = i;
+                     (j + 1) < sz && m_lt(m_lemmas[j + 1], m_lemmas[j]); ++j) {
+                    m_lemmas.swap (j, j+1);
+                }
+                // at its new level the lemma may subsume more lemmas
+                remove_subsumed(old_lemma);
+                return true;
             }
-            return true;
+            i++;
+        }
+    }
+
+    // a lemma at the same or a higher level whose cube is contained in
+    // the cube of new_lemma is stronger
+    lemma *subsumer = find_subsumer(new_lemma, new_lemma->level());
+    if (subsumer) {
+        TRACE("spacer", tout << "Subsumed by: "
+              << mk_pp(subsumer->get_expr(), m_pt.get_ast_manager()) << "\n";);
+        if (new_lemma->has_pob()) {
+            pob_ref &pob = new_lemma->get_pob();
+            if (!pob->lemmas().contains(subsumer))
+                pob->add_lemma(subsumer);
         }
-        i++;
+        ++m_pt.m_stats.m_num_subsumed_lemmas;
+        return false;
     }
 
     // new_lemma is really new
@@ -2067,6 +2093,8 @@ bool pred_transformer::frames::add_lemma(lemma *new_lemma)
     m_pinned_lemmas.push_back(new_lemma);
     m_sorted = false;
     m_pt.add_lemma_core(new_lemma);
+    index_lemma(new_lemma);
+    remove_subsumed(new_lemma);
 
     if (new_lemma->has_pob()) {new_lemma->get_pob()->add_lemma(new_lemma);}
 
@@ -2077,6 +2105,106 @@ bool pred_transformer::frames::add_lemma(lemma *new_lemma)
 }
 
 
+static bool is_indexed_lemma(lemma *l) {
+    return l->is_ground() && l->get_bindings().empty() && !l->is_false();
+}
+
+void pred_transformer::frames::index_lemma(lemma *l)
+{
+    m_expr2lemma.insert(l->get_expr(), l);
+    if (!is_indexed_lemma(l)) { return; }
+    for (expr *lit : l->get_cube()) {
+        m_lit2lemmas.insert_if_not_there2(lit, ptr_vector<lemma>())->get_data().m_value.push_back(l);
+    }
+}
+
+void pred_transformer::frames::unindex_lemma(lemma *l)
+{
+    m_expr2lemma.erase(l->get_expr());
+    if (!is_indexed_lemma(l)) { return; }
+    for (expr *lit : l->get_cube()) {
+        auto *e = m_lit2lemmas.find_core(lit);
+        if (e) { e->get_data().m_value.erase(l); }
+    }
+}
+
+void pred_transformer::frames::reindex()
+{
+    m_expr2lemma.reset();
+    m_lit2lemmas.reset();
+    for (lemma *l : m_lemmas) { index_lemma(l); }
+}
+
+/// Find an active lemma at level min_level or higher whose cube is a
+/// subset of the cube of l
+lemma *pred_transformer::frames::find_subsumer(lemma *l, unsigned min_level)
+{
+    if (!is_indexed_lemma(l)) { return nullptr; }
+    expr_ref_vector const &cube = l->get_cube();
+    obj_hashtable<expr> lits;
+    for (expr *lit : cube) { lits.insert(lit); }
+    for (expr *lit : cube) {
+        auto *e = m_lit2lemmas.find_core(lit);
+        if (!e) { continue; }
+        for (lemma *c : e->get_data().m_value) {
+            if (c == l || c->level() < min_level) { continue; }
+            expr_ref_vector const &c_cube = c->get_cube();
+            // every candidate is checked once, at its first literal
+            if (c_cube.get(0) != lit || c_cube.size() > cube.size()) { continue; }
+            bool subset = true;
+            for (unsigned j = 1; subset && j < c_cube.size(); ++j) {
+                subset = lits.contains(c_cube.get(j));
+            }
+            if (subset) { return c; }
+        }
+    }
+    return nullptr;
+}
+
+/// Remove the active lemmas that are weaker than l and not at a higher level
+void pred_transformer::frames::remove_subsumed(lemma *l)
+{
+    if (!is_indexed_lemma(l)) { return; }
+    expr_ref_vector const &cube = l->get_cube();
+    // a weaker lemma contains every literal of cube, so it suffices to
+    // scan the shortest list of lemmas of a literal
+    ptr_vector<lemma> const *shortest = nullptr;
+    for (expr *lit : cube) {
+        auto *e = m_lit2lemmas.find_core(lit);
+        if (!e) { return; }
+        if (!shortest || e->get_data().m_value.size() < shortest->size()) {
+            shortest = &e->get_data().m_value;
+        }
+    }
+    ptr_vector<lemma> weaker;
+    for (lemma *c : *shortest) {
+        if (c == l || c->level() > l->level()) { continue; }
+        expr_ref_vector const &c_cube = c->get_cube();
+        if (c_cube.size() < cube.size()) { continue; }
+        obj_hashtable<expr> c_lits;
+        for (expr *lit : c_cube) { c_lits.insert(lit); }
+        bool subset = true;
+        for (unsigned j = 0; subset && j < cube.size(); ++j) {
+            subset = c_lits.contains(cube.get(j));
+        }
+        if (subset) { weaker.push_back(c); }
+    }
+    if (weaker.empty()) { return; }
+    for (lemma *c : weaker) {
+        TRACE("spacer", tout << "Remove subsumed lemma: "
+              << mk_pp(c->get_expr(), m_pt.get_ast_manager()) << "\n";);
+        unindex_lemma(c);
+    }
+    unsigned j = 0;
+    for (unsigned i = 0; i < m_lemmas.size(); ++i) {
+        if (!weaker.contains(m_lemmas.get(i))) {
+            m_lemmas.set(j++, m_lemmas.get(i));
+        }
+    }
+    m_lemmas.shrink(j);
+    m_pt.m_stats.m_num_removed_lemmas += weaker.size();
+}
+
 void pred_transformer::frames::propagate_to_infinity (unsigned level)
 {
     for (unsigned i = 0, sz = m_lemmas.size (); i < sz; ++i)
@@ -2110,7 +2238,14 @@ bool pred_transformer::frames::propagate_to_next_level (unsigned level)
         if (m_lemmas [i]->level () < level) {++i; continue;}
 
         unsigned solver_level;
-        if (m_pt.is_invariant(tgt_level, m_lemmas.get(i), solver_level)) {
+        // a lemma that is weaker than a lemma at the target level is pushed
+        // without a solver call
+        lemma *subsumer = find_subsumer(m_lemmas.get(i), tgt_level);
+        if (subsumer) {
+            solver_level = subsumer->level();
+            ++m_pt.m_stats.m_num_subsumed_pushes;
+        }
+        if (subsumer || m_pt.is_invariant(tgt_level, m_lemmas.get(i), solver_level)) {
             m_lemmas [i]->set_level (solver_level);
             m_pt.add_lemma_core (m_lemmas.get(i));
 
@@ -2228,6 +2363,7 @@ void pred_transformer::frames::simplify_formulas ()
         m_lemmas.append(new_lemmas);
         m_sorted = false;
         sort();
+        reindex();
     }
 }
 
@@ -4037,8 +4173,10 @@ void context::new_lemma_eh(pred_transformer &pt, lemma *lem) {
     }
     if (!handle)
         return;
-    if ((is_infty_level(lem->level()) && m_params.spacer_p3_share_invariants()) ||
-        (!is_infty_level(lem->level()) && m_params.spacer_p3_share_lemmas())) {
+    // parallel contexts share all lemmas
+    bool share_all = m_params.spacer_threads() > 1;
+    if ((is_infty_level(lem->level()) && (share_all || m_params.spacer_p3_share_invariants())) ||
+        (!is_infty_level(lem->level()) && (share_all || m_params.spacer_p3_share_lemmas()))) {
         expr_ref_vector args(m);
         for (unsigned i = 0; i < pt.sig_size(); ++i) {
             args.push_back(m.mk_const(pt.get_manager().o2n(pt.sig(i), 0)));
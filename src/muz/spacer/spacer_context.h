@@ -214,6 +214,9 @@ class pred_transformer {
         unsigned m_num_is_invariant; // num of times lemmas are pushed
         unsigned m_num_lemma_level_jump; // lemma learned at higher level than expected
         unsigned m_num_reach_queries;
+        unsigned m_num_subsumed_lemmas; // new lemmas dropped because a stronger lemma exists
+        unsigned m_num_removed_lemmas; // active lemmas removed by a stronger new lemma
+        unsigned m_num_subsumed_pushes; // lemmas pushed without a solver call
 
         stats() { reset(); }
         void reset() { memset(this, 0, sizeof(*this)); }
@@ -232,7 +235,16 @@ class pred_transformer {
         bool m_sorted;                     // true if m_lemmas is sorted by m_lt
         lemma_lt_proc m_lt;                // sort order for m_lemmas
 
+        // index of the active lemmas
+        obj_map<expr, lemma*> m_expr2lemma;              // by formula
+        obj_map<expr, ptr_vector<lemma> > m_lit2lemmas;  // ground lemmas by the literals of their cubes
+
         void sort ();
+        void index_lemma(lemma *l);
+        void unindex_lemma(lemma *l);
+        void reindex();
+        lemma *find_subsumer(lemma *l, unsigned min_level);
+        void remove_subsumed(lemma *l);
 
     public:
         frames (pred_transformer &pt) : m_pt (pt),
@@ -35,6 +35,7 @@ Revision History:
 #include "ast/scoped_proof.h"
 #include "muz/transforms/dl_transforms.h"
 #include "muz/spacer/spacer_callback.h"
+#include "muz/spacer/spacer_parallel.h"
 
 using namespace spacer;
 
@@ -164,7 +165,12 @@ lbool dl_interface::query(expr * query)
         return l_false;
     }
 
-    return m_context->solve(m_ctx.get_params().spacer_min_level());
+    unsigned min_level = m_ctx.get_params().spacer_min_level();
+    if (m_ctx.get_params().spacer_threads() > 1) {
+        parallel_solver ps(m_ctx, *m_context, m_spacer_rules, query_pred, m_ctx.get_params().spacer_threads());
+        return ps.solve(min_level);
+    }
+    return m_context->solve(min_level);
 
 }
 
@@ -0,0 +1,247 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    spacer_parallel.cpp
+
+Abstract:
+
+    Parallel SPACER with lemma sharing.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#include "util/thread_pool.h"
+#include "util/scoped_ptr_vector.h"
+#include "ast/ast_translation.h"
+#include "ast/ast_util.h"
+#include "smt/params/smt_params.h"
+#include "muz/base/dl_context.h"
+#include "muz/spacer/spacer_util.h"
+#include "muz/spacer/spacer_parallel.h"
+
+namespace spacer {
+
+    lemma_store::lemma_store(ast_manager& src):
+        m(src, true),
+        m_pinned(m),
+        m_num_published(0) {}
+
+    void lemma_store::publish(ast_manager& src, expr* lemma, unsigned level, unsigned source) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ast_translation tr(src, m, false);
+        expr* e = tr(lemma);
+        unsigned old_level;
+        if (!m_levels.find(e, old_level) || old_level < level) {
+            m_pinned.push_back(e);
+            m_levels.insert(e, level);
+            m_entries.push_back(entry{e, level, source});
+            ++m_num_published;
+        }
+    }
+
+    void lemma_store::fetch(ast_manager& dst, unsigned source, unsigned& pos,
+                            expr_ref_vector& lemmas, unsigned_vector& levels) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ast_translation tr(m, dst, false);
+        for (; pos < m_entries.size(); ++pos) {
+            entry const& e = m_entries[pos];
+            if (e.m_source != source) {
+                lemmas.push_back(tr(e.m_lemma));
+                levels.push_back(e.m_level);
+            }
+        }
+    }
+
+    void lemma_sharing_callback::new_lemma_eh(expr* lemma, unsigned level) {
+        // lemmas over skolem constants of quantified lemmas are local to the context
+        if (!has_quantifiers(lemma)) {
+            m_store.publish(m_context.get_ast_manager(), lemma, level, m_id);
+        }
+    }
+
+    void lemma_sharing_callback::import() {
+        ast_manager& m = m_context.get_ast_manager();
+        expr_ref_vector lemmas(m);
+        unsigned_vector levels;
+        m_store.fetch(m, m_id, m_pos, lemmas, levels);
+        for (unsigned i = 0; i < lemmas.size(); ++i) {
+            m_context.add_constraint(lemmas.get(i), levels[i]);
+        }
+    }
+
+    namespace {
+        /**
+           \brief Helper contexts do not create engines of their own.
+        */
+        class helper_register_engine : public datalog::register_engine_base {
+        public:
+            datalog::engine_base* mk_engine(datalog::DL_ENGINE engine_type) override { return nullptr; }
+            void set_context(datalog::context* ctx) override {}
+        };
+    }
+
+    /**
+       \brief A SPACER context with its own ast_manager and a copy of the rules.
+    */
+    class parallel_solver::helper {
+        ast_manager                  m;
+        smt_params                   m_fparams;
+        params_ref                   m_params;
+        helper_register_engine       m_register_engine;
+        datalog::context             m_ctx;
+        datalog::rule_set            m_rules;
+        scoped_ptr<spacer::context>  m_spacer;
+    public:
+        helper(datalog::context& ctx, datalog::rule_set& rules, func_decl* query_pred,
+               lemma_store& store, unsigned id):
+            m(ctx.get_manager(), false),
+            m_fparams(ctx.get_fparams()),
+            m_ctx(m, m_register_engine, m_fparams, ctx.get_params().p),
+            m_rules(m_ctx) {
+            // diversify the order in which the proof obligations are explored
+            m_params.copy(ctx.get_params().p);
+            m_params.set_uint("spacer.random_seed", ctx.get_params().spacer_random_seed() + id);
+            m_params.set_uint("spacer.order_children", id % 3);
+            m_ctx.updt_params(m_params);
+
+            ast_translation tr(ctx.get_manager(), m);
+            datalog::rule_manager& rm = m_ctx.get_rule_manager();
+            for (datalog::rule* r : rules) {
+                m_ctx.register_predicate(tr(r->get_decl()), false);
+                for (unsigned i = 0; i < r->get_uninterpreted_tail_size(); ++i) {
+                    m_ctx.register_predicate(tr(r->get_decl(i)), false);
+                }
+            }
+            for (datalog::rule* r : rules) {
+                app_ref head(tr(r->get_head()), m);
+                app_ref_vector tail(m);
+                svector<bool> is_neg;
+                for (unsigned i = 0; i < r->get_tail_size(); ++i) {
+                    tail.push_back(tr(r->get_tail(i)));
+                    is_neg.push_back(r->is_neg_tail(i));
+                }
+                m_rules.add_rule(rm.mk(head, tail.size(), tail.c_ptr(), is_neg.c_ptr(), r->name(), false));
+            }
+            func_decl* q = tr(query_pred);
+            m_rules.set_output_predicate(q);
+            m_rules.close();
+
+            m_spacer = alloc(spacer::context, m_ctx.get_params(), m);
+            m_spacer->set_query(q);
+            m_spacer->update_rules(m_rules);
+            m_spacer->callbacks().push_back(alloc(lemma_sharing_callback, *m_spacer, store, id));
+        }
+
+        ast_manager& get_manager() { return m; }
+
+        lbool solve(unsigned from_lvl) { return m_spacer->solve(from_lvl); }
+
+        /**
+           \brief The lemmas at the infinite level form an inductive invariant
+           once the query is unreachable. The invariant of a predicate is
+           published as one lemma per clause, as the contexts only keep clauses
+           as lemmas.
+        */
+        void publish_invariant(lemma_store& store, unsigned id) {
+            expr_ref inv = m_spacer->get_constraints(infty_level());
+            expr_ref_vector invs(m), clauses(m);
+            flatten_and(inv, invs);
+            for (expr* e : invs) {
+                expr *pred, *body;
+                VERIFY(m.is_implies(e, pred, body));
+                clauses.reset();
+                flatten_and(body, clauses);
+                for (expr* c : clauses) {
+                    expr_ref lemma(m.mk_implies(pred, c), m);
+                    store.publish(m, lemma, infty_level(), id);
+                }
+            }
+        }
+    };
+
+    lbool parallel_solver::solve(unsigned from_lvl) {
+        thread_pool& pool = thread_pool::get();
+        // every context needs a thread of its own, the calling thread takes one of them
+        unsigned num_threads = std::min(m_num_threads, pool.num_workers() + 1);
+        if (thread_pool::in_parallel() || num_threads <= 1) {
+            return m_main.solve(from_lvl);
+        }
+
+        ast_manager& m = m_ctx.get_manager();
+        lemma_store store(m);
+        scoped_ptr_vector<helper> helpers;
+        scoped_limits scl(m.limit());
+        for (unsigned i = 1; i < num_threads; ++i) {
+            helpers.push_back(alloc(helper, m_ctx, m_rules, m_query_pred, store, i));
+            scl.push_child(&helpers.back()->get_manager().limit());
+        }
+        m_main.callbacks().push_back(alloc(lemma_sharing_callback, m_main, store, 0));
+
+        lbool result = l_undef;
+        bool main_done = false;
+        bool main_failed = false;
+        bool is_error = false;
+        std::string ex_msg;
+        unsigned error_code = 0;
+        std::mutex mux;
+
+        thread_pool::task_group tasks(pool);
+        tasks.add([&]() {
+            try {
+                result = m_main.solve(from_lvl);
+            }
+            catch (z3_error & err) {
+                main_failed = true;
+                is_error = true;
+                error_code = err.error_code();
+            }
+            catch (z3_exception & ex) {
+                main_failed = true;
+                ex_msg = ex.msg();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mux);
+                main_done = true;
+            }
+            for (unsigned j = 0; j < helpers.size(); ++j) {
+                helpers[j]->get_manager().limit().cancel();
+            }
+        });
+        for (unsigned i = 1; i < num_threads; ++i) {
+            tasks.add([&, i]() {
+                {
+                    std::lock_guard<std::mutex> lock(mux);
+                    if (main_done)
+                        return;
+                }
+                helper& h = *helpers[i - 1];
+                try {
+                    lbool r = h.solve(from_lvl);
+                    IF_VERBOSE(1, verbose_stream() << "(spacer.parallel :helper " << i << " :result " << r << ")\n";);
+                    if (r == l_false) {
+                        h.publish_invariant(store, i);
+                    }
+                }
+                catch (z3_exception &) {
+                    // helpers are canceled when the main context finishes
+                }
+            });
+        }
+        tasks.wait();
+
+        m_main.callbacks().pop_back();
+        IF_VERBOSE(1, verbose_stream() << "(spacer.parallel :shared-lemmas " << store.num_published() << ")\n";);
+        if (main_failed) {
+            if (is_error) throw z3_error(error_code);
+            throw default_exception(std::move(ex_msg));
+        }
+        return result;
+    }
+}
@@ -0,0 +1,128 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    spacer_parallel.h
+
+Abstract:
+
+    Parallel SPACER with lemma sharing.
+
+    With spacer.threads > 1 the query is solved by the main SPACER
+    context together with helper contexts. Every helper has its own
+    ast_manager and a copy of the rules, and it explores the proof
+    obligations in a different order (spacer.order_children and
+    spacer.random_seed are diversified). The contexts run as tasks of the
+    shared thread pool, so there are at most as many contexts as the pool
+    has workers, plus one.
+
+    The contexts publish every lemma they learn, tagged with its
+    predicate and frame level, to a lemma store, and import the lemmas of
+    the other contexts whenever they enter a new level or expand a proof
+    obligation. Frame lemmas are valid for every context, since all of them
+    solve the same rules.
+
+    The answer is always produced by the main context, so models,
+    certificates and proofs are available as in the sequential mode. When
+    a helper proves the query unreachable first, its inductive invariant
+    is published, and the main context converges after importing it.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#ifndef _SPACER_PARALLEL_H_
+#define _SPACER_PARALLEL_H_
+
+#include <mutex>
+#include "util/lbool.h"
+#include "util/obj_hashtable.h"
+#include "ast/ast.h"
+#include "muz/base/dl_rule_set.h"
+#include "muz/spacer/spacer_context.h"
+
+namespace spacer {
+
+    /**
+       \brief Lemmas shared between the contexts of a parallel query.
+       The lemmas are stored in a separate ast_manager, as implications
+       pred(x) => lemma over the constants of the signature of pred.
+       All operations are thread safe.
+    */
+    class lemma_store {
+        struct entry {
+            expr*    m_lemma;
+            unsigned m_level;
+            unsigned m_source;
+        };
+        std::mutex           m_mutex;
+        ast_manager          m;
+        expr_ref_vector      m_pinned;
+        svector<entry>       m_entries;
+        obj_map<expr, unsigned> m_levels;   // highest level at which a lemma was published
+        unsigned             m_num_published;
+    public:
+        lemma_store(ast_manager& src);
+
+        /**
+           \brief Publish a lemma of context \c source. A lemma that was already
+           published at the same or a higher level is ignored.
+        */
+        void publish(ast_manager& src, expr* lemma, unsigned level, unsigned source);
+
+        /**
+           \brief Retrieve the lemmas of other contexts published since position \c pos,
+           and advance \c pos.
+        */
+        void fetch(ast_manager& dst, unsigned source, unsigned& pos,
+                   expr_ref_vector& lemmas, unsigned_vector& levels);
+
+        unsigned num_published() const { return m_num_published; }
+    };
+
+    /**
+       \brief Connect a context to the lemma store.
+    */
+    class lemma_sharing_callback : public spacer_callback {
+        lemma_store& m_store;
+        unsigned     m_id;
+        unsigned     m_pos;
+        void import();
+    public:
+        lemma_sharing_callback(context& ctx, lemma_store& store, unsigned id):
+            spacer_callback(ctx), m_store(store), m_id(id), m_pos(0) {}
+
+        bool new_lemma() override { return true; }
+        void new_lemma_eh(expr* lemma, unsigned level) override;
+        bool predecessor() override { return true; }
+        void predecessor_eh() override { import(); }
+        bool unfold() override { return true; }
+        void unfold_eh() override { import(); }
+    };
+
+    class parallel_solver {
+        class helper;
+        datalog::context&  m_ctx;
+        context&           m_main;
+        datalog::rule_set& m_rules;
+        func_decl*         m_query_pred;
+        unsigned           m_num_threads;
+    public:
+        parallel_solver(datalog::context& ctx, context& main, datalog::rule_set& rules,
+                        func_decl* query_pred, unsigned num_threads):
+            m_ctx(ctx), m_main(main), m_rules(rules), m_query_pred(query_pred), m_num_threads(num_threads) {}
+
+        /**
+           \brief Solve the query of the main context with the helper contexts.
+           The main context must be initialized with the rules.
+        */
+        lbool solve(unsigned from_lvl);
+    };
+}
+
+#endif
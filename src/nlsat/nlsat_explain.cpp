@@ -904,37 +904,38 @@ namespace nlsat {
                 // Otherwise, the isolate_roots procedure will assume p is a constant polynomial.
                 m_am.isolate_roots(p, undef_var_assignment(m_assignment, y), roots);
                 unsigned num_roots = roots.size();
-                for (unsigned i = 0; i < num_roots; i++) {
-                    TRACE("nlsat_explain", tout << "comparing root: "; m_am.display_decimal(tout, roots[i]); tout << "\n";);
-                    int s = m_am.compare(y_val, roots[i]);
-                    if (s == 0) {
-                        // y_val == roots[i]
-                        // add literal
-                        // ! (y = root_i(p))
-                        add_root_literal(atom::ROOT_EQ, y, i+1, p);
-                        return;
-                    }
-                    else if (s < 0) {
-                        // y_val < roots[i]
-                        
-                        // check if roots[i] is a better upper bound
-                        if (upper_inf || m_am.lt(roots[i], upper)) {
-                            upper_inf = false;
-                            m_am.set(upper, roots[i]);
-                            p_upper = p;
-                            i_upper = i+1;
-                        }
+                // roots are sorted, so only the roots adjacent to y_val can be the
+                // best bounds; locate y_val using a binary search.
+                bool is_root;
+                unsigned i = m_am.locate(y_val, roots, is_root);
+                TRACE("nlsat_explain", tout << "located at: " << i << " of " << num_roots << "\n";);
+                if (is_root) {
+                    // y_val == roots[i]
+                    // add literal
+                    // ! (y = root_i(p))
+                    add_root_literal(atom::ROOT_EQ, y, i+1, p);
+                    return;
+                }
+                if (i < num_roots) {
+                    // y_val < roots[i]
+
+                    // check if roots[i] is a better upper bound
+                    if (upper_inf || m_am.lt(roots[i], upper)) {
+                        upper_inf = false;
+                        m_am.set(upper, roots[i]);
+                        p_upper = p;
+                        i_upper = i+1;
                     }
-                    else if (s > 0) {
-                        // roots[i] < y_val
-
-                        // check if roots[i] is a better lower bound
-                        if (lower_inf || m_am.lt(lower, roots[i])) {
-                            lower_inf = false;
-                            m_am.set(lower, roots[i]);
-                            p_lower = p;
-                            i_lower = i+1;
-                        }
+                }
+                if (i > 0) {
+                    // roots[i-1] < y_val
+
+                    // check if roots[i-1] is a better lower bound
+                    if (lower_inf || m_am.lt(lower, roots[i-1])) {
+                        lower_inf = false;
+                        m_am.set(lower, roots[i-1]);
+                        p_lower = p;
+                        i_lower = i;
                     }
                 }
             }
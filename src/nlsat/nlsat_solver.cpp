@@ -1889,6 +1889,8 @@ namespace nlsat {
             st.update("nlsat decisions", m_decisions);
             st.update("nlsat stages", m_stages);
             st.update("nlsat irrational assignments", m_irrational_assignments);
+            m_am.collect_statistics(st);
+            m_cache.collect_statistics(st);
         }
 
         void reset_statistics() {
@@ -1897,6 +1899,8 @@ namespace nlsat {
             m_decisions              = 0;
             m_stages                 = 0;
             m_irrational_assignments = 0;
+            m_am.reset_statistics();
+            m_cache.reset_statistics();
         }
 
         // -----------------------
@@ -140,6 +140,9 @@ namespace sat {
             if (a == b) return false_bdd;
             if (is_false(a)) return b;
             if (is_false(b)) return a;
+            // the constants share level 0 with the first variable
+            if (is_true(a)) return mk_not_rec(b);
+            if (is_true(b)) return mk_not_rec(a);
             break;
         default:
             UNREACHABLE();
@@ -540,7 +543,7 @@ namespace sat {
         return bdd(m_var2bdd[2*i+1], this);
     }
 
-    bdd bdd_manager::mk_not(bdd b) {
+    bdd bdd_manager::mk_not(bdd const& b) {
         bool first = true;
         while (true) {
             try {
@@ -641,7 +644,10 @@ namespace sat {
     bdd_manager::BDD bdd_manager::mk_quant(unsigned n, unsigned const* vars, BDD b, bdd_op op) {
         BDD result = b;
         for (unsigned i = 0; i < n; ++i) {
+            // protect the intermediate result from garbage collection
+            push(result);
             result = mk_quant_rec(m_var2level[vars[i]], result, op);
+            pop(1);
         }
         return result;
     }
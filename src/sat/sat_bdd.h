@@ -102,7 +102,7 @@ namespace sat {
 
         struct eq_entry {
             bool operator()(op_entry * a, op_entry * b) const { 
-                return a->m_bdd1 == b->m_bdd2 && a->m_bdd2 == b->m_bdd2 && a->m_op == b->m_op;
+                return a->m_bdd1 == b->m_bdd1 && a->m_bdd2 == b->m_bdd2 && a->m_op == b->m_op;
             }
         };
 
@@ -185,7 +185,7 @@ namespace sat {
         double cnf_size(BDD b) { return count(b, 1); }
         unsigned bdd_size(bdd const& b);
 
-        bdd mk_not(bdd b);
+        bdd mk_not(bdd const& b);
         bdd mk_and(bdd const& a, bdd const& b);
         bdd mk_or(bdd const& a, bdd const& b);
         bdd mk_xor(bdd const& a, bdd const& b);
@@ -227,7 +227,7 @@ namespace sat {
         bdd_manager* m;
         bdd(unsigned root, bdd_manager* m): root(root), m(m) { m->inc_ref(root); }
     public:
-        bdd(bdd & other): root(other.root), m(other.m) { m->inc_ref(root); }
+        bdd(bdd const & other): root(other.root), m(other.m) { m->inc_ref(root); }
         bdd(bdd && other): root(0), m(other.m) { std::swap(root, other.root); }
         bdd& operator=(bdd const& other);
         ~bdd() { m->dec_ref(root); }
@@ -238,10 +238,10 @@ namespace sat {
         bool is_true() const { return root == bdd_manager::true_bdd; }
         bool is_false() const { return root == bdd_manager::false_bdd; }        
 
-        bdd operator!() { return m->mk_not(*this); }
-        bdd operator&&(bdd const& other) { return m->mk_and(*this, other); }
-        bdd operator||(bdd const& other) { return m->mk_or(*this, other); }
-        bdd operator^(bdd const& other) { return m->mk_xor(*this, other); }
+        bdd operator!() const { return m->mk_not(*this); }
+        bdd operator&&(bdd const& other) const { return m->mk_and(*this, other); }
+        bdd operator||(bdd const& other) const { return m->mk_or(*this, other); }
+        bdd operator^(bdd const& other) const { return m->mk_xor(*this, other); }
         bdd operator|=(bdd const& other) { return *this = *this || other; }
         bdd operator&=(bdd const& other) { return *this = *this && other; }
         std::ostream& display(std::ostream& out) const { return m->display(out, *this); }
@@ -91,6 +91,7 @@ public:
         void flush_smc(sat::solver& s, atom2bool_var const& map);         
         void operator()(model_ref& md) override;
         void operator()(expr_ref& fml) override; 
+        bool supports_formulas() const override { return true; }
         model_converter* translate(ast_translation& translator) override;
         void set_env(ast_pp_util* visitor) override;
         void display(std::ostream& out) override;
@@ -80,6 +80,7 @@ void run_solver(lp_params & params, char const * mps_file_name) {
     solver->settings().set_message_ostream(&std::cout);
     solver->settings().report_frequency = params.rep_freq();
     solver->settings().print_statistics = params.print_stats();
+    solver->settings().lu_refactor_period = params.lu_refactor_period();
     solver->settings().simplex_strategy() = lp:: simplex_strategy_enum::lu;
 
     solver->find_maximal_solution();
@@ -22,6 +22,8 @@ Revision History:
 #include "ast/for_each_expr.h"
 #include "ast/well_sorted.h"
 #include "ast/rewriter/rewriter_def.h"
+#include "ast/rewriter/rewriter_params.hpp"
+#include "ast/rewriter/par_rewriter.h"
 #include "ast/normal_forms/nnf.h"
 #include "ast/pattern/pattern_inference.h"
 #include "ast/macros/quasi_macros.h"
@@ -41,6 +43,7 @@ asserted_formulas::asserted_formulas(ast_manager & m, smt_params & sp, params_re
     m_bv_sharing(m),
     m_inconsistent(false),
     m_has_quantifiers(false),
+    m_num_rewrite_steps(0),
     m_reduce_asserted_formulas(*this),
     m_distribute_forall(*this),
     m_pattern_inference(*this),
@@ -316,6 +319,7 @@ void asserted_formulas::display_ll(std::ostream & out, ast_mark & pp_visited) co
 }
 
 void asserted_formulas::collect_statistics(statistics & st) const {
+    st.update("asserted formulas rewrite steps", m_num_rewrite_steps);
 }
 
 
@@ -419,6 +423,35 @@ void asserted_formulas::simplify_fmls::operator()() {
 }
 
 
+void asserted_formulas::reduce_asserted_formulas_fn::simplify(justified_expr const& j, expr_ref& n, proof_ref& p) {
+    if (m_next < m_results.size()) {
+        n = m_results.get(m_next++);
+        return;
+    }
+    af.m_rewriter(j.get_fml(), n, p);
+    af.m_num_rewrite_steps += af.m_rewriter.get_num_steps();
+}
+
+/**
+   \brief Rewrite the formulas with rewriter.threads threads when no substitution is in use.
+   The results are then taken up by simplify in the order of the formulas.
+*/
+void asserted_formulas::reduce_asserted_formulas_fn::operator()() {
+    rewriter_params rp(af.m_params);
+    m_results.reset();
+    m_next = 0;
+    if (rp.threads() > 1 && !m.proofs_enabled() && af.m_substitution.empty()) {
+        unsigned sz = af.m_formulas.size();
+        for (unsigned i = af.m_qhead; i < sz; i++)
+            m_results.push_back(af.m_formulas[i].get_fml());
+        if (!par_rewrite(m, af.m_params, rp.threads(), m_results, af.m_num_rewrite_steps))
+            m_results.reset();
+    }
+    simplify_fmls::operator()();
+    m_results.reset();
+    m_next = 0;
+}
+
 void asserted_formulas::reduce_and_solve() {
     IF_VERBOSE(10, verbose_stream() << "(smt.reducing)\n";);
     flush_cache(); // collect garbage
@@ -58,6 +58,7 @@ class asserted_formulas {
     maximize_bv_sharing_rw      m_bv_sharing;
     bool                        m_inconsistent;
     bool                        m_has_quantifiers;
+    unsigned                    m_num_rewrite_steps;
     struct scope {
         unsigned                m_formulas_lim;
         bool                    m_inconsistent_old;
@@ -80,9 +81,12 @@ class asserted_formulas {
     };
 
     class reduce_asserted_formulas_fn : public simplify_fmls {
+        expr_ref_vector m_results; // results of rewriting the formulas in parallel
+        unsigned        m_next;
     public:
-        reduce_asserted_formulas_fn(asserted_formulas& af): simplify_fmls(af, "reduce-asserted") {}
-        void simplify(justified_expr const& j, expr_ref& n, proof_ref& p) override { af.m_rewriter(j.get_fml(), n, p); }
+        reduce_asserted_formulas_fn(asserted_formulas& af): simplify_fmls(af, "reduce-asserted"), m_results(af.m), m_next(0) {}
+        void simplify(justified_expr const& j, expr_ref& n, proof_ref& p) override;
+        void operator()() override;
     };
 
     class find_macros_fn : public simplify_fmls {
@@ -314,6 +314,8 @@ class theory_lra::imp {
         m_solver->settings().simplex_strategy() = static_cast<lp::simplex_strategy_enum>(lp.simplex_strategy());
         m_solver->settings().bound_propagation() = BP_NONE != propagation_mode();
         m_solver->settings().m_enable_hnf = lp.enable_hnf();
+        m_solver->settings().lu_refactor_period = lp.lu_refactor_period();
+        m_solver->settings().set_dual_pricing_in_tableau_rows(lp.dual_pricing());
         m_solver->set_track_pivoted_rows(lp.bprop_on_pivoted_rows());
 
         // todo : do not use m_arith_branch_cut_ratio for deciding on cheap cuts
@@ -3411,6 +3413,8 @@ public:
         st.update("arith-propagations", m_stats.m_bounds_propagations);
         st.update("arith-iterations", m_stats.m_num_iterations);
         st.update("arith-factorizations", m_solver->settings().st().m_num_factorizations);
+        st.update("arith-lu-updates", m_solver->settings().st().m_lu_updates);
+        st.update("arith-lu-fill-in", m_solver->settings().st().m_lu_fill_in);
         st.update("arith-pivots", m_stats.m_need_to_solve_inf);
         st.update("arith-plateau-iterations", m_stats.m_num_iterations_with_no_progress);
         st.update("arith-fixed-eqs", m_stats.m_fixed_eqs);
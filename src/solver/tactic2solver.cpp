@@ -22,7 +22,9 @@ Notes:
 #include "solver/tactic2solver.h"
 #include "solver/solver_na2as.h"
 #include "tactic/tactic.h"
+#include "tactic/tactical.h"
 #include "ast/ast_translation.h"
+#include "ast/decl_collector.h"
 #include "solver/mus.h"
 
 /**
@@ -31,23 +33,75 @@ Notes:
    Every query will be solved from scratch.  So, this is not a good
    option for applications trying to solve many easy queries that a
    similar to each other.
+
+   If a preprocessing tactic is given, it is applied only to the
+   assertions that were added since the previous query, and the
+   result is cached per scope. The main tactic is then applied to the
+   cached formulas. Symbols of the cached formulas are frozen: if
+   the preprocessing of new assertions eliminates a frozen symbol, the
+   cache is rolled back to the batch of assertions where the symbol
+   occurred first, and this batch is preprocessed again together with
+   the new assertions. If new assertions contain a symbol that was
+   eliminated before, the definition of the symbol is moved from the
+   model converter to the new assertions, provided the model converter
+   supports formulas; otherwise the cache is rolled back.
+
+   This is sound only if the preprocessing tactic records every step
+   that does not produce an equivalent goal in its model converter.
 */
 
 namespace {
 class tactic2solver : public solver_na2as {
+    struct preprocess_scope {
+        unsigned            m_head;
+        unsigned            m_preprocessed_lim;
+        unsigned            m_symbols_lim;
+        unsigned            m_batches_lim;
+        model_converter_ref m_mc;
+    };
+
+    struct symbol_update {
+        func_decl * m_f;
+        unsigned    m_batch;        // UINT_MAX if the symbol was not frozen before the update
+        bool        m_eliminated;
+    };
+
     expr_ref_vector              m_assertions;
     unsigned_vector              m_scopes;
     ref<simple_check_sat_result> m_result;
     tactic_ref                   m_tactic;
+    tactic_ref                   m_preprocess;
+    // cache of the preprocessing tactic: m_preprocessed is the result for the assertions before m_head.
+    unsigned                     m_head;
+    expr_ref_vector              m_preprocessed;
+    model_converter_ref          m_preprocess_mc;
+    obj_map<func_decl, unsigned> m_symbol2batch;    // frozen symbols, mapped to the batch where they occur first
+    obj_hashtable<func_decl>     m_eliminated;      // symbols defined by m_preprocess_mc
+    svector<symbol_update>       m_symbols_trail;
+    func_decl_ref_vector         m_pinned;
+    vector<preprocess_scope>     m_batches;         // state before every batch of preprocessed assertions
+    vector<preprocess_scope>     m_preprocess_scopes;
     ref<model_converter>         m_mc;
     symbol                       m_logic;
     bool                         m_produce_models;
     bool                         m_produce_proofs;
     bool                         m_produce_unsat_cores;
     statistics                   m_stats;
+
+    void save_preprocess_scope(preprocess_scope & s) const;
+    void restore_preprocess_scope(preprocess_scope const & s);
+    void reset_preprocess();
+    void rollback_preprocess(unsigned batch);
+    void set_symbol(func_decl * f, unsigned batch, bool eliminated);
+    unsigned conflict_batch(unsigned num, expr * const * fmls);
+    void collect_defined(model_converter * mc, obj_hashtable<func_decl> & defined);
+    bool reinsert_definitions(expr_ref_vector & fmls, model_converter_ref & mc, obj_hashtable<func_decl> & reinserted);
+    bool preprocess(unsigned end, unsigned & conflict);
+    bool preprocess_assertions();
+    bool has_eliminated(unsigned num_assumptions, expr * const * assumptions);
     
 public:
-    tactic2solver(ast_manager & m, tactic * t, params_ref const & p, bool produce_proofs, bool produce_models, bool produce_unsat_cores, symbol const & logic);
+    tactic2solver(ast_manager & m, tactic * pre, tactic * t, params_ref const & p, bool produce_proofs, bool produce_models, bool produce_unsat_cores, symbol const & logic);
     ~tactic2solver() override;
 
     solver* translate(ast_manager& m, params_ref const& p) override;
@@ -89,11 +143,15 @@ public:
 
 ast_manager& tactic2solver::get_manager() const { return m_assertions.get_manager(); }
 
-tactic2solver::tactic2solver(ast_manager & m, tactic * t, params_ref const & p, bool produce_proofs, bool produce_models, bool produce_unsat_cores, symbol const & logic):
+tactic2solver::tactic2solver(ast_manager & m, tactic * pre, tactic * t, params_ref const & p, bool produce_proofs, bool produce_models, bool produce_unsat_cores, symbol const & logic):
     solver_na2as(m),
-    m_assertions(m) {
+    m_assertions(m),
+    m_head(0),
+    m_preprocessed(m),
+    m_pinned(m) {
 
     m_tactic = t;
+    m_preprocess = pre;
     m_logic  = logic;
     solver::updt_params(p);
     
@@ -112,6 +170,8 @@ void tactic2solver::updt_params(params_ref const & p) {
 void tactic2solver::collect_param_descrs(param_descrs & r) {
     if (m_tactic.get())
         m_tactic->collect_param_descrs(r);
+    if (m_preprocess.get())
+        m_preprocess->collect_param_descrs(r);
 }
 
 void tactic2solver::assert_expr_core(expr * t) {
@@ -122,6 +182,8 @@ void tactic2solver::assert_expr_core(expr * t) {
 
 void tactic2solver::push_core() {
     m_scopes.push_back(m_assertions.size());
+    m_preprocess_scopes.push_back(preprocess_scope());
+    save_preprocess_scope(m_preprocess_scopes.back());
     m_result = nullptr;
     TRACE("pop", tout << m_scopes.size() << "\n";);
 }
@@ -133,9 +195,233 @@ void tactic2solver::pop_core(unsigned n) {
     unsigned old_sz  = m_scopes[new_lvl];
     m_assertions.shrink(old_sz);
     m_scopes.shrink(new_lvl);
+    restore_preprocess_scope(m_preprocess_scopes[new_lvl]);
+    m_preprocess_scopes.shrink(new_lvl);
     m_result = nullptr;
 }
 
+void tactic2solver::save_preprocess_scope(preprocess_scope & s) const {
+    s.m_head             = m_head;
+    s.m_preprocessed_lim = m_preprocessed.size();
+    s.m_symbols_lim      = m_symbols_trail.size();
+    s.m_batches_lim      = m_batches.size();
+    s.m_mc               = m_preprocess_mc.get();
+}
+
+void tactic2solver::restore_preprocess_scope(preprocess_scope const & s) {
+    m_head = s.m_head;
+    m_preprocessed.shrink(s.m_preprocessed_lim);
+    for (unsigned i = m_symbols_trail.size(); i-- > s.m_symbols_lim; ) {
+        symbol_update const & u = m_symbols_trail[i];
+        if (u.m_batch == UINT_MAX)
+            m_symbol2batch.erase(u.m_f);
+        else
+            m_symbol2batch.insert(u.m_f, u.m_batch);
+        if (u.m_eliminated)
+            m_eliminated.insert(u.m_f);
+        else
+            m_eliminated.erase(u.m_f);
+    }
+    m_symbols_trail.shrink(s.m_symbols_lim);
+    m_pinned.shrink(s.m_symbols_lim);
+    m_batches.shrink(s.m_batches_lim);
+    m_preprocess_mc = s.m_mc.get();
+}
+
+void tactic2solver::reset_preprocess() {
+    if (m_batches.empty())
+        return;
+    rollback_preprocess(0);
+}
+
+/**
+   \brief Restore the cache to the state before the given batch.
+   Scopes that were saved after this batch are moved back as well.
+*/
+void tactic2solver::rollback_preprocess(unsigned batch) {
+    restore_preprocess_scope(m_batches[batch]);
+    for (preprocess_scope & s : m_preprocess_scopes)
+        if (s.m_head > m_head)
+            save_preprocess_scope(s);
+}
+
+void tactic2solver::set_symbol(func_decl * f, unsigned batch, bool eliminated) {
+    symbol_update u;
+    u.m_f = f;
+    u.m_batch = UINT_MAX;
+    m_symbol2batch.find(f, u.m_batch);
+    u.m_eliminated = m_eliminated.contains(f);
+    m_symbols_trail.push_back(u);
+    m_pinned.push_back(f);
+    m_symbol2batch.insert(f, batch);
+    if (eliminated)
+        m_eliminated.insert(f);
+    else
+        m_eliminated.erase(f);
+}
+
+/**
+   \brief Return the first batch that eliminated a symbol of \c fmls, or UINT_MAX if there is none.
+*/
+unsigned tactic2solver::conflict_batch(unsigned num, expr * const * fmls) {
+    decl_collector symbols(get_manager());
+    for (unsigned i = 0; i < num; ++i)
+        symbols.visit(fmls[i]);
+    unsigned conflict = UINT_MAX, batch = 0;
+    for (unsigned i = 0; i < symbols.get_num_decls(); ++i) {
+        func_decl * f = symbols.get_func_decls()[i];
+        if (m_eliminated.contains(f) && m_symbol2batch.find(f, batch) && batch < conflict)
+            conflict = batch;
+    }
+    return conflict;
+}
+
+/**
+   \brief Collect the symbols that \c mc assigns, which are the symbols eliminated by the tactics that produced \c mc.
+*/
+void tactic2solver::collect_defined(model_converter * mc, obj_hashtable<func_decl> & defined) {
+    if (!mc)
+        return;
+    model_ref md = alloc(model, get_manager());
+    (*mc)(md);
+    for (unsigned i = 0; i < md->get_num_constants(); ++i)
+        defined.insert(md->get_constant(i));
+    for (unsigned i = 0; i < md->get_num_functions(); ++i)
+        defined.insert(md->get_function(i));
+}
+
+/**
+   \brief Add to \c fmls the definitions of eliminated symbols they contain.
+   The definitions are removed from a copy of \c mc, such that the cached model converter
+   remains valid for the scopes that do not contain \c fmls.
+*/
+bool tactic2solver::reinsert_definitions(expr_ref_vector & fmls, model_converter_ref & mc, obj_hashtable<func_decl> & reinserted) {
+    if (!mc || !mc->supports_formulas()) {
+        TRACE("tactic2solver", tout << "the model converter does not support formulas\n";);
+        return false;
+    }
+    ast_manager & m = get_manager();
+    ast_translation tr(m, m, false);
+    model_converter_ref copy = mc->translate(tr);
+    expr_ref_vector result(m);
+    for (expr * f : fmls) {
+        expr_ref fml(f, m);
+        (*copy)(fml);
+        result.push_back(fml);
+    }
+    obj_hashtable<func_decl> before, after;
+    collect_defined(mc.get(), before);
+    collect_defined(copy.get(), after);
+    decl_collector symbols(m);
+    for (expr * f : result)
+        symbols.visit(f);
+    obj_hashtable<func_decl> occurs;
+    for (unsigned i = 0; i < symbols.get_num_decls(); ++i)
+        occurs.insert(symbols.get_func_decls()[i]);
+    for (func_decl * f : before) {
+        if (after.contains(f))
+            continue;
+        if (!occurs.contains(f))
+            return false;
+        reinserted.insert(f);
+    }
+    for (func_decl * f : occurs) {
+        if (after.contains(f)) {
+            TRACE("tactic2solver", tout << "definition is not reinserted: " << f->get_name() << "\n";);
+            return false;
+        }
+    }
+    fmls.swap(result);
+    mc = copy;
+    return true;
+}
+
+/**
+   \brief Apply the preprocessing tactic to the assertions in [m_head, end) and add the result to the cache.
+   Return false if the result cannot be combined with the cached formulas. Then \c conflict is the
+   batch to roll back to, or UINT_MAX if the preprocessing tactic does not produce a single goal.
+*/
+bool tactic2solver::preprocess(unsigned end, unsigned & conflict) {
+    conflict = UINT_MAX;
+    if (m_head == end)
+        return true;
+    ast_manager & m = get_manager();
+    expr_ref_vector fmls(m);
+    for (unsigned i = m_head; i < end; ++i)
+        fmls.push_back(m_assertions.get(i));
+    model_converter_ref mc = m_preprocess_mc;
+    obj_hashtable<func_decl> reinserted;
+    unsigned batch = conflict_batch(fmls.size(), fmls.c_ptr());
+    if (batch != UINT_MAX && !reinsert_definitions(fmls, mc, reinserted)) {
+        conflict = batch;
+        return false;
+    }
+    // models are enabled to learn from the model converter which symbols are eliminated.
+    goal_ref g = alloc(goal, m, false, true, false);
+    for (expr * f : fmls)
+        g->assert_expr(f);
+    goal_ref_buffer result;
+    exec(*m_preprocess, g, result);
+    if (result.size() != 1)
+        return false;
+    goal * r = result[0];
+    obj_hashtable<func_decl> eliminated;
+    collect_defined(r->mc(), eliminated);
+    for (func_decl * f : eliminated) {
+        if (!reinserted.contains(f) && m_symbol2batch.find(f, batch) && batch < conflict) {
+            TRACE("tactic2solver", tout << "frozen symbol is eliminated: " << f->get_name() << "\n";);
+            conflict = batch;
+        }
+    }
+    if (conflict != UINT_MAX)
+        return false;
+
+    m_batches.push_back(preprocess_scope());
+    save_preprocess_scope(m_batches.back());
+    batch = m_batches.size() - 1;
+    decl_collector symbols(m);
+    for (expr * f : fmls)
+        symbols.visit(f);
+    for (unsigned i = 0; i < r->size(); ++i) {
+        m_preprocessed.push_back(r->form(i));
+        symbols.visit(r->form(i));
+    }
+    for (unsigned i = 0; i < symbols.get_num_decls(); ++i) {
+        func_decl * f = symbols.get_func_decls()[i];
+        if (reinserted.contains(f) || !m_symbol2batch.contains(f))
+            set_symbol(f, batch, eliminated.contains(f));
+    }
+    m_preprocess_mc = concat(mc.get(), r->mc());
+    m_head = end;
+    return true;
+}
+
+/**
+   \brief Bring the cache up to date with the assertions, scope by scope.
+   Return false if the preprocessing tactic does not produce a single goal.
+*/
+bool tactic2solver::preprocess_assertions() {
+    for (unsigned lvl = 0; lvl <= m_scopes.size(); ++lvl) {
+        unsigned end = lvl < m_scopes.size() ? m_scopes[lvl] : m_assertions.size();
+        if (end < m_head)
+            continue;
+        unsigned conflict;
+        while (!preprocess(end, conflict)) {
+            if (conflict == UINT_MAX)
+                return false;
+            TRACE("tactic2solver", tout << "roll back to batch " << conflict << " of " << m_batches.size() << "\n";);
+            rollback_preprocess(conflict);
+        }
+        if (lvl < m_scopes.size())
+            save_preprocess_scope(m_preprocess_scopes[lvl]);
+    }
+    return true;
+}
+
+bool tactic2solver::has_eliminated(unsigned num_assumptions, expr * const * assumptions) {
+    return conflict_batch(num_assumptions, assumptions) != UINT_MAX;
+}
+
 lbool tactic2solver::check_sat_core(unsigned num_assumptions, expr * const * assumptions) {
     if (m_tactic.get() == nullptr)
         return l_false;
@@ -144,24 +430,50 @@ lbool tactic2solver::check_sat_core(unsigned num_assumptions, expr * const * ass
     m_tactic->cleanup();
     m_tactic->set_logic(m_logic);
     m_tactic->updt_params(get_params()); // parameters are allowed to overwrite logic.
-    goal_ref g = alloc(goal, m, m_produce_proofs, m_produce_models, m_produce_unsat_cores);
-
-    for (expr* e : m_assertions) {
-        g->assert_expr(e);
-    }
-    for (unsigned i = 0; i < num_assumptions; i++) {
-        proof_ref pr(m.mk_asserted(assumptions[i]), m);
-        expr_dependency_ref ans(m.mk_leaf(assumptions[i]), m);    
-        g->assert_expr(assumptions[i], pr, ans);
+    if (m_preprocess) {
+        m_preprocess->cleanup();
+        m_preprocess->set_logic(m_logic);
+        m_preprocess->updt_params(get_params());
     }
+    goal_ref g = alloc(goal, m, m_produce_proofs, m_produce_models, m_produce_unsat_cores);
 
     model_ref           md;
     proof_ref           pr(m);    
     expr_dependency_ref core(m);
     std::string         reason_unknown = "unknown";
     labels_vec labels;
+    bool                cached = false;
     try {
-        switch (::check_sat(*m_tactic, g, md, labels, pr, core, reason_unknown)) {
+        tactic_ref t = m_tactic;
+        if (m_preprocess && !m_produce_proofs) {
+            try {
+                cached = preprocess_assertions() && !has_eliminated(num_assumptions, assumptions);
+            }
+            catch (tactic_exception & ex) {
+                // the cache remains valid, the assertions are preprocessed again below.
+                TRACE("tactic2solver", tout << "preprocessing failed: " << ex.msg() << "\n";);
+            }
+        }
+        if (cached) {
+            for (expr* e : m_preprocessed) {
+                g->assert_expr(e);
+            }
+            if (m_produce_models)
+                g->set(m_preprocess_mc.get());
+        }
+        else {
+            for (expr* e : m_assertions) {
+                g->assert_expr(e);
+            }
+            if (m_preprocess)
+                t = and_then(m_preprocess.get(), m_tactic.get());
+        }
+        for (unsigned i = 0; i < num_assumptions; i++) {
+            proof_ref pr(m.mk_asserted(assumptions[i]), m);
+            expr_dependency_ref ans(m.mk_leaf(assumptions[i]), m);    
+            g->assert_expr(assumptions[i], pr, ans);
+        }
+        switch (::check_sat(*t, g, md, labels, pr, core, reason_unknown)) {
         case l_true: 
             m_result->set_status(l_true);
             break;
@@ -172,9 +484,10 @@ lbool tactic2solver::check_sat_core(unsigned num_assumptions, expr * const * ass
             m_result->set_status(l_undef);
             if (!reason_unknown.empty())
                 m_result->m_unknown = reason_unknown;
-            if (num_assumptions == 0 && m_scopes.empty()) {
+            if (num_assumptions == 0 && m_scopes.empty() && !cached) {
                 m_assertions.reset();
                 g->get_formulas(m_assertions);
+                reset_preprocess();
             }
             break;
         }
@@ -192,6 +505,11 @@ lbool tactic2solver::check_sat_core(unsigned num_assumptions, expr * const * ass
     }
     m_tactic->collect_statistics(m_result->m_stats);
     m_tactic->collect_statistics(m_stats);
+    if (m_preprocess) {
+        m_preprocess->collect_statistics(m_result->m_stats);
+        m_preprocess->collect_statistics(m_stats);
+        m_preprocess->cleanup();
+    }
     m_result->m_model = md;
     m_result->m_proof = pr;
     if (m_produce_unsat_cores) {
@@ -206,7 +524,8 @@ lbool tactic2solver::check_sat_core(unsigned num_assumptions, expr * const * ass
 
 solver* tactic2solver::translate(ast_manager& m, params_ref const& p) {
     tactic* t = m_tactic->translate(m);
-    tactic2solver* r = alloc(tactic2solver, m, t, p, m_produce_proofs, m_produce_models, m_produce_unsat_cores, m_logic);
+    tactic* pre = m_preprocess ? m_preprocess->translate(m) : nullptr;
+    tactic2solver* r = alloc(tactic2solver, m, pre, t, p, m_produce_proofs, m_produce_models, m_produce_unsat_cores, m_logic);
     r->m_result = nullptr;
     if (!m_scopes.empty()) {
         throw default_exception("translation of contexts is only supported at base level");
@@ -274,7 +593,18 @@ solver * mk_tactic2solver(ast_manager & m,
                           bool produce_models,
                           bool produce_unsat_cores,
                           symbol const & logic) {
-    return alloc(tactic2solver, m, t, p, produce_proofs, produce_models, produce_unsat_cores, logic);
+    return alloc(tactic2solver, m, nullptr, t, p, produce_proofs, produce_models, produce_unsat_cores, logic);
+}
+
+solver * mk_incremental_tactic2solver(ast_manager & m, 
+                                      tactic * pre,
+                                      tactic * t, 
+                                      params_ref const & p,
+                                      bool produce_proofs,
+                                      bool produce_models,
+                                      bool produce_unsat_cores,
+                                      symbol const & logic) {
+    return alloc(tactic2solver, m, pre, t, p, produce_proofs, produce_models, produce_unsat_cores, logic);
 }
 
 namespace {
@@ -291,6 +621,18 @@ public:
     }
 };
 
+class incremental_tactic2solver_factory : public solver_factory {
+    ref<tactic> m_preprocess;
+    ref<tactic> m_tactic;
+public:
+    incremental_tactic2solver_factory(tactic * pre, tactic * t):m_preprocess(pre), m_tactic(t) {
+    }
+    
+    solver * operator()(ast_manager & m, params_ref const & p, bool proofs_enabled, bool models_enabled, bool unsat_core_enabled, symbol const & logic) override {
+        return mk_incremental_tactic2solver(m, m_preprocess.get(), m_tactic.get(), p, proofs_enabled, models_enabled, unsat_core_enabled, logic);
+    }
+};
+
 class tactic_factory2solver_factory : public solver_factory {
     tactic_factory m_factory;
 public:
@@ -308,6 +650,10 @@ solver_factory * mk_tactic2solver_factory(tactic * t) {
     return alloc(tactic2solver_factory, t);
 }
 
+solver_factory * mk_incremental_tactic2solver_factory(tactic * pre, tactic * t) {
+    return alloc(incremental_tactic2solver_factory, pre, t);
+}
+
 solver_factory * mk_tactic_factory2solver_factory(tactic_factory f) {
     return alloc(tactic_factory2solver_factory, f);
 }
@@ -39,8 +39,26 @@ solver * mk_tactic2solver(ast_manager & m,
                           bool produce_unsat_cores = false, 
                           symbol const & logic = symbol::null);
 
+/**
+   \brief Create a solver that applies \c pre to the assertions added since the previous
+   check, caches the result across push, check and pop, and applies \c t to the cached formulas.
+   \c pre is meant for preprocessing, such as simplification and solving equations;
+   symbols that occur in assertions that were preprocessed before are not eliminated.
+   Every step of \c pre that does not produce an equivalent goal must be recorded in its
+   model converter; tactics such as symmetry-reduce are unsound as \c pre.
+*/
+solver * mk_incremental_tactic2solver(ast_manager & m, 
+                                      tactic * pre,
+                                      tactic * t,
+                                      params_ref const & p = params_ref(), 
+                                      bool produce_proofs = false, 
+                                      bool produce_models = true, 
+                                      bool produce_unsat_cores = false, 
+                                      symbol const & logic = symbol::null);
+
 
 solver_factory * mk_tactic2solver_factory(tactic * t);
+solver_factory * mk_incremental_tactic2solver_factory(tactic * pre, tactic * t);
 solver_factory * mk_tactic_factory2solver_factory(tactic_factory f);
 
 #endif
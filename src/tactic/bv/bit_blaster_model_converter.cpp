@@ -194,6 +194,8 @@ struct bit_blaster_model_converter : public model_converter {
         m_bits.reset();
         fml = mk_and(fmls);
     }
+
+    bool supports_formulas() const override { return true; }
     
     void display(std::ostream & out) override {
         for (func_decl * f : m_newbits) 
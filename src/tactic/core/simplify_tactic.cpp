@@ -18,19 +18,28 @@ Notes:
 --*/
 #include "tactic/core/simplify_tactic.h"
 #include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/par_rewriter.h"
+#include "ast/rewriter/rewriter_params.hpp"
 #include "ast/ast_pp.h"
 
 struct simplify_tactic::imp {
     ast_manager &   m_manager;
     th_rewriter     m_r;
+    params_ref      m_params;
     unsigned        m_num_steps;
 
     imp(ast_manager & m, params_ref const & p):
         m_manager(m),
         m_r(m, p),
+        m_params(p),
         m_num_steps(0) {
     }
 
+    void updt_params(params_ref const & p) {
+        m_params = p;
+        m_r.updt_params(p);
+    }
+
     ~imp() {
     }
 
@@ -49,6 +58,8 @@ struct simplify_tactic::imp {
         m_num_steps = 0;
         if (g.inconsistent())
             return;
+        if (par_simplify(g))
+            return;
         expr_ref   new_curr(m());
         proof_ref  new_pr(m());
         unsigned size = g.size();
@@ -71,6 +82,30 @@ struct simplify_tactic::imp {
         SASSERT(g.is_well_sorted());
     }
 
+    /**
+       \brief Rewrite the formulas of large goals with rewriter.threads threads.
+    */
+    bool par_simplify(goal & g) {
+        rewriter_params rp(m_params);
+        if (rp.threads() <= 1 || g.proofs_enabled())
+            return false;
+        expr_ref_vector fmls(m());
+        unsigned size = g.size();
+        for (unsigned idx = 0; idx < size; idx++)
+            fmls.push_back(g.form(idx));
+        if (!par_rewrite(m(), m_params, rp.threads(), fmls, m_num_steps))
+            return false;
+        for (unsigned idx = 0; idx < size; idx++) {
+            if (g.inconsistent())
+                break;
+            g.update(idx, fmls.get(idx), nullptr, g.dep(idx));
+        }
+        g.elim_redundancies();
+        TRACE("after_simplifier", g.display(tout););
+        SASSERT(g.is_well_sorted());
+        return true;
+    }
+
     unsigned get_num_steps() const { return m_num_steps; }
 };
 
@@ -85,7 +120,7 @@ simplify_tactic::~simplify_tactic() {
 
 void simplify_tactic::updt_params(params_ref const & p) {
     m_params = p;
-    m_imp->m_r.updt_params(p);
+    m_imp->updt_params(p);
 }
 
 void simplify_tactic::get_param_descrs(param_descrs & r) {
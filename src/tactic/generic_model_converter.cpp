@@ -108,7 +108,11 @@ model_converter * generic_model_converter::translate(ast_translation & translato
     ast_manager& to = translator.to();
     generic_model_converter * res = alloc(generic_model_converter, to, m_orig.c_str());
     for (entry const& e : m_entries) {
-        res->m_entries.push_back(entry(translator(e.m_f.get()), translator(e.m_def.get()), to, e.m_instruction));
+        func_decl_ref f(translator(e.m_f.get()), to);
+        if (e.m_instruction == instruction::ADD)
+            res->add(f, translator(e.m_def.get()));
+        else
+            res->hide(f);
     }
     return res;
 }
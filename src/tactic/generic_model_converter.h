@@ -65,6 +65,8 @@ public:
 
     void operator()(expr_ref& fml) override; 
 
+    bool supports_formulas() const override { return true; }
+
     void get_units(obj_map<expr, bool>& units) override;
 };
 
@@ -75,6 +75,8 @@ public:
 
     void operator()(expr_ref& fml) override;
 
+    bool supports_formulas() const override { return true; }
+
     model_converter * translate(ast_translation & translator) override;
 
     ast_manager& get_manager() { return m; }
@@ -84,6 +84,10 @@ public:
         this->m_c2->operator()(fml);
         this->m_c1->operator()(fml);
     }
+
+    bool supports_formulas() const override {
+        return this->m_c1->supports_formulas() && this->m_c2->supports_formulas();
+    }
     
     void operator()(labels_vec & r) override {
         this->m_c2->operator()(r);
@@ -139,6 +143,8 @@ public:
         fml = (*m_model)(fml);
     }
 
+    bool supports_formulas() const override { return true; }
+
     void get_units(obj_map<expr, bool>& fmls) override {
         // no-op
     }
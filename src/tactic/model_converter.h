@@ -89,6 +89,11 @@ public:
      */
     virtual void operator()(expr_ref& formula) { UNREACHABLE(); }
 
+    /**
+       \brief Return true if the converter implements the operator on formulas above.
+    */
+    virtual bool supports_formulas() const { return false; }
+
     virtual void get_units(obj_map<expr, bool>& fmls) { UNREACHABLE(); }
 };
 
@@ -17,7 +17,11 @@ Notes:
 
 --*/
 #include "tactic/portfolio/default_tactic.h"
+#include "tactic/portfolio_tactic.h"
 #include "tactic/core/simplify_tactic.h"
+#include "tactic/core/propagate_values_tactic.h"
+#include "tactic/core/solve_eqs_tactic.h"
+#include "tactic/sls/sls_tactic.h"
 #include "tactic/smtlogics/qfbv_tactic.h"
 #include "smt/tactic/smt_tactic.h"
 #include "tactic/smtlogics/qflia_tactic.h"
@@ -53,3 +57,14 @@ tactic * mk_default_tactic(ast_manager & m, params_ref const & p) {
     return st;
 }
 
+
+tactic * mk_default_portfolio_tactic(ast_manager & m, params_ref const & p) {
+    char const * names[4] = { "default", "smt", "simplify-smt", "qfbv-sls" };
+    tactic * ts[4] = {
+        mk_default_tactic(m, p),
+        mk_smt_tactic(m),
+        and_then(mk_simplify_tactic(m), mk_propagate_values_tactic(m), mk_solve_eqs_tactic(m), mk_smt_tactic(m)),
+        cond(mk_is_qfbv_probe(), mk_qfbv_sls_tactic(m, p), mk_fail_tactic())
+    };
+    return mk_portfolio_tactic(m, 4, names, ts, p);
+}
@@ -25,8 +25,11 @@ class tactic;
 
 tactic * mk_default_tactic(ast_manager & m, params_ref const & p = params_ref());
 
+tactic * mk_default_portfolio_tactic(ast_manager & m, params_ref const & p = params_ref());
+
 /*
 ADD_TACTIC("default", "default strategy used when no logic is specified.", "mk_default_tactic(m, p)")
+ADD_TACTIC("portfolio", "time-sliced portfolio of general purpose strategies, ordered by the outcomes recorded in portfolio.knowledge_file.", "mk_default_portfolio_tactic(m, p)")
 */
 
 #endif
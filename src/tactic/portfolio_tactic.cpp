@@ -0,0 +1,405 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    portfolio_tactic.cpp
+
+Abstract:
+
+    Time-sliced portfolio of strategies that learns from past outcomes.
+
+    The knowledge file has one line per goal features and strategy,
+    with tab separated fields:
+
+        features  strategy  attempts  solved  solving-time
+
+    where attempts counts the time slices the strategy ran on goals with
+    the features, solved counts the attempts that decided the goal, and
+    solving-time is the total time in seconds of these attempts.
+    The outcomes of every invocation are added to the file. The file is
+    not locked, so it is meant for one process at a time: outcomes of
+    processes that save it at the same time can be lost. It is replaced
+    in one step, so it is never missing or partially written.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#ifdef _WINDOWS
+#define NOMINMAX
+#include <windows.h>
+#endif
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "util/cancel_eh.h"
+#include "util/scoped_timer.h"
+#include "util/stopwatch.h"
+#include "tactic/tactical.h"
+#include "tactic/portfolio_tactic.h"
+#include "tactic/portfolio_params.hpp"
+
+class portfolio_tactic : public tactic {
+
+    struct outcome {
+        unsigned m_attempts;
+        unsigned m_solved;
+        double   m_solve_time;
+        outcome(): m_attempts(0), m_solved(0), m_solve_time(0) {}
+    };
+
+    // outcomes indexed by features and strategy name, separated by a tab
+    typedef std::map<std::string, outcome> knowledge;
+
+    enum status {
+        DECIDED,
+        UNDECIDED,
+        TIMEOUT,
+        FAILED
+    };
+
+    struct stats {
+        unsigned m_num_slices;
+        unsigned m_num_timeouts;
+        unsigned m_num_failures;
+        stats() { reset(); }
+        void reset() { memset(this, 0, sizeof(*this)); }
+    };
+
+    ast_manager &        m;
+    params_ref           m_params;
+    vector<std::string>  m_names;
+    tactic_ref_vector    m_ts;
+    unsigned             m_slice;
+    unsigned             m_rounds;
+    std::string          m_file;
+    stats                m_stats;
+
+    static unsigned bucket(double v) {
+        unsigned b = 0;
+        for (; v >= 4; v /= 4) ++b;
+        return b;
+    }
+
+    std::string features(goal const & g) {
+        char const * logic = "other";
+        if (probe_ref(mk_is_propositional_probe())->operator()(g).is_true())
+            logic = "prop";
+        else if (probe_ref(mk_is_qfbv_probe())->operator()(g).is_true())
+            logic = "qfbv";
+        else if (probe_ref(mk_is_qfaufbv_probe())->operator()(g).is_true())
+            logic = "qfaufbv";
+        else if (probe_ref(mk_is_qfufbv_probe())->operator()(g).is_true())
+            logic = "qfufbv";
+        else if (probe_ref(mk_has_quantifier_probe())->operator()(g).is_true())
+            logic = "quant";
+        std::ostringstream out;
+        out << logic
+            << " size:"  << bucket(probe_ref(mk_num_exprs_probe())->operator()(g).get_value())
+            << " bool:"  << bucket(probe_ref(mk_num_bool_consts_probe())->operator()(g).get_value())
+            << " arith:" << bucket(probe_ref(mk_num_arith_consts_probe())->operator()(g).get_value())
+            << " bv:"    << bucket(probe_ref(mk_num_bv_consts_probe())->operator()(g).get_value());
+        return out.str();
+    }
+
+    static void load(std::string const & file, knowledge & kn) {
+        std::ifstream in(file);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == ';')
+                continue;
+            size_t i = line.find('\t');
+            size_t j = i == std::string::npos ? i : line.find('\t', i + 1);
+            if (j == std::string::npos)
+                continue;
+            std::istringstream nums(line.substr(j + 1));
+            outcome o;
+            nums >> o.m_attempts >> o.m_solved >> o.m_solve_time;
+            if (nums.fail())
+                continue;
+            outcome & r = kn[line.substr(0, j)];
+            r.m_attempts   += o.m_attempts;
+            r.m_solved     += o.m_solved;
+            r.m_solve_time += o.m_solve_time;
+        }
+    }
+
+    // replace file by tmp, even if file exists
+    static bool replace_file(std::string const & tmp, std::string const & file) {
+#ifdef _WINDOWS
+        return MoveFileExA(tmp.c_str(), file.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return std::rename(tmp.c_str(), file.c_str()) == 0;
+#endif
+    }
+
+    // merge the outcomes of this invocation with the current contents of the file
+    void save(knowledge const & delta) {
+        if (m_file.empty() || delta.empty())
+            return;
+        knowledge kn;
+        load(m_file, kn);
+        for (auto const & kv : delta) {
+            outcome & r = kn[kv.first];
+            r.m_attempts   += kv.second.m_attempts;
+            r.m_solved     += kv.second.m_solved;
+            r.m_solve_time += kv.second.m_solve_time;
+        }
+        std::string tmp = m_file + ".tmp";
+        {
+            std::ofstream out(tmp);
+            if (!out) {
+                warning_msg("could not write portfolio knowledge file %s", tmp.c_str());
+                return;
+            }
+            out << "; features\tstrategy\tattempts\tsolved\tsolving-time\n";
+            for (auto const & kv : kn)
+                out << kv.first << "\t" << kv.second.m_attempts << "\t" << kv.second.m_solved << "\t" << kv.second.m_solve_time << "\n";
+        }
+        if (!replace_file(tmp, m_file)) {
+            std::remove(tmp.c_str());
+            warning_msg("could not write portfolio knowledge file %s", m_file.c_str());
+        }
+    }
+
+    std::string key(std::string const & features, unsigned i) const {
+        return features + "\t" + m_names[i];
+    }
+
+    /**
+       \brief Order the strategies: first the ones that decided goals with the same features,
+       by average solving time, then the ones without outcomes, in their original order,
+       and last the ones that never decided such goals, by number of attempts.
+    */
+    void rank(knowledge const & kn, std::string const & features, unsigned_vector & order, svector<double> & solve_time) const {
+        struct score {
+            unsigned m_class;
+            double   m_value;
+            unsigned m_index;
+            bool operator<(score const & other) const {
+                if (m_class != other.m_class) return m_class < other.m_class;
+                if (m_value != other.m_value) return m_value < other.m_value;
+                return m_index < other.m_index;
+            }
+        };
+        svector<score> scores;
+        solve_time.reset();
+        for (unsigned i = 0; i < m_ts.size(); ++i) {
+            score s = { 1, 0, i };
+            double t = 0;
+            auto it = kn.find(key(features, i));
+            if (it != kn.end() && it->second.m_solved > 0) {
+                t = it->second.m_solve_time / it->second.m_solved;
+                s.m_class = 0;
+                s.m_value = t;
+            }
+            else if (it != kn.end() && it->second.m_attempts > 0) {
+                s.m_class = 2;
+                s.m_value = it->second.m_attempts;
+            }
+            scores.push_back(s);
+            solve_time.push_back(t);
+        }
+        std::sort(scores.begin(), scores.end());
+        order.reset();
+        for (score const & s : scores)
+            order.push_back(s.m_index);
+    }
+
+    status run(unsigned i, goal const & orig, unsigned timeout, goal_ref & g, goal_ref_buffer & r, double & secs, std::string & msg) {
+        g = alloc(goal, orig);
+        r.reset();
+        status st;
+        bool timed_out;
+        stopwatch sw;
+        sw.start();
+        {
+            cancel_eh<reslimit> eh(m.limit());
+            try {
+                scoped_timer timer(timeout, &eh);
+                (*m_ts[i])(g, r);
+                st = is_decided(r) ? DECIDED : UNDECIDED;
+            }
+            catch (z3_error &) {
+                throw;
+            }
+            catch (z3_exception & ex) {
+                st = FAILED;
+                msg = ex.msg();
+            }
+            timed_out = eh.canceled();
+        }
+        sw.stop();
+        secs = sw.get_seconds();
+        m_ts[i]->cleanup();
+        if (m.limit().get_cancel_flag())
+            throw tactic_exception(m.limit().get_cancel_msg());
+        if (timed_out && st != DECIDED) {
+            st = TIMEOUT;
+            m_stats.m_num_timeouts++;
+        }
+        if (st == FAILED)
+            m_stats.m_num_failures++;
+        m_stats.m_num_slices++;
+        IF_VERBOSE(2, verbose_stream() << "(portfolio :strategy " << m_names[i]
+                   << " :slice " << (timeout == UINT_MAX ? 0 : timeout)
+                   << " :time " << secs
+                   << " :outcome " << (st == DECIDED ? "decided" : st == UNDECIDED ? "undecided" : st == TIMEOUT ? "timeout" : "failed")
+                   << ")\n";);
+        return st;
+    }
+
+    void apply(goal_ref const & in, goal_ref_buffer & result, std::string const & features, knowledge const & kn, knowledge & delta) {
+        unsigned_vector order;
+        svector<double> solve_time;
+        rank(kn, features, order, solve_time);
+        goal orig(*(in.get()));
+        goal_ref        g, fallback_g;
+        goal_ref_buffer r, fallback;
+        std::string     msg;
+        double          secs;
+
+        auto record = [&](unsigned i, status st) {
+            outcome & o = delta[key(features, i)];
+            o.m_attempts++;
+            if (st == DECIDED) {
+                o.m_solved++;
+                o.m_solve_time += secs;
+            }
+        };
+        auto accept = [&](goal_ref const & rg, goal_ref_buffer const & rs) {
+            result.append(rs.size(), rs.c_ptr());
+            in->reset_all();
+            in->copy_from(*(rg.get()));
+        };
+
+        unsigned slice = m_slice;
+        for (unsigned round = 0; round < m_rounds && !order.empty(); ++round) {
+            unsigned j = 0;
+            for (unsigned i : order) {
+                // give strategies that decided similar goals twice their average solving time
+                unsigned timeout = std::max(slice, static_cast<unsigned>(std::min(2000 * solve_time[i], static_cast<double>(UINT_MAX - 1))));
+                status st = run(i, orig, timeout, g, r, secs, msg);
+                record(i, st);
+                switch (st) {
+                case DECIDED:
+                    accept(g, r);
+                    return;
+                case UNDECIDED:
+                    if (!fallback_g) {
+                        fallback_g = g;
+                        fallback.append(r.size(), r.c_ptr());
+                    }
+                    break;
+                case TIMEOUT:
+                    order[j++] = i;
+                    break;
+                case FAILED:
+                    break;
+                }
+            }
+            order.shrink(j);
+            slice = slice > UINT_MAX / 4 ? UINT_MAX - 1 : 2 * slice;
+        }
+        if (!order.empty()) {
+            unsigned i = order[0];
+            status st = run(i, orig, UINT_MAX, g, r, secs, msg);
+            record(i, st);
+            if (st == DECIDED || st == UNDECIDED) {
+                accept(g, r);
+                return;
+            }
+        }
+        if (fallback_g) {
+            accept(fallback_g, fallback);
+            return;
+        }
+        throw tactic_exception(msg.empty() ? "portfolio failed" : msg);
+    }
+
+public:
+    portfolio_tactic(ast_manager & m, unsigned num, char const * const * names, tactic * const * ts, params_ref const & p):
+        m(m), m_params(p) {
+        for (unsigned i = 0; i < num; ++i) {
+            std::string name(names[i]);
+            std::replace(name.begin(), name.end(), '\t', ' ');
+            std::replace(name.begin(), name.end(), '\n', ' ');
+            m_names.push_back(name);
+            m_ts.push_back(ts[i]);
+        }
+        updt_params(p);
+    }
+
+    ~portfolio_tactic() override {}
+
+    void updt_params(params_ref const & p) override {
+        m_params = p;
+        portfolio_params pp(p);
+        m_slice  = std::max(pp.slice(), 1u);
+        m_rounds = pp.rounds();
+        m_file   = pp.knowledge_file();
+        for (tactic * t : m_ts)
+            t->updt_params(p);
+    }
+
+    void collect_param_descrs(param_descrs & r) override {
+        portfolio_params::collect_param_descrs(r);
+    }
+
+    void operator()(goal_ref const & in, goal_ref_buffer & result) override {
+        tactic_report report("portfolio", *in);
+        if (m_ts.empty())
+            throw tactic_exception("portfolio failed");
+        std::string f = features(*in);
+        knowledge kn, delta;
+        if (!m_file.empty())
+            load(m_file, kn);
+        try {
+            apply(in, result, f, kn, delta);
+        }
+        catch (...) {
+            save(delta);
+            throw;
+        }
+        save(delta);
+    }
+
+    void cleanup() override {
+        for (tactic * t : m_ts)
+            t->cleanup();
+    }
+
+    void collect_statistics(statistics & st) const override {
+        st.update("portfolio slices", m_stats.m_num_slices);
+        st.update("portfolio timeouts", m_stats.m_num_timeouts);
+        st.update("portfolio failures", m_stats.m_num_failures);
+        for (tactic * t : m_ts)
+            t->collect_statistics(st);
+    }
+
+    void reset_statistics() override {
+        m_stats.reset();
+        for (tactic * t : m_ts)
+            t->reset_statistics();
+    }
+
+    tactic * translate(ast_manager & new_m) override {
+        ptr_buffer<char const> names;
+        ptr_buffer<tactic> ts;
+        for (unsigned i = 0; i < m_ts.size(); ++i) {
+            names.push_back(m_names[i].c_str());
+            ts.push_back(m_ts[i]->translate(new_m));
+        }
+        return alloc(portfolio_tactic, new_m, ts.size(), names.c_ptr(), ts.c_ptr(), m_params);
+    }
+};
+
+tactic * mk_portfolio_tactic(ast_manager & m, unsigned num, char const * const * names, tactic * const * ts, params_ref const & p) {
+    return alloc(portfolio_tactic, m, num, names, ts, p);
+}
@@ -0,0 +1,47 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    portfolio_tactic.h
+
+Abstract:
+
+    Time-sliced portfolio of strategies that learns from past outcomes.
+
+    The strategies run one after the other on copies of the goal, in
+    rounds of increasing time slices, until one of them decides the
+    goal. Strategies that fail are dropped. After the last round, the
+    best remaining strategy runs without a time limit.
+
+    The outcomes are recorded per goal features (logic class and the
+    magnitude of the size and of the number of constants) in the file
+    portfolio.knowledge_file. Strategies that decided goals with the
+    same features are tried first, in the order of their average
+    solving time, and get a first slice that is large enough to
+    reproduce it. Then come strategies without outcomes for the
+    features, and last the strategies that never decided such goals.
+
+    The knowledge file is not locked; it should not be used by several
+    processes at the same time.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#ifndef PORTFOLIO_TACTIC_H_
+#define PORTFOLIO_TACTIC_H_
+
+#include "util/params.h"
+class ast_manager;
+class tactic;
+
+/**
+   \brief Create a portfolio of the tactics \c ts. The outcomes of \c ts[i] are recorded under the name \c names[i].
+*/
+tactic * mk_portfolio_tactic(ast_manager & m, unsigned num, char const * const * names, tactic * const * ts, params_ref const & p = params_ref());
+
+#endif
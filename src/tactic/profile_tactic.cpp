@@ -0,0 +1,256 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    profile_tactic.cpp
+
+Abstract:
+
+    Profiling of composite strategies.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include "util/stopwatch.h"
+#include "tactic/tactic.h"
+#include "tactic/profile_tactic.h"
+#include "tactic/tactic_params.hpp"
+
+namespace {
+
+    /**
+       \brief Invocations of a tactic in the same context (the path of tactics from the root).
+    */
+    struct profile_node {
+        std::string              m_name;
+        profile_node *           m_parent;
+        ptr_vector<profile_node> m_children;
+        unsigned                 m_serial;       // identifies roots, used to validate parents of translated tactics
+        unsigned                 m_calls;
+        double                   m_time;
+        long long                m_memory;
+        unsigned long long       m_size_in;
+        unsigned long long       m_size_out;
+        unsigned                 m_depth_in;
+        unsigned                 m_depth_out;
+
+        profile_node(std::string const & name, profile_node * parent):
+            m_name(name), m_parent(parent), m_serial(0), m_calls(0), m_time(0), m_memory(0),
+            m_size_in(0), m_size_out(0), m_depth_in(0), m_depth_out(0) {}
+
+        ~profile_node() {
+            for (profile_node * c : m_children)
+                dealloc(c);
+        }
+
+        profile_node * root() {
+            profile_node * n = this;
+            while (n->m_parent)
+                n = n->m_parent;
+            return n;
+        }
+
+        profile_node * child(std::string const & name) {
+            for (profile_node * c : m_children)
+                if (c->m_name == name)
+                    return c;
+            m_children.push_back(alloc(profile_node, name, this));
+            return m_children.back();
+        }
+
+        double self_time() const {
+            double t = m_time;
+            for (profile_node * c : m_children)
+                t -= c->m_time;
+            return t > 0 ? t : 0;
+        }
+
+        void display(std::ostream & out, unsigned indent) const {
+            out << std::string(indent, ' ') << "(" << m_name
+                << " :calls " << m_calls
+                << std::fixed << std::setprecision(3)
+                << " :time " << m_time
+                << std::setprecision(2)
+                << " :memory " << static_cast<double>(m_memory) / static_cast<double>(1024 * 1024)
+                << " :size " << m_size_in << " -> " << m_size_out
+                << " :depth " << m_depth_in << " -> " << m_depth_out;
+            for (profile_node * c : m_children) {
+                out << "\n";
+                c->display(out, indent + 2);
+            }
+            out << ")";
+        }
+
+        void display_collapsed(std::ostream & out, std::string const & prefix) const {
+            std::string path = prefix.empty() ? m_name : prefix + ";" + m_name;
+            out << path << " " << static_cast<unsigned long long>(self_time() * 1000000) << "\n";
+            for (profile_node * c : m_children)
+                c->display_collapsed(out, path);
+        }
+    };
+
+    std::mutex                                g_mutex;
+    std::map<std::thread::id, profile_node *> g_current;   // innermost invocation of every thread
+    std::set<profile_node *>                  g_roots;     // roots of invocations that did not finish
+    unsigned                                  g_serial = 0;
+
+    // tactic names are used as path components
+    std::string sanitize(char const * name) {
+        std::string r(name);
+        for (char & c : r)
+            if (c == ';' || c == ' ' || c == '\n' || c == '\t')
+                c = '_';
+        return r;
+    }
+}
+
+class profile_tactic : public tactic {
+    std::string    m_name;
+    tactic_ref     m_t;
+    std::string    m_file;
+    // invocation that was active when the tactic was created by translation
+    profile_node * m_parent;
+    profile_node * m_parent_root;
+    unsigned       m_parent_serial;
+
+    profile_node * enter(profile_node * & prev) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        std::thread::id id = std::this_thread::get_id();
+        auto it = g_current.find(id);
+        prev = it == g_current.end() ? nullptr : it->second;
+        profile_node * parent = prev;
+        if (!parent && m_parent && g_roots.count(m_parent_root) > 0 && m_parent_root->m_serial == m_parent_serial)
+            parent = m_parent;
+        profile_node * n;
+        if (parent) {
+            n = parent->child(m_name);
+        }
+        else {
+            n = alloc(profile_node, m_name, nullptr);
+            n->m_serial = ++g_serial;
+            g_roots.insert(n);
+        }
+        g_current[id] = n;
+        return n;
+    }
+
+    void leave(profile_node * n, profile_node * prev, double time, long long memory,
+               unsigned size_in, unsigned depth_in, goal_ref_buffer const & result) {
+        unsigned long long size_out = 0;
+        unsigned depth_out = 0;
+        for (goal * g : result) {
+            size_out += g->num_exprs();
+            depth_out = std::max(depth_out, g->depth());
+        }
+        {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            n->m_calls++;
+            n->m_time      += time;
+            n->m_memory    += memory;
+            n->m_size_in   += size_in;
+            n->m_size_out  += size_out;
+            n->m_depth_in   = std::max(n->m_depth_in, depth_in);
+            n->m_depth_out  = std::max(n->m_depth_out, depth_out);
+            std::thread::id id = std::this_thread::get_id();
+            if (prev)
+                g_current[id] = prev;
+            else
+                g_current.erase(id);
+            if (n->m_parent)
+                return;
+            g_roots.erase(n);
+        }
+        report(n);
+        dealloc(n);
+    }
+
+    void report(profile_node * root) {
+        if (m_file.empty()) {
+            std::lock_guard<std::mutex> lock(g_mutex);
+            verbose_stream() << "(tactic-profile\n";
+            root->display(verbose_stream(), 2);
+            verbose_stream() << ")\n";
+            return;
+        }
+        std::ofstream out(m_file, std::ios::app);
+        if (!out) {
+            warning_msg("could not open tactic profile file %s", m_file.c_str());
+            return;
+        }
+        root->display_collapsed(out, std::string());
+    }
+
+public:
+    profile_tactic(char const * name, tactic * t, params_ref const & p):
+        m_name(sanitize(name)), m_t(t), m_parent(nullptr), m_parent_root(nullptr), m_parent_serial(0) {
+        m_file = tactic_params(p).profile_file();
+    }
+
+    ~profile_tactic() override {}
+
+    void operator()(goal_ref const & in, goal_ref_buffer & result) override {
+        unsigned size_in  = in->num_exprs();
+        unsigned depth_in = in->depth();
+        profile_node * prev = nullptr;
+        profile_node * n = enter(prev);
+        long long mem = static_cast<long long>(memory::get_allocation_size());
+        stopwatch sw;
+        sw.start();
+        try {
+            m_t->operator()(in, result);
+        }
+        catch (...) {
+            sw.stop();
+            leave(n, prev, sw.get_seconds(), static_cast<long long>(memory::get_allocation_size()) - mem, size_in, depth_in, goal_ref_buffer());
+            throw;
+        }
+        sw.stop();
+        leave(n, prev, sw.get_seconds(), static_cast<long long>(memory::get_allocation_size()) - mem, size_in, depth_in, result);
+    }
+
+    void updt_params(params_ref const & p) override {
+        m_file = tactic_params(p).profile_file();
+        m_t->updt_params(p);
+    }
+    void collect_param_descrs(param_descrs & r) override { m_t->collect_param_descrs(r); }
+    void collect_statistics(statistics & st) const override { m_t->collect_statistics(st); }
+    void reset_statistics() override { m_t->reset_statistics(); }
+    void cleanup() override { m_t->cleanup(); }
+    void reset() override { m_t->reset(); }
+    void set_logic(symbol const & l) override { m_t->set_logic(l); }
+    void set_progress_callback(progress_callback * callback) override { m_t->set_progress_callback(callback); }
+
+    tactic * translate(ast_manager & m) override {
+        profile_tactic * t = alloc(profile_tactic, m_name.c_str(), m_t->translate(m), params_ref());
+        t->m_file = m_file;
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_current.find(std::this_thread::get_id());
+        if (it != g_current.end()) {
+            t->m_parent        = it->second;
+            t->m_parent_root   = it->second->root();
+            t->m_parent_serial = t->m_parent_root->m_serial;
+        }
+        return t;
+    }
+};
+
+tactic * mk_profile_tactic(char const * name, tactic * t, params_ref const & p) {
+    return alloc(profile_tactic, name, t, p);
+}
+
+tactic * mk_profile_tactic_if_enabled(char const * name, tactic * t) {
+    if (!tactic_params().profile())
+        return t;
+    return mk_profile_tactic(name, t);
+}
@@ -0,0 +1,51 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    profile_tactic.h
+
+Abstract:
+
+    Profiling of composite strategies.
+
+    A profiled tactic measures every invocation of the tactic it wraps:
+    wall time, change of allocated memory, and size and depth of the
+    goal before and after. When every node of a strategy is wrapped,
+    the invocations form a tree that follows the nesting of the
+    tactics, where invocations of the same tactic in the same context
+    are merged.
+
+    When the outermost profiled tactic returns, the tree is displayed on
+    the verbose stream, or appended to the file tactic.profile.file in
+    the collapsed stack format of flame graph tools: one line per path
+    of tactic names, separated by ';', followed by the time in
+    microseconds spent in the last tactic of the path itself.
+
+    Tactics that run in other threads, such as the branches of par-or,
+    are attached to the invocation of the tactic that translated them.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#ifndef PROFILE_TACTIC_H_
+#define PROFILE_TACTIC_H_
+
+#include "util/params.h"
+class tactic;
+
+/**
+   \brief Wrap \c t in a tactic that profiles its invocations under the given name.
+*/
+tactic * mk_profile_tactic(char const * name, tactic * t, params_ref const & p = params_ref());
+
+/**
+   \brief Wrap \c t in a profiled tactic if the parameter tactic.profile is set, otherwise return \c t.
+*/
+tactic * mk_profile_tactic_if_enabled(char const * name, tactic * t);
+
+#endif
@@ -20,7 +20,7 @@ Notes:
 #include "util/cancel_eh.h"
 #include "util/cooperate.h"
 #include "util/scoped_ptr_vector.h"
-#include "util/z3_omp.h"
+#include "util/thread_pool.h"
 #include "tactic/tactical.h"
 
 class binary_tactical : public tactic {
@@ -377,13 +377,8 @@ public:
     
 
     void operator()(goal_ref const & in, goal_ref_buffer& result) override {
-        bool use_seq;
-#ifdef _NO_OMP_
-        use_seq = true;
-#else
-        use_seq = 0 != omp_in_parallel();
-#endif
-        if (use_seq) {
+        thread_pool & pool = thread_pool::get();
+        if (thread_pool::in_parallel() || pool.num_workers() == 0) {
             // execute tasks sequentially
             or_else_tactical::operator()(in, result);
             return;
@@ -410,56 +405,65 @@ public:
         std::string        ex_msg;
         unsigned           error_code = 0;
         
-        #pragma omp parallel for
-        for (int i = 0; i < static_cast<int>(sz); i++) {
-            goal_ref_buffer     _result;
-            
-            goal_ref in_copy = in_copies[i];
-            tactic & t = *(ts.get(i));
-            
-            try {
-                t(in_copy, _result);
-                bool first = false;
-                #pragma omp critical (par_tactical)
+        std::mutex mux;
+        thread_pool::task_group tasks(pool);
+        for (unsigned i = 0; i < sz; i++) {
+            tasks.add([&, i]() {
                 {
-                    if (finished_id == UINT_MAX) {
-                        finished_id = i;
-                        first = true;
-                    }
-                }                
-                if (first) {
-                    for (unsigned j = 0; j < sz; j++) {
-                        if (static_cast<unsigned>(i) != j) {
-                            managers[j]->limit().cancel();
+                    std::lock_guard<std::mutex> lock(mux);
+                    if (finished_id != UINT_MAX)
+                        return;
+                }
+                goal_ref_buffer     _result;
+
+                goal_ref in_copy = in_copies[i];
+                tactic & t = *(ts.get(i));
+
+                try {
+                    t(in_copy, _result);
+                    bool first = false;
+                    {
+                        std::lock_guard<std::mutex> lock(mux);
+                        if (finished_id == UINT_MAX) {
+                            finished_id = i;
+                            first = true;
                         }
                     }
-                    ast_translation translator(*(managers[i]), m, false);
-                    for (goal* g : _result) {
-                        result.push_back(g->translate(translator));
+                    if (first) {
+                        for (unsigned j = 0; j < sz; j++) {
+                            if (i != j) {
+                                managers[j]->limit().cancel();
+                            }
+                        }
+                        ast_translation translator(*(managers[i]), m, false);
+                        for (goal* g : _result) {
+                            result.push_back(g->translate(translator));
+                        }
+                        goal_ref in2(in_copy->translate(translator));
+                        in->copy_from(*(in2.get()));
                     }
-                    goal_ref in2(in_copy->translate(translator));
-                    in->copy_from(*(in2.get()));
                 }
-            }
-            catch (tactic_exception & ex) {
-                if (i == 0) {
-                    ex_kind = TACTIC_EX;
-                    ex_msg = ex.msg();
+                catch (tactic_exception & ex) {
+                    if (i == 0) {
+                        ex_kind = TACTIC_EX;
+                        ex_msg = ex.msg();
+                    }
                 }
-            }
-            catch (z3_error & err) {
-                if (i == 0) {
-                    ex_kind = ERROR_EX;
-                    error_code = err.error_code();
+                catch (z3_error & err) {
+                    if (i == 0) {
+                        ex_kind = ERROR_EX;
+                        error_code = err.error_code();
+                    }
                 }
-            }
-            catch (z3_exception & z3_ex) {
-                if (i == 0) {
-                    ex_kind = DEFAULT_EX;
-                    ex_msg = z3_ex.msg();
+                catch (z3_exception & z3_ex) {
+                    if (i == 0) {
+                        ex_kind = DEFAULT_EX;
+                        ex_msg = z3_ex.msg();
+                    }
                 }
-            }
+            });
         }
+        tasks.wait();
         if (finished_id == UINT_MAX) {
             switch (ex_kind) {
             case ERROR_EX: throw z3_error(error_code);
@@ -498,13 +502,8 @@ public:
     ~par_and_then_tactical() override {}
 
     void operator()(goal_ref const & in, goal_ref_buffer& result) override {
-        bool use_seq;
-#ifdef _NO_OMP_
-        use_seq = true;
-#else
-        use_seq = 0 != omp_in_parallel();
-#endif
-        if (use_seq) {
+        thread_pool & pool = thread_pool::get();
+        if (thread_pool::in_parallel() || pool.num_workers() == 0) {
             // execute tasks sequentially
             and_then_tactical::operator()(in, result);
             return;
@@ -535,12 +534,15 @@ public:
             tactic_ref_vector              ts2;
             goal_ref_vector                g_copies;
 
+            scoped_limits                  scl(m.limit());
+
             for (unsigned i = 0; i < r1_size; i++) {
                 ast_manager * new_m = alloc(ast_manager, m, !m.proof_mode());
                 managers.push_back(new_m);
                 ast_translation translator(m, *new_m);
                 g_copies.push_back(r1[i]->translate(translator));
                 ts2.push_back(m_t2->translate(*new_m));
+                scl.push_child(&new_m->limit());
             }
 
             scoped_ptr_vector<expr_dependency_ref> core_buffer;
@@ -555,21 +557,27 @@ public:
             unsigned error_code = 0;
             std::string  ex_msg;
 
-            #pragma omp parallel for
-            for (int i = 0; i < static_cast<int>(r1_size); i++) { 
-                ast_manager & new_m = *(managers[i]);
-                goal_ref new_g = g_copies[i];
+            std::mutex mux;
+            thread_pool::task_group tasks(pool);
+            for (unsigned i = 0; i < r1_size; i++) {
+                tasks.add([&, i]() {
+                    {
+                        std::lock_guard<std::mutex> lock(mux);
+                        if (failed || found_solution)
+                            return;
+                    }
+                    ast_manager & new_m = *(managers[i]);
+                    goal_ref new_g = g_copies[i];
 
-                goal_ref_buffer r2;
-                
-                bool curr_failed = false;
+                    goal_ref_buffer r2;
 
-                try {
-                    ts2[i]->operator()(new_g, r2);                  
-                }
-                catch (tactic_exception & ex) {
-                    #pragma omp critical (par_and_then_tactical)
-                    {
+                    bool curr_failed = false;
+
+                    try {
+                        ts2[i]->operator()(new_g, r2);                  
+                    }
+                    catch (tactic_exception & ex) {
+                        std::lock_guard<std::mutex> lock(mux);
                         if (!failed && !found_solution) {
                             curr_failed = true;
                             failed      = true;
@@ -577,21 +585,17 @@ public:
                             ex_msg      = ex.msg();
                         }
                     }
-                }
-                catch (z3_error & err) {
-                    #pragma omp critical (par_and_then_tactical)
-                    {
+                    catch (z3_error & err) {
+                        std::lock_guard<std::mutex> lock(mux);
                         if (!failed && !found_solution) {
                             curr_failed = true;
                             failed      = true;
                             ex_kind     = ERROR_EX;
                             error_code  = err.error_code();
                         }
-                    }                    
-                }
-                catch (z3_exception & z3_ex) {
-                    #pragma omp critical (par_and_then_tactical)
-                    {
+                    }
+                    catch (z3_exception & z3_ex) {
+                        std::lock_guard<std::mutex> lock(mux);
                         if (!failed && !found_solution) {
                             curr_failed = true;
                             failed      = true;
@@ -599,63 +603,66 @@ public:
                             ex_msg      = z3_ex.msg();
                         }
                     }
-                }
 
-                if (curr_failed) {
-                    for (unsigned j = 0; j < r1_size; j++) {
-                        if (static_cast<unsigned>(i) != j) {
-                            managers[j]->limit().cancel();
+                    if (curr_failed) {
+                        for (unsigned j = 0; j < r1_size; j++) {
+                            if (i != j) {
+                                managers[j]->limit().cancel();
+                            }
                         }
                     }
-                }
-                else {
-                    if (is_decided(r2)) {
-                        SASSERT(r2.size() == 1);
-                        if (is_decided_sat(r2)) {                                                          
-                            // found solution... 
-                            bool first = false;
-                            #pragma omp critical (par_and_then_tactical)
-                            {
-                                if (!found_solution) {
-                                    failed         = false;
-                                    found_solution = true;
-                                    first          = true;
+                    else {
+                        if (is_decided(r2)) {
+                            SASSERT(r2.size() == 1);
+                            if (is_decided_sat(r2)) {                                                          
+                                // found solution... 
+                                bool first = false;
+                                {
+                                    std::lock_guard<std::mutex> lock(mux);
+                                    if (!found_solution) {
+                                        failed         = false;
+                                        found_solution = true;
+                                        first          = true;
+                                    }
                                 }
-                            }
-                            if (first) {
-                                for (unsigned j = 0; j < r1_size; j++) {
-                                    if (static_cast<unsigned>(i) != j) {
-                                        managers[j]->limit().cancel();
+                                if (first) {
+                                    for (unsigned j = 0; j < r1_size; j++) {
+                                        if (i != j) {
+                                            managers[j]->limit().cancel();
+                                        }
                                     }
+                                    ast_translation translator(new_m, m, false);
+                                    SASSERT(r2.size() == 1);
+                                    result.push_back(r2[0]->translate(translator));                                
+                                }       
+                            }                                                     
+                            else {                                                                                  
+                                SASSERT(is_decided_unsat(r2));                                                 
+
+                                if (cores_enabled && r2[0]->dep(0) != nullptr) {
+                                    expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
+                                    *new_dep = r2[0]->dep(0);
+                                    core_buffer.set(i, new_dep);
                                 }
-                                ast_translation translator(new_m, m, false);
-                                SASSERT(r2.size() == 1);
-                                result.push_back(r2[0]->translate(translator));                                
-                            }       
-                        }                                                     
-                        else {                                                                                  
-                            SASSERT(is_decided_unsat(r2));                                                 
-                            
-                            if (cores_enabled && r2[0]->dep(0) != nullptr) {
+                            }                                                                 
+                        }                                                                                       
+                        else {                                                                                      
+                            goal_ref_buffer * new_r2 = alloc(goal_ref_buffer);
+                            goals_vect.set(i, new_r2);
+                            new_r2->append(r2.size(), r2.c_ptr());
+                            dependency_converter* dc = r1[i]->dc();                           
+                            if (cores_enabled && dc) {
+                                // the dependencies of r1[i] live in m, which is shared by all tasks
+                                std::lock_guard<std::mutex> lock(mux);
                                 expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
-                                *new_dep = r2[0]->dep(0);
+                                *new_dep = (*dc)();
                                 core_buffer.set(i, new_dep);
                             }
-                        }                                                                 
-                    }                                                                                       
-                    else {                                                                                      
-                        goal_ref_buffer * new_r2 = alloc(goal_ref_buffer);
-                        goals_vect.set(i, new_r2);
-                        new_r2->append(r2.size(), r2.c_ptr());
-                        dependency_converter* dc = r1[i]->dc();                           
-                        if (cores_enabled && dc) {
-                            expr_dependency_ref * new_dep = alloc(expr_dependency_ref, new_m);
-                            *new_dep = (*dc)();
-                            core_buffer.set(i, new_dep);
-                        }
-                    }                                                                                           
-                }
+                        }                                                                                           
+                    }
+                });
             }
+            tasks.wait();
             
             if (failed) {
                 switch (ex_kind) {
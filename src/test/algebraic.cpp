@@ -20,6 +20,7 @@ Notes:
 #include "math/polynomial/polynomial_var2value.h"
 #include "util/mpbq.h"
 #include "util/rlimit.h"
+#include "util/statistics.h"
 
 static void display_anums(std::ostream & out, scoped_anum_vector const & rs) {
     out << "numbers in decimal:\n";
@@ -385,6 +386,93 @@ static void tst_eval_sign() {
 
 }
 
+// compare algebraic numbers with rationals inside their isolating intervals,
+// the double filter decides the small ones, exact evaluation the others.
+static void tst_compare_rational() {
+    reslimit rl;
+    unsynch_mpq_manager        qm;
+    algebraic_numbers::manager am(rl, qm);
+    scoped_anum two(am), a(am), b(am);
+    scoped_mpq l(qm), u(qm);
+    am.set(two, 2);
+    for (unsigned n = 2; n <= 5; n++) {
+        for (unsigned prec = 1; prec <= 40; prec++) {
+            // a keeps its coarse isolating interval, b is refined to compute the bounds
+            am.root(two, n, a);
+            am.root(two, n, b);
+            am.get_lower(b, l, prec);
+            am.get_upper(b, u, prec);
+            ENSURE(am.gt(a, l));
+            ENSURE(am.lt(a, u));
+            ENSURE(!am.eq(a, l));
+            ENSURE(!am.eq(a, u));
+            am.neg(a);
+            qm.neg(l);
+            qm.neg(u);
+            ENSURE(am.lt(a, l));
+            ENSURE(am.gt(a, u));
+        }
+    }
+    statistics st;
+    am.collect_statistics(st);
+    ENSURE(st.get_uint("algebraic compare rational double") > 0);
+    ENSURE(st.get_uint("algebraic compare rational exact") > 0);
+}
+
+// evaluate random polynomials at assignments with irrational values,
+// the signs must agree with the signs of the values computed with algebraic arithmetic.
+static void tst_eval_sign_double_interval() {
+    reslimit rl;
+    unsynch_mpq_manager        qm;
+    polynomial::manager        pm(rl, qm);
+    algebraic_numbers::manager am(rl, qm);
+    random_gen rand(0);
+    polynomial::var xs[3] = { pm.mk_var(), pm.mk_var(), pm.mk_var() };
+    scoped_anum_vector vs(am);
+    scoped_anum v(am);
+    am.set(v, 2);
+    am.root(v, 2, v);
+    vs.push_back(v);
+    am.set(v, 3);
+    am.root(v, 2, v);
+    am.neg(v);
+    vs.push_back(v);
+    scoped_mpq q(qm);
+    qm.set(q, 1, 3);
+    am.set(v, q);
+    vs.push_back(v);
+    polynomial::simple_var2value<anum_manager> x2v(am);
+    for (unsigned i = 0; i < 3; i++)
+        x2v.push_back(xs[i], vs[i]);
+    for (unsigned iter = 0; iter < 200; iter++) {
+        polynomial_ref p(pm), m(pm), x(pm);
+        scoped_anum val(am), t(am), pw(am);
+        p = pm.mk_zero();
+        am.set(val, 0);
+        for (unsigned i = 0; i < 4; i++) {
+            int c = static_cast<int>(rand(41)) - 20;
+            m = pm.mk_const(rational(c));
+            am.set(t, c);
+            for (unsigned j = 0; j < 3; j++) {
+                unsigned k = rand(4);
+                x = pm.mk_polynomial(xs[j]);
+                m = m * (x ^ k);
+                am.power(vs[j], k, pw);
+                am.mul(t, pw, t);
+            }
+            p = p + m;
+            am.add(val, t, val);
+        }
+        int s = am.eval_sign_at(p, x2v);
+        ENSURE(s == (am.is_zero(val) ? 0 : am.is_pos(val) ? 1 : -1));
+    }
+    statistics st;
+    am.collect_statistics(st);
+    ENSURE(st.get_uint("algebraic eval sign double interval") > 0);
+    // the isolating intervals are coarse, the exact evaluation decides the other signs
+    ENSURE(st.get_uint("algebraic eval sign interval") + st.get_uint("algebraic eval sign resultant") > 0);
+}
+
 static void tst_isolate_roots(polynomial_ref const & p, anum_manager & am,
                               polynomial::var x0, anum const & v0, polynomial::var x1, anum const & v1, polynomial::var x2, anum const & v2) {
     polynomial::simple_var2value<anum_manager> x2v(am);
@@ -481,6 +569,37 @@ static void tst_isolate_roots() {
     tst_isolate_roots(p, am, 0, v0, 1, v1, 2, v2);
 }
 
+static void tst_locate() {
+    reslimit rl;
+    unsynch_mpq_manager nm;
+    polynomial::manager m(rl, nm);
+    polynomial_ref x(m);
+    x = m.mk_polynomial(m.mk_var());
+    polynomial_ref p(m);
+    p = ((x^2) - 2)*((x^2) - 3)*(x - 1);
+
+    algebraic_numbers::manager am(rl, nm);
+    scoped_anum_vector rs(am);
+    am.isolate_roots(p, rs);
+    ENSURE(rs.size() == 5);
+    bool is_root;
+    scoped_anum v(am);
+    for (unsigned i = 0; i < rs.size(); i++) {
+        am.set(v, rs[i]);
+        ENSURE(am.locate(v, rs, is_root) == i && is_root);
+    }
+    am.set(v, -2);
+    ENSURE(am.locate(v, rs, is_root) == 0 && !is_root);
+    am.set(v, 0);
+    ENSURE(am.locate(v, rs, is_root) == 2 && !is_root);
+    am.set(v, 2);
+    ENSURE(am.locate(v, rs, is_root) == 5 && !is_root);
+    am.set(v, 3);
+    am.root(v, 2, v);
+    am.add(v, rs[0], v); // sqrt(3) - sqrt(3)
+    ENSURE(am.locate(v, rs, is_root) == 2 && !is_root);
+}
+
 static void pp(polynomial_ref const & p, polynomial::var x) {
     unsigned d = degree(p, x);
     for (unsigned i = 0; i <= d; i++) {
@@ -571,8 +690,11 @@ void tst_algebraic() {
     // enable_trace("mpz_gcd");
     tst_root();
     tst_isolate_roots();
+    tst_locate();
     ex1();
     tst_eval_sign();
+    tst_compare_rational();
+    tst_eval_sign_double_interval();
     tst_select_small();
     tst_dejan();
     tst_wilkinson();
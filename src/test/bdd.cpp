@@ -1,4 +1,7 @@
 #include "sat/sat_bdd.h"
+#include "util/debug.h"
+#include "util/util.h"
+#include <vector>
 
 namespace sat {
     static void test1() {
@@ -73,6 +76,106 @@ namespace sat {
         std::cout << c1 << "\n";
         std::cout << c1.bdd_size() << "\n";
     }
+
+    // truth tables over the variables 0..5, bit a of a table is the value under assignment a
+    static uint64_t var_table(unsigned v) {
+        uint64_t t = 0;
+        for (unsigned a = 0; a < 64; ++a)
+            if ((a >> v) & 1)
+                t |= 1ull << a;
+        return t;
+    }
+
+    static uint64_t exists_table(unsigned v, uint64_t t) {
+        uint64_t mask = var_table(v);
+        unsigned shift = 1u << v;
+        return t | ((t & mask) >> shift) | ((t & ~mask) << shift);
+    }
+
+    static bdd table2bdd(bdd_manager& m, uint64_t t) {
+        bdd r = m.mk_false();
+        for (unsigned a = 0; a < 64; ++a) {
+            if (!((t >> a) & 1))
+                continue;
+            bdd c = m.mk_true();
+            for (unsigned v = 0; v < 6; ++v)
+                c = c && (((a >> v) & 1) ? m.mk_var(v) : m.mk_nvar(v));
+            r = r || c;
+        }
+        return r;
+    }
+
+    // the operation cache returns results for the operands they were computed for,
+    // in particular for operations that share the second operand
+    static void test_apply_cache() {
+        bdd_manager m(6);
+        random_gen rand(0);
+        std::vector<bdd> bdds;
+        std::vector<uint64_t> tables;
+        for (unsigned v = 0; v < 6; ++v) {
+            bdds.push_back(m.mk_var(v));
+            tables.push_back(var_table(v));
+        }
+        for (unsigned i = 0; i < 2000; ++i) {
+            // the same operation with two first operands and the same second operand
+            unsigned op = rand(4), k = rand(bdds.size());
+            for (unsigned l = 0; l < 2; ++l) {
+                unsigned j = rand(bdds.size());
+                bdd r = m.mk_false();
+                uint64_t t = 0;
+                switch (op) {
+                case 0: r = bdds[j] && bdds[k]; t = tables[j] & tables[k]; break;
+                case 1: r = bdds[j] || bdds[k]; t = tables[j] | tables[k]; break;
+                case 2: r = bdds[j] ^ bdds[k]; t = tables[j] ^ tables[k]; break;
+                default: r = !bdds[j]; t = ~tables[j]; break;
+                }
+                ENSURE(r == table2bdd(m, t));
+                if (bdds.size() < 64) {
+                    bdds.push_back(r);
+                    tables.push_back(t);
+                }
+                else {
+                    unsigned idx = rand(64);
+                    bdds[idx] = r;
+                    tables[idx] = t;
+                }
+            }
+        }
+    }
+
+    // the constants share level 0 with the first variable
+    static void test_xor_true() {
+        bdd_manager m(3);
+        bdd v0 = m.mk_var(0);
+        bdd v1 = m.mk_var(1);
+        bdd t = m.mk_true();
+        ENSURE((v0 ^ t) == !v0);
+        ENSURE((t ^ v0) == !v0);
+        ENSURE(((v0 && v1) ^ t) == (!v0 || !v1));
+        ENSURE((t ^ t).is_false());
+        ENSURE((m.mk_false() ^ t).is_true());
+    }
+
+    // quantifying over several variables keeps the intermediate results when
+    // building the next result runs out of free nodes and collects garbage
+    static void test_quant_gc() {
+        bdd_manager m(6);
+        random_gen rand(0);
+        for (unsigned i = 0; i < 500; ++i) {
+            uint64_t t = 0;
+            for (unsigned j = 0; j < 5; ++j)
+                t = (t << 15) ^ rand();
+            bdd b = table2bdd(m, t);
+            unsigned vars[3] = { rand(6), rand(6), rand(6) };
+            uint64_t e = t, a = t;
+            for (unsigned v : vars) {
+                e = exists_table(v, e);
+                a = ~exists_table(v, ~a);
+            }
+            ENSURE(m.mk_exists(3, vars, b) == table2bdd(m, e));
+            ENSURE(m.mk_forall(3, vars, b) == table2bdd(m, a));
+        }
+    }
 }
 
 void tst_bdd() {
@@ -80,4 +183,7 @@ void tst_bdd() {
     sat::test2();
     sat::test3();
     sat::test4();
+    sat::test_apply_cache();
+    sat::test_xor_true();
+    sat::test_quant_gc();
 }
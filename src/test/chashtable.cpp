@@ -171,6 +171,64 @@ static void tst6() {
     });
 }
 
+template<typename T>
+static void tst7(unsigned num, unsigned N) {
+    int_set s;
+    T       t;
+    for (unsigned round = 0; round < 10; round++) {
+        for (unsigned i = 0; i < num; i++) {
+            int v = rand() % N;
+            if (rand() % 3 == 2) {
+                s.erase(v);
+                t.erase(v);
+            }
+            else {
+                s.insert(v);
+                t.insert(v);
+            }
+        }
+        ENSURE(s.size() == t.size());
+        for (int v : s)
+            ENSURE(t.contains(v));
+        t.reset_keep_capacity();
+        ENSURE(t.empty());
+        ENSURE(t.used_slots() == 0);
+        ENSURE(t.begin() == t.end());
+        for (int v : s)
+            ENSURE(!t.contains(v));
+        s.reset();
+    }
+}
+
+static void tst8() {
+    int_table t;
+    unsigned init = t.capacity();
+    for (int i = 0; i < 1000; i++)
+        t.insert(i);
+    unsigned cap = t.capacity();
+    ENSURE(cap > init);
+    // a table that is mostly used is kept
+    t.reset_keep_capacity();
+    ENSURE(t.empty());
+    ENSURE(t.capacity() == cap);
+    for (int i = 0; i < 1000; i++)
+        t.insert(i + 1000);
+    ENSURE(t.capacity() == cap);
+    ENSURE(t.size() == 1000 && !t.contains(0) && t.contains(1999));
+    // a table that is mostly unused is released
+    t.reset_keep_capacity();
+    t.insert(1);
+    t.reset_keep_capacity();
+    ENSURE(t.empty());
+    ENSURE(t.capacity() == init);
+    // reset always releases the table
+    for (int i = 0; i < 1000; i++)
+        t.insert(i);
+    t.reset();
+    ENSURE(t.empty());
+    ENSURE(t.capacity() == init);
+}
+
 void tst_chashtable() {
     tst1();
     tst2();
@@ -180,4 +238,7 @@ void tst_chashtable() {
     tst4<dint_table>(10000,10);
     tst4<int_table>(50000,1000);
     tst5();
+    tst7<dint_table>(1000, 100);
+    tst7<int_table>(10000, 1000);
+    tst8();
 }
@@ -0,0 +1,302 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    compiled_expr.cpp
+
+Abstract:
+
+    Compare compiled evaluation with the model evaluator on random terms and models.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#include "util/util.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/ast_pp.h"
+#include "model/compiled_expr.h"
+#include "api/z3.h"
+
+namespace {
+    class term_gen {
+        ast_manager&    m;
+        bv_util         bv;
+        arith_util      a;
+        random_gen&     m_rand;
+        expr_ref_vector m_bv8, m_bv64, m_ints, m_bools;
+    public:
+        term_gen(ast_manager& m, random_gen& r):
+            m(m), bv(m), a(m), m_rand(r), m_bv8(m), m_bv64(m), m_ints(m), m_bools(m) {
+            for (unsigned i = 0; i < 3; ++i) {
+                std::string s = std::to_string(i);
+                m_bv8.push_back(m.mk_const(symbol(("b" + s).c_str()), bv.mk_sort(8)));
+                m_bv64.push_back(m.mk_const(symbol(("w" + s).c_str()), bv.mk_sort(64)));
+                m_ints.push_back(m.mk_const(symbol(("i" + s).c_str()), a.mk_int()));
+                m_bools.push_back(m.mk_const(symbol(("p" + s).c_str()), m.mk_bool_sort()));
+            }
+        }
+
+        expr_ref_vector consts() const {
+            expr_ref_vector r(m);
+            r.append(m_bv8); r.append(m_bv64); r.append(m_ints); r.append(m_bools);
+            return r;
+        }
+
+        expr_ref mk_value(sort* s) {
+            if (m.is_bool(s))
+                return expr_ref(m.mk_bool_val(m_rand(2) == 0), m);
+            if (a.is_int(s)) {
+                rational v(static_cast<int>(m_rand(2000)) - 1000);
+                if (m_rand(8) == 0) v *= power(rational(2), 40);
+                return expr_ref(a.mk_int(v), m);
+            }
+            unsigned sz = bv.get_bv_size(s);
+            rational v(m_rand());
+            if (m_rand(4) == 0) v = power(rational(2), sz) - rational(m_rand(3) + 1);
+            for (unsigned i = 0; i < sz / 16; ++i) v = v * rational(32768) + rational(m_rand());
+            v = mod(v, power(rational(2), sz));
+            return expr_ref(bv.mk_numeral(v, sz), m);
+        }
+
+        expr_ref mk_word(sort* s, uint64_t w) {
+            if (m.is_bool(s))
+                return expr_ref(m.mk_bool_val(w != 0), m);
+            if (a.is_int(s))
+                return expr_ref(a.mk_int(rational(static_cast<int64_t>(w), rational::i64())), m);
+            return expr_ref(bv.mk_numeral(rational(w, rational::ui64()), bv.get_bv_size(s)), m);
+        }
+
+        expr_ref mk_bv(unsigned sz, unsigned d) {
+            expr_ref_vector const& vars = sz == 8 ? m_bv8 : m_bv64;
+            if (d == 0 || m_rand(6) == 0) {
+                if (m_rand(3) == 0) return mk_value(bv.mk_sort(sz));
+                return expr_ref(vars.get(m_rand(vars.size())), m);
+            }
+            expr_ref x = mk_bv(sz, d - 1), y = mk_bv(sz, d - 1);
+            family_id fid = bv.get_fid();
+            switch (m_rand(16)) {
+            case 0: return expr_ref(bv.mk_bv_add(x, y), m);
+            case 1: return expr_ref(bv.mk_bv_sub(x, y), m);
+            case 2: return expr_ref(bv.mk_bv_mul(x, y), m);
+            case 3: return expr_ref(m.mk_app(fid, OP_BAND, x, y), m);
+            case 4: return expr_ref(m.mk_app(fid, OP_BOR, x, y), m);
+            case 5: return expr_ref(m.mk_app(fid, OP_BXOR, x, y), m);
+            case 6: return expr_ref(bv.mk_bv_not(x), m);
+            case 7: return expr_ref(bv.mk_bv_neg(x), m);
+            case 8: return expr_ref(bv.mk_bv_shl(x, m_rand(2) ? y : mk_value(bv.mk_sort(sz))), m);
+            case 9: return expr_ref(bv.mk_bv_lshr(x, y), m);
+            case 10: return expr_ref(bv.mk_bv_ashr(x, bv.mk_numeral(rational(m_rand(sz + 2)), sz)), m);
+            case 11: return expr_ref(m.mk_app(fid, OP_BUDIV, x, y), m);
+            case 12: return expr_ref(bv.mk_bv_urem(x, y), m);
+            case 13: return expr_ref(m.mk_ite(mk_bool(d - 1), x, y), m);
+            case 14: {
+                unsigned k = 1 + m_rand(sz - 1);
+                return expr_ref(bv.mk_concat(bv.mk_extract(sz - 1, k, x), bv.mk_extract(k - 1, 0, y)), m);
+            }
+            default:
+                if (sz == 8) return expr_ref(bv.mk_extract(11, 4, mk_bv(64, d - 1)), m);
+                return expr_ref(m_rand(2) ? bv.mk_sign_extend(56, mk_bv(8, d - 1)) : bv.mk_zero_extend(56, mk_bv(8, d - 1)), m);
+            }
+        }
+
+        expr_ref mk_int(unsigned d) {
+            if (d == 0 || m_rand(6) == 0) {
+                if (m_rand(3) == 0) return mk_value(a.mk_int());
+                return expr_ref(m_ints.get(m_rand(m_ints.size())), m);
+            }
+            expr_ref x = mk_int(d - 1), y = mk_int(d - 1);
+            switch (m_rand(7)) {
+            case 0: return expr_ref(a.mk_add(x, y), m);
+            case 1: return expr_ref(a.mk_sub(x, y), m);
+            case 2: return expr_ref(a.mk_mul(x, y), m);
+            case 3: return expr_ref(a.mk_uminus(x), m);
+            case 4: return expr_ref(a.mk_mod(x, y), m);
+            case 5: return expr_ref(a.mk_idiv(x, y), m);
+            default: return expr_ref(m.mk_ite(mk_bool(d - 1), x, y), m);
+            }
+        }
+
+        expr_ref mk_bool(unsigned d) {
+            if (d == 0 || m_rand(6) == 0)
+                return expr_ref(m_bools.get(m_rand(m_bools.size())), m);
+            unsigned sz = m_rand(2) ? 8 : 64;
+            switch (m_rand(10)) {
+            case 0: return expr_ref(bv.mk_ule(mk_bv(sz, d - 1), mk_bv(sz, d - 1)), m);
+            case 1: return expr_ref(bv.mk_sle(mk_bv(sz, d - 1), mk_bv(sz, d - 1)), m);
+            case 2: return expr_ref(m.mk_app(bv.get_fid(), OP_SLT, mk_bv(sz, d - 1), mk_bv(sz, d - 1)), m);
+            case 3: return expr_ref(m.mk_eq(mk_bv(sz, d - 1), mk_bv(sz, d - 1)), m);
+            case 4: return expr_ref(a.mk_le(mk_int(d - 1), mk_int(d - 1)), m);
+            case 5: return expr_ref(a.mk_gt(mk_int(d - 1), mk_int(d - 1)), m);
+            case 6: return expr_ref(m.mk_and(mk_bool(d - 1), mk_bool(d - 1)), m);
+            case 7: return expr_ref(m.mk_or(mk_bool(d - 1), mk_bool(d - 1)), m);
+            case 8: return expr_ref(m.mk_xor(mk_bool(d - 1), mk_bool(d - 1)), m);
+            default: return expr_ref(m.mk_not(mk_bool(d - 1)), m);
+            }
+        }
+    };
+}
+
+static bool is_word(ast_manager& m, expr* v) {
+    bv_util bv(m);
+    arith_util a(m);
+    rational r;
+    unsigned sz;
+    return m.is_true(v) || m.is_false(v) || bv.is_numeral(v, r, sz) || (a.is_numeral(v, r) && r.is_int64());
+}
+
+static uint64_t to_word(ast_manager& m, expr* v) {
+    bv_util bv(m);
+    arith_util a(m);
+    rational r;
+    unsigned sz;
+    if (m.is_true(v)) return 1;
+    if (m.is_false(v)) return 0;
+    if (bv.is_numeral(v, r, sz)) return r.get_uint64();
+    VERIFY(a.is_numeral(v, r) && r.is_int64());
+    return static_cast<uint64_t>(r.get_int64());
+}
+
+// evaluate batches of assignments to some of the constants and compare with evaluation in one model per assignment
+static bool tst_batch(ast_manager& m, random_gen& r, term_gen& gen, expr_ref_vector const& cs, expr* t) {
+    unsigned num_rows = 1 + r(300);
+    model_ref mdl = alloc(model, m);
+    ptr_vector<func_decl> consts;
+    vector<svector<uint64_t>> columns;
+    for (expr* c : cs) {
+        func_decl* d = to_app(c)->get_decl();
+        if (r(4) == 0) {
+            mdl->register_decl(d, gen.mk_value(m.get_sort(c)));
+            continue;
+        }
+        consts.push_back(d);
+        columns.push_back(svector<uint64_t>());
+        for (unsigned k = 0; k < num_rows; ++k)
+            columns.back().push_back(to_word(m, gen.mk_value(m.get_sort(c))));
+    }
+    ptr_vector<uint64_t const> cols;
+    for (auto const& col : columns) cols.push_back(col.c_ptr());
+    // the batch has a result exactly when the expression evaluates to a word under every assignment
+    expr_ref_vector expected(m);
+    bool all_words = true;
+    for (unsigned k = 0; k < num_rows; ++k) {
+        model_ref row = mdl->copy();
+        for (unsigned j = 0; j < consts.size(); ++j) {
+            expr_ref v = gen.mk_word(consts[j]->get_range(), columns[j][k]);
+            row->register_decl(consts[j], v);
+        }
+        model::scoped_model_completion _scm(*row, true);
+        expr_ref v = (*row)(t);
+        all_words &= is_word(m, v);
+        expected.push_back(v);
+    }
+    svector<uint64_t> results(num_rows, static_cast<uint64_t>(0));
+    compiled_expr ce(m, t);
+    bool ok = ce(*mdl, consts.size(), consts.c_ptr(), num_rows, cols.c_ptr(), results.c_ptr());
+    if (ok != all_words) {
+        std::cout << mk_pp(t, m) << "\n" << expected << "\n";
+        ENSURE(false);
+    }
+    if (!ok)
+        return false;
+    for (unsigned k = 0; k < num_rows; ++k) {
+        if (to_word(m, expected.get(k)) != results[k]) {
+            std::cout << mk_pp(t, m) << "\n" << mk_pp(expected.get(k), m) << " != " << results[k] << "\n";
+            ENSURE(false);
+        }
+    }
+    return true;
+}
+
+// results of Z3_model_eval_many must stay alive together in contexts with reference counting
+static void tst_eval_many_rc() {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context_rc(cfg);
+    Z3_del_config(cfg);
+    Z3_sort bv8 = Z3_mk_bv_sort(ctx, 8);
+    Z3_inc_ref(ctx, Z3_sort_to_ast(ctx, bv8));
+    Z3_func_decl x = Z3_mk_func_decl(ctx, Z3_mk_string_symbol(ctx, "x"), 0, nullptr, bv8);
+    Z3_inc_ref(ctx, Z3_func_decl_to_ast(ctx, x));
+    Z3_ast xc = Z3_mk_app(ctx, x, 0, nullptr);
+    Z3_inc_ref(ctx, xc);
+    Z3_ast three = Z3_mk_unsigned_int(ctx, 3, bv8);
+    Z3_inc_ref(ctx, three);
+    Z3_ast t = Z3_mk_bvmul(ctx, xc, three);
+    Z3_inc_ref(ctx, t);
+    Z3_dec_ref(ctx, xc);
+    Z3_dec_ref(ctx, three);
+    unsigned const num_models = 16;
+    Z3_model ms[num_models];
+    for (unsigned i = 0; i < num_models; ++i) {
+        ms[i] = Z3_mk_model(ctx);
+        Z3_model_inc_ref(ctx, ms[i]);
+        Z3_ast v = Z3_mk_unsigned_int(ctx, 40 + i, bv8);
+        Z3_inc_ref(ctx, v);
+        Z3_add_const_interp(ctx, ms[i], x, v);
+        Z3_dec_ref(ctx, v);
+    }
+    Z3_ast results[num_models];
+    ENSURE(Z3_model_eval_many(ctx, t, true, num_models, ms, results));
+    for (unsigned i = 0; i < num_models; ++i)
+        Z3_inc_ref(ctx, results[i]);
+    for (unsigned i = 0; i < num_models; ++i) {
+        unsigned v = 0;
+        ENSURE(Z3_get_numeral_uint(ctx, results[i], &v));
+        ENSURE(v == ((40 + i) * 3) % 256);
+        Z3_dec_ref(ctx, results[i]);
+        Z3_model_dec_ref(ctx, ms[i]);
+    }
+    Z3_dec_ref(ctx, t);
+    Z3_dec_ref(ctx, Z3_func_decl_to_ast(ctx, x));
+    Z3_dec_ref(ctx, Z3_sort_to_ast(ctx, bv8));
+    Z3_del_context(ctx);
+}
+
+void tst_compiled_expr() {
+    tst_eval_many_rc();
+    ast_manager m;
+    reg_decl_plugins(m);
+    random_gen r(0);
+    term_gen gen(m, r);
+    expr_ref_vector cs = gen.consts();
+    unsigned num_batches = 0, num_word_batches = 0;
+    for (unsigned round = 0; round < 200; ++round) {
+        expr_ref_vector terms(m);
+        terms.push_back(gen.mk_bool(5));
+        terms.push_back(gen.mk_bv(8, 5));
+        terms.push_back(gen.mk_bv(64, 5));
+        terms.push_back(gen.mk_int(5));
+        if (round % 4 == 0) {
+            for (expr* t : terms) {
+                ++num_batches;
+                if (tst_batch(m, r, gen, cs, t))
+                    ++num_word_batches;
+            }
+        }
+        for (unsigned k = 0; k < 10; ++k) {
+            model_ref mdl = alloc(model, m);
+            for (expr* c : cs) {
+                // leave some constants unassigned to exercise model completion
+                if (r(5) != 0)
+                    mdl->register_decl(to_app(c)->get_decl(), gen.mk_value(m.get_sort(c)));
+            }
+            for (expr* t : terms) {
+                compiled_expr ce(m, t);
+                expr_ref v1 = ce(*mdl, true);
+                model::scoped_model_completion _scm(*mdl, true);
+                expr_ref v2 = (*mdl)(t);
+                if (v1 != v2) {
+                    std::cout << mk_pp(t, m) << "\n" << v1 << " != " << v2 << "\n";
+                    ENSURE(false);
+                }
+            }
+        }
+    }
+    std::cout << num_word_batches << " of " << num_batches << " batches evaluated to words\n";
+    // only integer overflow and integer division by zero leave the words
+    ENSURE(2 * num_word_batches > num_batches);
+}
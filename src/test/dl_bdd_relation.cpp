@@ -0,0 +1,135 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    dl_bdd_relation.cpp
+
+Abstract:
+
+    Test the operations of BDD relations that the Datalog queries do not reach,
+    with the bits of the columns interleaved and ordered column by column.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/dl_decl_plugin.h"
+#include "muz/base/dl_context.h"
+#include "muz/fp/dl_register_engine.h"
+#include "muz/rel/rel_context.h"
+#include "muz/rel/dl_bdd_relation.h"
+#include "util/util.h"
+#include <functional>
+
+namespace datalog {
+
+    // columns of 3 bits, 3 bits and a finite sort with 5 elements
+    static const unsigned dom[3] = { 8, 8, 5 };
+
+    class bdd_relation_tester {
+        ast_manager&     m;
+        bv_util          bv;
+        dl_decl_util     dl;
+        sort_ref_vector  m_sorts;
+        relation_signature m_sig;
+        bool             m_in[8][8][5];
+
+        relation_fact mk_fact(unsigned a, unsigned b, unsigned c) {
+            relation_fact f(m);
+            f.push_back(bv.mk_numeral(a, 3));
+            f.push_back(bv.mk_numeral(b, 3));
+            f.push_back(dl.mk_numeral(c, m_sig[2]));
+            return f;
+        }
+
+        // the relation holds exactly the tuples of m_in that satisfy cond
+        template<typename Cond>
+        void check(relation_base const& r, Cond const& cond) {
+            for (unsigned a = 0; a < dom[0]; ++a)
+                for (unsigned b = 0; b < dom[1]; ++b)
+                    for (unsigned c = 0; c < dom[2]; ++c)
+                        ENSURE(r.contains_fact(mk_fact(a, b, c)) == (m_in[a][b][c] && cond(a, b, c)));
+        }
+
+        void test_filter(relation_manager& rm, relation_base const& r, app* cond_e,
+                         std::function<bool(unsigned, unsigned, unsigned)> const& cond) {
+            app_ref cond_r(cond_e, m);
+            scoped_rel<relation_base> t = r.clone();
+            scoped_ptr<relation_mutator_fn> fn = rm.mk_filter_interpreted_fn(*t, cond_r);
+            ENSURE(fn);
+            (*fn)(*t);
+            check(*t, cond);
+        }
+
+    public:
+        bdd_relation_tester(ast_manager& m): m(m), bv(m), dl(m), m_sorts(m) {
+            m_sorts.push_back(bv.mk_sort(3));
+            m_sorts.push_back(bv.mk_sort(3));
+            m_sorts.push_back(dl.mk_sort(symbol("S"), dom[2]));
+            m_sig.append(m_sorts.size(), m_sorts.c_ptr());
+        }
+
+        void test(bool interleave) {
+            smt_params fparams;
+            register_engine re;
+            context ctx(m, re, fparams);
+            params_ref params;
+            params.set_bool("datalog.bdd_interleave", interleave);
+            ctx.updt_params(params);
+            rel_context rc(ctx);
+            relation_manager& rm = rc.get_rmanager();
+            relation_plugin& p = *rm.get_relation_plugin(bdd_relation_plugin::get_name());
+            ENSURE(p.can_handle_signature(m_sig));
+
+            random_gen rand(interleave ? 1 : 2);
+            scoped_rel<relation_base> r = p.mk_empty(m_sig);
+            for (unsigned a = 0; a < dom[0]; ++a)
+                for (unsigned b = 0; b < dom[1]; ++b)
+                    for (unsigned c = 0; c < dom[2]; ++c) {
+                        m_in[a][b][c] = rand(3) == 0;
+                        if (m_in[a][b][c])
+                            r->add_fact(mk_fact(a, b, c));
+                    }
+            check(*r, [](unsigned, unsigned, unsigned) { return true; });
+
+            // conditions compiled into BDDs
+            expr_ref x(m.mk_var(0, m_sig[0]), m);
+            expr_ref y(m.mk_var(1, m_sig[1]), m);
+            expr_ref z(m.mk_var(2, m_sig[2]), m);
+            test_filter(rm, *r, bv.mk_ule(x, y),
+                        [](unsigned a, unsigned b, unsigned) { return a <= b; });
+            test_filter(rm, *r, m.mk_and(m.mk_eq(z, dl.mk_numeral(1, m_sig[2])), m.mk_not(m.mk_eq(x, y))),
+                        [](unsigned a, unsigned b, unsigned c) { return c == 1 && a != b; });
+            test_filter(rm, *r, m.mk_or(m.mk_not(bv.mk_ule(bv.mk_numeral(2, 3), y)), m.mk_eq(x, bv.mk_numeral(7, 3))),
+                        [](unsigned a, unsigned b, unsigned) { return b < 2 || a == 7; });
+            // a condition evaluated on the tuples
+            test_filter(rm, *r, m.mk_eq(bv.mk_bv_add(x, y), bv.mk_numeral(3, 3)),
+                        [](unsigned a, unsigned b, unsigned) { return (a + b) % 8 == 3; });
+
+            // the complement stays within the domain of the finite sort
+            func_decl_ref pred(m.mk_func_decl(symbol("R"), m_sig.size(), m_sig.c_ptr(), m.mk_bool_sort()), m);
+            scoped_rel<relation_base> c = r->complement(pred);
+            for (unsigned a = 0; a < dom[0]; ++a)
+                for (unsigned b = 0; b < dom[1]; ++b)
+                    for (unsigned d = 0; d < dom[2]; ++d)
+                        ENSURE(c->contains_fact(mk_fact(a, b, d)) == !m_in[a][b][d]);
+            scoped_rel<relation_base> empty = p.mk_empty(m_sig);
+            scoped_rel<relation_base> full = empty->complement(pred);
+            expr_ref fml(m);
+            full->to_formula(fml);
+            ENSURE(m.is_or(fml) && to_app(fml)->get_num_args() == dom[0] * dom[1] * dom[2]);
+        }
+    };
+}
+
+void tst_dl_bdd_relation() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    datalog::bdd_relation_tester tester(m);
+    tester.test(true);
+    tester.test(false);
+}
@@ -202,7 +202,204 @@ void dl_query_test_wpa(smt_params & fparams, params_ref& params) {
 
 }
 
+/**
+   \brief Check path against the closure of the edges and the given paths, tri against the nodes
+   on triangles, and loop against the nodes with a self loop and a path back to themselves
+   that ends with an edge.
+*/
+static void dl_query_check_closure(context & ctx, func_decl * path, func_decl * tri, func_decl * loop,
+                                   bool const edges[6][6], bool const given[6][6]) {
+    ast_manager & m = ctx.get_manager();
+    dl_decl_util dl_util(m);
+    sort * s = path->get_domain(0);
+    bool reach[6][6];
+    for (unsigned i = 0; i < 6; ++i)
+        for (unsigned j = 0; j < 6; ++j)
+            reach[i][j] = edges[i][j] || given[i][j];
+    for (unsigned n = 0; n < 6; ++n)
+        for (unsigned i = 0; i < 6; ++i)
+            for (unsigned k = 0; k < 6; ++k)
+                for (unsigned j = 0; j < 6; ++j)
+                    reach[i][j] = reach[i][j] || (reach[i][k] && edges[k][j]);
+    for (unsigned i = 0; i < 6; ++i) {
+        for (unsigned j = 0; j < 6; ++j) {
+            app_ref q(m.mk_app(path, dl_util.mk_numeral(i, s), dl_util.mk_numeral(j, s)), m);
+            lbool is_sat = ctx.query(q);
+            ENSURE(is_sat == (reach[i][j] ? l_true : l_false));
+        }
+    }
+    for (unsigned x = 0; x < 6; ++x) {
+        bool is_tri = false, is_loop = false;
+        for (unsigned y = 0; y < 6; ++y) {
+            for (unsigned z = 0; z < 6; ++z)
+                is_tri |= edges[x][y] && edges[y][z] && edges[z][x];
+            is_loop |= edges[x][x] && reach[x][y] && edges[y][x];
+        }
+        app_ref q(m.mk_app(tri, dl_util.mk_numeral(x, s)), m);
+        ENSURE(ctx.query(q) == (is_tri ? l_true : l_false));
+        q = m.mk_app(loop, dl_util.mk_numeral(x, s));
+        ENSURE(ctx.query(q) == (is_loop ? l_true : l_false));
+    }
+}
+
+/**
+   \brief The updates evaluate the rules as they are given, rules with three positive tails
+   use join_multi instructions only if datalog.multiway_join is set.
+*/
+static void dl_query_test_incremental(symbol const & relation, bool multiway) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    smt_params fparams;
+    register_engine re;
+    context ctx(m, re, fparams);
+    params_ref params;
+    params.set_bool("datalog.incremental", true);
+    params.set_bool("datalog.multiway_join", multiway);
+    if (relation != symbol::null)
+        params.set_sym("datalog.default_relation", relation);
+    ctx.updt_params(params);
+    {
+        parser* p = parser::create(ctx, m);
+        VERIFY(p->parse_string("N 6\n\nedge(x : N, y : N)\npath(x : N, y : N)\ntri(x : N)\nloop(x : N)\n"
+                               "path(X,Y) :- edge(X,Y).\npath(X,Z) :- path(X,Y), edge(Y,Z).\n"
+                               "tri(X) :- edge(X,Y), edge(Y,Z), edge(Z,X).\n"
+                               "loop(X) :- edge(X,X), path(X,Y), edge(Y,X).\n"));
+        dealloc(p);
+    }
+    func_decl * edge = ctx.try_get_predicate_decl(symbol("edge"));
+    func_decl * path = ctx.try_get_predicate_decl(symbol("path"));
+    func_decl * tri = ctx.try_get_predicate_decl(symbol("tri"));
+    func_decl * loop = ctx.try_get_predicate_decl(symbol("loop"));
+    ENSURE(edge && path && tri && loop);
+
+    bool edges[6][6] = {}, given[6][6] = {};
+    random_gen rand(0);
+    for (unsigned round = 0; round < 40; ++round) {
+        for (unsigned k = 0; k < 3; ++k) {
+            unsigned args[2] = { rand(6), rand(6) };
+            bool is_path = rand(4) == 0;
+            bool & in = is_path ? given[args[0]][args[1]] : edges[args[0]][args[1]];
+            if (in)
+                ctx.remove_table_fact(is_path ? path : edge, 2, args);
+            else
+                ctx.add_table_fact(is_path ? path : edge, 2, args);
+            in = !in;
+        }
+        dl_query_check_closure(ctx, path, tri, loop, edges, given);
+    }
+    // retracting facts does not create new predicates once every predicate had deleted facts
+    unsigned num_preds = ctx.get_predicates().size();
+    statistics st;
+    ctx.collect_statistics(st);
+    unsigned num_deleted = st.get_uint("incremental deleted predicates");
+    ENSURE(num_deleted > 0 && num_deleted <= 4);
+    for (unsigned round = 0; round < 20; ++round) {
+        unsigned args[2] = { round % 6, (round + 1) % 6 };
+        bool & in = edges[args[0]][args[1]];
+        if (in)
+            ctx.remove_table_fact(edge, 2, args);
+        else
+            ctx.add_table_fact(edge, 2, args);
+        in = !in;
+        dl_query_check_closure(ctx, path, tri, loop, edges, given);
+    }
+    ENSURE(ctx.get_predicates().size() == num_preds);
+    st.reset();
+    ctx.collect_statistics(st);
+    ENSURE(st.get_uint("incremental deleted predicates") == num_deleted);
+    // the first query evaluates the rules, every later round of changes is an update
+    ENSURE(st.get_uint("incremental rebuilds") == 1);
+    ENSURE(st.get_uint("incremental updates") == 59);
+    ENSURE((st.get_uint("dl.join_multi") > 0) == multiway);
+}
+
+/**
+   \brief Answer queries on triangles and squares of a random graph with the binary join plan
+   and with join_multi instructions, and compare with the answers computed directly.
+*/
+static void dl_query_test_multiway_join(symbol const & relation) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    smt_params fparams;
+    register_engine re_bin, re_multi;
+    context ctx_bin(m, re_bin, fparams), ctx_multi(m, re_multi, fparams);
+    params_ref params;
+    if (relation != symbol::null)
+        params.set_sym("datalog.default_relation", relation);
+    ctx_bin.updt_params(params);
+    params.set_bool("datalog.multiway_join", true);
+    ctx_multi.updt_params(params);
+    // the parser numbers the constants of N in the order of their first occurrence
+    std::ostringstream prog;
+    prog << "N 5\n\ndom(x : N)\nedge(x : N, y : N)\ntri(x : N, y : N, z : N)\nsq(x : N, y : N)\n"
+         << "dom(0).\ndom(1).\ndom(2).\ndom(3).\ndom(4).\n"
+         << "tri(X,Y,Z) :- edge(X,Y), edge(Y,Z), edge(Z,X).\n"
+         << "sq(X,Z) :- edge(X,Y), edge(Y,Z), edge(Z,W), edge(W,X).\n";
+    bool edges[5][5] = {};
+    random_gen rand(0);
+    for (unsigned k = 0; k < 12; ++k) {
+        unsigned x = rand(5), y = rand(5);
+        edges[x][y] = true;
+        prog << "edge(" << x << "," << y << ").\n";
+    }
+    context * ctxs[2] = { &ctx_bin, &ctx_multi };
+    for (context * ctx : ctxs) {
+        parser* p = parser::create(*ctx, m);
+        VERIFY(p->parse_string(prog.str().c_str()));
+        dealloc(p);
+    }
+    dl_decl_util dl_util(m);
+    for (context * ctx : ctxs) {
+        func_decl * tri = ctx->try_get_predicate_decl(symbol("tri"));
+        func_decl * sq = ctx->try_get_predicate_decl(symbol("sq"));
+        ENSURE(tri && sq);
+        sort * s = sq->get_domain(0);
+        expr_ref_vector vars(m);
+        for (unsigned i = 0; i < 3; ++i)
+            vars.push_back(m.mk_var(i, s));
+        app_ref q(m.mk_app(tri, 3, vars.c_ptr()), m);
+        ENSURE(ctx->query(q) == l_true);
+        for (unsigned x = 0; x < 5; ++x) {
+            for (unsigned y = 0; y < 5; ++y) {
+                for (unsigned z = 0; z < 5; ++z) {
+                    relation_fact f(m);
+                    f.push_back(dl_util.mk_numeral(x, s));
+                    f.push_back(dl_util.mk_numeral(y, s));
+                    f.push_back(dl_util.mk_numeral(z, s));
+                    bool is_tri = edges[x][y] && edges[y][z] && edges[z][x];
+                    ENSURE(ctx->result_contains_fact(f) == is_tri);
+                }
+            }
+        }
+        q = m.mk_app(sq, 2, vars.c_ptr());
+        ENSURE(ctx->query(q) == l_true);
+        for (unsigned x = 0; x < 5; ++x) {
+            for (unsigned z = 0; z < 5; ++z) {
+                bool is_sq = false;
+                for (unsigned y = 0; y < 5; ++y)
+                    for (unsigned w = 0; w < 5; ++w)
+                        is_sq |= edges[x][y] && edges[y][z] && edges[z][w] && edges[w][x];
+                relation_fact f(m);
+                f.push_back(dl_util.mk_numeral(x, s));
+                f.push_back(dl_util.mk_numeral(z, s));
+                ENSURE(ctx->result_contains_fact(f) == is_sq);
+            }
+        }
+    }
+    statistics st_bin, st_multi;
+    ctx_bin.collect_statistics(st_bin);
+    ctx_multi.collect_statistics(st_multi);
+    ENSURE(st_bin.get_uint("dl.join_multi") == 0);
+    ENSURE(st_multi.get_uint("dl.join_multi") > 0);
+}
+
 void tst_dl_query() {
+    dl_query_test_incremental(symbol::null, false);
+    dl_query_test_incremental(symbol::null, true);
+    dl_query_test_incremental(symbol("bdd"), false);
+    dl_query_test_multiway_join(symbol::null);
+    dl_query_test_multiway_join(symbol("bdd"));
+
     smt_params fparams;
     params_ref params;
     params.set_sym("default_table", symbol("sparse"));
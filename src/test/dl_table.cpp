@@ -5,6 +5,9 @@ Copyright (c) 2015 Microsoft Corporation
 #include "muz/rel/dl_table.h"
 #include "muz/fp/dl_register_engine.h"
 #include "muz/rel/dl_relation_manager.h"
+#include "muz/rel/dl_leapfrog_join.h"
+#include "util/stopwatch.h"
+#include "util/thread_pool.h"
 
 typedef datalog::table_base* (*mk_table_fn)(datalog::relation_manager& m, datalog::table_signature& sig);
 
@@ -93,6 +96,275 @@ void test_dl_bitvector_table() {
     test_table(mk_bv_table);
 }
 
+static unsigned count_facts(datalog::table_base const & t) {
+    unsigned n = 0;
+    for (datalog::table_base::iterator it = t.begin(), end = t.end(); it != end; ++it)
+        ++n;
+    return n;
+}
+
+static void ensure_same_facts(datalog::table_base const & t1, datalog::table_base const & t2) {
+    datalog::table_fact f;
+    for (datalog::table_base::iterator it = t1.begin(), end = t1.end(); it != end; ++it) {
+        it->get_fact(f);
+        ENSURE(t2.contains_fact(f));
+    }
+    ENSURE(count_facts(t1) == count_facts(t2));
+}
+
+static void add_random_facts(datalog::table_base & t1, datalog::table_base & t2, unsigned n, unsigned dom) {
+    datalog::table_fact f;
+    f.resize(t1.get_signature().size());
+    for (unsigned i = 0; i < n; ++i) {
+        for (unsigned j = 0; j < f.size(); ++j)
+            f[j] = rand() % dom;
+        t1.add_fact(f);
+        t2.add_fact(f);
+    }
+}
+
+/**
+   \brief Run the table operations on column tables and on sparse tables with the same facts,
+   and compare the results.
+*/
+static void test_column_table() {
+    smt_params params;
+    ast_manager ast_m;
+    datalog::register_engine re;
+    datalog::context ctx(ast_m, re, params);
+    datalog::relation_manager & m = ctx.get_rel_context()->get_rmanager();
+    datalog::table_plugin * col = m.get_table_plugin(symbol("column"));
+    datalog::table_plugin * sp = m.get_table_plugin(symbol("sparse"));
+    ENSURE(col && sp);
+    unsigned const dom = 6;
+    datalog::table_signature sig;
+    sig.push_back(dom);
+    sig.push_back(dom);
+    sig.push_back(dom);
+    srand(7);
+
+    // add, remove and contains
+    datalog::scoped_rel<datalog::table_base> c1 = col->mk_empty(sig), s1 = sp->mk_empty(sig);
+    add_random_facts(*c1, *s1, 80, dom);
+    datalog::table_fact f;
+    f.resize(3);
+    for (unsigned i = 0; i < 40; ++i) {
+        f[0] = rand() % dom; f[1] = rand() % dom; f[2] = rand() % dom;
+        c1->remove_fact(f);
+        s1->remove_fact(f);
+        ENSURE(!c1->contains_fact(f));
+    }
+    for (f[0] = 0; f[0] < dom; ++f[0])
+        for (f[1] = 0; f[1] < dom; ++f[1])
+            for (f[2] = 0; f[2] < dom; ++f[2])
+                ENSURE(c1->contains_fact(f) == s1->contains_fact(f));
+    ensure_same_facts(*c1, *s1);
+    ENSURE(c1->get_size_estimate_rows() == count_facts(*s1));
+
+    // union with delta
+    datalog::scoped_rel<datalog::table_base> c2 = col->mk_empty(sig), s2 = sp->mk_empty(sig);
+    add_random_facts(*c2, *s2, 60, dom);
+    datalog::scoped_rel<datalog::table_base> cd = col->mk_empty(sig), sd = sp->mk_empty(sig);
+    scoped_ptr<datalog::table_union_fn> cu = m.mk_union_fn(*c1, *c2, cd.get());
+    scoped_ptr<datalog::table_union_fn> su = m.mk_union_fn(*s1, *s2, sd.get());
+    (*cu)(*c1, *c2, cd.get());
+    (*su)(*s1, *s2, sd.get());
+    ensure_same_facts(*c1, *s1);
+    ensure_same_facts(*cd, *sd);
+    ENSURE(!cd->empty());
+    (*cu)(*c1, *c2, cd.get());
+    ensure_same_facts(*c1, *s1);
+
+    // filters
+    datalog::scoped_rel<datalog::table_base> c3 = c1->clone(), s3 = s1->clone();
+    scoped_ptr<datalog::table_mutator_fn> cfe = m.mk_filter_equal_fn(*c3, 2, 1);
+    scoped_ptr<datalog::table_mutator_fn> sfe = m.mk_filter_equal_fn(*s3, 2, 1);
+    (*cfe)(*c3);
+    (*sfe)(*s3);
+    ensure_same_facts(*c3, *s3);
+    unsigned ident[2] = { 0, 2 };
+    datalog::scoped_rel<datalog::table_base> c4 = c1->clone(), s4 = s1->clone();
+    scoped_ptr<datalog::table_mutator_fn> cfi = m.mk_filter_identical_fn(*c4, 2, ident);
+    scoped_ptr<datalog::table_mutator_fn> sfi = m.mk_filter_identical_fn(*s4, 2, ident);
+    (*cfi)(*c4);
+    (*sfi)(*s4);
+    ensure_same_facts(*c4, *s4);
+
+    // project and rename
+    unsigned removed[1] = { 1 };
+    scoped_ptr<datalog::table_transformer_fn> cp = m.mk_project_fn(*c1, 1, removed);
+    scoped_ptr<datalog::table_transformer_fn> spj = m.mk_project_fn(*s1, 1, removed);
+    datalog::scoped_rel<datalog::table_base> c5 = (*cp)(*c1), s5 = (*spj)(*s1);
+    ensure_same_facts(*c5, *s5);
+    unsigned cycle[3] = { 0, 1, 2 };
+    scoped_ptr<datalog::table_transformer_fn> cr = m.mk_rename_fn(*c1, 3, cycle);
+    scoped_ptr<datalog::table_transformer_fn> sr = m.mk_rename_fn(*s1, 3, cycle);
+    datalog::scoped_rel<datalog::table_base> c6 = (*cr)(*c1), s6 = (*sr)(*s1);
+    ensure_same_facts(*c6, *s6);
+
+    // join on one and on two columns
+    unsigned jc1[2] = { 1, 2 }, jc2[2] = { 0, 1 };
+    for (unsigned n = 1; n <= 2; ++n) {
+        scoped_ptr<datalog::table_join_fn> cj = m.mk_join_fn(*c1, *c2, n, jc1, jc2);
+        scoped_ptr<datalog::table_join_fn> sj = m.mk_join_fn(*s1, *s2, n, jc1, jc2);
+        datalog::scoped_rel<datalog::table_base> c7 = (*cj)(*c1, *c2), s7 = (*sj)(*s1, *s2);
+        ensure_same_facts(*c7, *s7);
+        ENSURE(!c7->empty());
+    }
+}
+
+/**
+   \brief Join two random column tables on one column, where every key occurs in about four rows of each table.
+*/
+static datalog::table_base * mk_random_column_join(datalog::relation_manager & m, unsigned num_rows) {
+    datalog::table_plugin * col = m.get_table_plugin(symbol("column"));
+    ENSURE(col);
+    datalog::table_signature sig;
+    sig.push_back(num_rows);
+    sig.push_back(num_rows);
+    datalog::scoped_rel<datalog::table_base> t1 = col->mk_empty(sig), t2 = col->mk_empty(sig);
+    datalog::table_fact f;
+    f.resize(2);
+    srand(num_rows);
+    for (unsigned i = 0; i < num_rows; ++i) {
+        f[0] = rand() % num_rows; f[1] = rand() % (num_rows / 4);
+        t1->add_fact(f);
+        f[0] = rand() % (num_rows / 4); f[1] = rand() % num_rows;
+        t2->add_fact(f);
+    }
+    ENSURE(t2->get_size_estimate_rows() >= 8192);
+    unsigned c1[1] = { 1 }, c2[1] = { 0 };
+    scoped_ptr<datalog::table_join_fn> j = m.mk_join_fn(*t1, *t2, 1, c1, c2);
+    return (*j)(*t1, *t2);
+}
+
+/**
+   \brief Probe a hash join of column tables with several threads and compare
+   with the join on one thread.
+*/
+static void test_column_join_threads() {
+    // the probes run on the workers of the shared pool
+    thread_pool::set_num_workers(3);
+    smt_params params;
+    ast_manager ast_m;
+    datalog::register_engine re1, re4;
+    params_ref p;
+    datalog::context ctx1(ast_m, re1, params, p);
+    p.set_uint("datalog.join_threads", 4);
+    datalog::context ctx4(ast_m, re4, params, p);
+    datalog::scoped_rel<datalog::table_base> r1 = mk_random_column_join(ctx1.get_rel_context()->get_rmanager(), 20000);
+    datalog::scoped_rel<datalog::table_base> r4 = mk_random_column_join(ctx4.get_rel_context()->get_rmanager(), 20000);
+    ENSURE(!r1->empty());
+    ensure_same_facts(*r1, *r4);
+    thread_pool::finalize();
+}
+
+/**
+   \brief Count the triangles E(x,y), E(y,z), E(z,x) of a random graph
+   with a multi-way join and with a sequence of binary joins.
+   The running times of the joins are reported when \c bench is set.
+*/
+static void test_leapfrog_triangles(symbol const & table_kind, unsigned num_nodes, unsigned num_edges, bool bench = false) {
+    smt_params params;
+    ast_manager ast_m;
+    datalog::register_engine re;
+    datalog::context ctx(ast_m, re, params);
+    datalog::relation_manager & m = ctx.get_rel_context()->get_rmanager();
+    datalog::table_plugin * p = m.get_table_plugin(table_kind);
+    ENSURE(p);
+
+    datalog::table_signature sig;
+    sig.push_back(num_nodes);
+    sig.push_back(num_nodes);
+    datalog::table_base * edges = p->mk_empty(sig);
+    datalog::table_fact f;
+    f.resize(2);
+    srand(num_nodes + num_edges);
+    for (unsigned i = 0; i < num_edges; ++i) {
+        f[0] = rand() % num_nodes;
+        f[1] = rand() % num_nodes;
+        edges->add_fact(f);
+    }
+
+    vector<unsigned_vector> cols;
+    unsigned xy[2] = { 0, 1 }, yz[2] = { 1, 2 }, zx[2] = { 2, 0 };
+    cols.push_back(unsigned_vector(2, xy));
+    cols.push_back(unsigned_vector(2, yz));
+    cols.push_back(unsigned_vector(2, zx));
+    datalog::table_signature res_sig;
+    res_sig.push_back(num_nodes);
+    res_sig.push_back(num_nodes);
+    res_sig.push_back(num_nodes);
+    datalog::table_base const * tables[3] = { edges, edges, edges };
+
+    stopwatch sw;
+    sw.start();
+    datalog::leapfrog_join lf(3, cols);
+    datalog::table_base * triangles = lf(*p, res_sig, 3, tables);
+    sw.stop();
+    unsigned num_triangles = triangles->get_size_estimate_rows();
+    if (bench)
+        std::cout << "(" << table_kind << "-leapfrog :triangles " << num_triangles << " :time " << sw.get_seconds() << ")\n";
+
+    datalog::table_base::iterator it = triangles->begin(), end = triangles->end();
+    datalog::table_fact t, e;
+    e.resize(2);
+    for (; it != end; ++it) {
+        it->get_fact(t);
+        e[0] = t[0]; e[1] = t[1]; ENSURE(edges->contains_fact(e));
+        e[0] = t[1]; e[1] = t[2]; ENSURE(edges->contains_fact(e));
+        e[0] = t[2]; e[1] = t[0]; ENSURE(edges->contains_fact(e));
+    }
+
+    sw.reset();
+    sw.start();
+    unsigned c1[1] = { 1 }, c2[1] = { 0 };
+    datalog::table_join_fn * j1 = m.mk_join_fn(*edges, *edges, 1, c1, c2);
+    datalog::table_base * paths = (*j1)(*edges, *edges);
+    unsigned c3[2] = { 3, 0 }, c4[2] = { 0, 1 };
+    datalog::table_join_fn * j2 = m.mk_join_fn(*paths, *edges, 2, c3, c4);
+    datalog::table_base * cycles = (*j2)(*paths, *edges);
+    sw.stop();
+    unsigned num_cycles = 0;
+    for (it = cycles->begin(), end = cycles->end(); it != end; ++it) {
+        ++num_cycles;
+    }
+    if (bench)
+        std::cout << "(" << table_kind << "-binary-joins :triangles " << num_cycles
+                  << " :intermediate-rows " << paths->get_size_estimate_rows() << " :time " << sw.get_seconds() << ")\n";
+    ENSURE(num_cycles == num_triangles);
+
+    dealloc(j1);
+    dealloc(j2);
+    edges->deallocate();
+    triangles->deallocate();
+    paths->deallocate();
+    cycles->deallocate();
+}
+
 void tst_dl_table() {
     test_dl_bitvector_table();
+    test_column_table();
+    test_column_join_threads();
+    test_leapfrog_triangles(symbol("sparse"), 16, 60);
+    test_leapfrog_triangles(symbol("column"), 16, 60);
+    test_leapfrog_triangles(symbol("sparse"), 256, 4000);
+    test_leapfrog_triangles(symbol("column"), 256, 4000);
+}
+
+/**
+   \brief Usage: test-z3 dl_leapfrog_bench [num-nodes [num-edges]]
+*/
+void tst_dl_leapfrog_bench(char** argv, int argc, int& i) {
+    unsigned num_nodes = 1024, num_edges = 65536;
+    if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+        num_nodes = atoi(argv[i + 1]);
+        ++i;
+        if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            num_edges = atoi(argv[i + 1]);
+            ++i;
+        }
+    }
+    test_leapfrog_triangles(symbol("sparse"), num_nodes, num_edges, true);
+    test_leapfrog_triangles(symbol("column"), num_nodes, num_edges, true);
 }
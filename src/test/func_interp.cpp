@@ -0,0 +1,188 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    func_interp.cpp
+
+Abstract:
+
+    Test the lookup of entries in function interpretations, with and
+    without the hash index that is built for large graphs, and the
+    evaluation of the else case in the model evaluator.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/var_subst.h"
+#include "math/polynomial/algebraic_numbers.h"
+#include "model/model.h"
+
+// the entries of a binary function at the points (k, 2k+1) for k < n,
+// with the result k % 3 + 1.
+static void check_entries(arith_util & a, func_interp const & fi, unsigned n) {
+    expr_ref_vector args(a.get_manager());
+    for (unsigned k = 0; k < 2 * n + 2; ++k) {
+        args.reset();
+        args.push_back(a.mk_int(k));
+        args.push_back(a.mk_int(2 * k + 1));
+        func_entry * e = fi.get_entry(args.c_ptr());
+        ENSURE((e != nullptr) == (k < n));
+        rational v;
+        ENSURE(!e || (a.is_numeral(e->get_result(), v) && v == rational(k % 3 + 1)));
+        // the arguments swapped are not an entry
+        args.reverse();
+        ENSURE(fi.get_entry(args.c_ptr()) == nullptr);
+    }
+}
+
+static void tst_lookup() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    func_interp fi(m, 2);
+    expr_ref_vector args(m);
+    // below the threshold the entries are searched linearly, above it they
+    // are found in the index, which grows with the graph.
+    for (unsigned n = 0; n < 200; ++n) {
+        args.reset();
+        args.push_back(a.mk_int(n));
+        args.push_back(a.mk_int(2 * n + 1));
+        fi.insert_entry(args.c_ptr(), a.mk_int(n % 3 + 1));
+        if (n < 40 || n % 17 == 0)
+            check_entries(a, fi, n + 1);
+    }
+    check_entries(a, fi, 200);
+    ENSURE(fi.num_entries() == 200);
+
+    // updating an entry does not add a new one
+    args.reset();
+    args.push_back(a.mk_int(100));
+    args.push_back(a.mk_int(201));
+    fi.insert_entry(args.c_ptr(), a.mk_int(7));
+    ENSURE(fi.num_entries() == 200);
+    ENSURE(fi.get_entry(args.c_ptr())->get_result() == a.mk_int(7));
+    fi.insert_entry(args.c_ptr(), a.mk_int(2));
+
+    // compress removes the entries with the result of the else case
+    fi.set_else(a.mk_int(1));
+    fi.compress();
+    ENSURE(fi.num_entries() == 133);
+    for (unsigned k = 0; k < 200; ++k) {
+        args.reset();
+        args.push_back(a.mk_int(k));
+        args.push_back(a.mk_int(2 * k + 1));
+        func_entry * e = fi.get_entry(args.c_ptr());
+        ENSURE((e != nullptr) == (k % 3 != 0));
+        ENSURE(!e || e->get_result() == a.mk_int(k % 3 + 1));
+    }
+    // and the index is rebuilt for new entries
+    for (unsigned k = 200; k < 300; ++k) {
+        args.reset();
+        args.push_back(a.mk_int(k));
+        args.push_back(a.mk_int(2 * k + 1));
+        fi.insert_entry(args.c_ptr(), a.mk_int(k % 3 + 1));
+    }
+    ENSURE(fi.num_entries() == 233);
+    for (unsigned k = 0; k < 300; ++k) {
+        args.reset();
+        args.push_back(a.mk_int(k));
+        args.push_back(a.mk_int(2 * k + 1));
+        ENSURE((fi.get_entry(args.c_ptr()) != nullptr) == (k >= 200 || k % 3 != 0));
+    }
+}
+
+// Irrational algebraic numbers are not hash consed by value, so the
+// lookup compares them by value.
+static void tst_algebraic() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    algebraic_numbers::manager & am = a.am();
+    func_interp fi(m, 1);
+    expr_ref_vector arg(m);
+    for (unsigned k = 0; k < 50; ++k) {
+        arg.reset();
+        arg.push_back(a.mk_real(k));
+        fi.insert_entry(arg.c_ptr(), a.mk_int(k));
+    }
+    scoped_anum two(am), sqrt2(am);
+    am.set(two, 2);
+    am.root(two, 2, sqrt2);
+    arg.reset();
+    arg.push_back(a.mk_numeral(sqrt2, false));
+    fi.insert_entry(arg.c_ptr(), a.mk_int(100));
+    ENSURE(fi.num_entries() == 51);
+
+    expr_ref_vector other(m);
+    other.push_back(a.mk_numeral(sqrt2, false));
+    func_entry * e = fi.get_entry(other.c_ptr());
+    ENSURE(e && e->get_result() == a.mk_int(100));
+    fi.insert_entry(other.c_ptr(), a.mk_int(101));
+    ENSURE(fi.num_entries() == 51);
+    for (unsigned k = 0; k < 50; ++k) {
+        arg.reset();
+        arg.push_back(a.mk_real(k));
+        e = fi.get_entry(arg.c_ptr());
+        ENSURE(e && e->get_result() == a.mk_int(k));
+    }
+    am.set(two, 3);
+    am.root(two, 2, sqrt2);
+    arg.reset();
+    arg.push_back(a.mk_numeral(sqrt2, false));
+    ENSURE(fi.get_entry(arg.c_ptr()) == nullptr);
+}
+
+// The evaluator selects the else case without the if-then-else chain for
+// arguments that are not entries; the result is the same.
+static void tst_else() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort * int_sort = a.mk_int();
+    sort * domain[2] = { int_sort, int_sort };
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 2, domain, int_sort), m);
+    for (unsigned n : { 5, 100 }) {
+        func_interp * fi = alloc(func_interp, m, 2);
+        expr_ref_vector args(m);
+        for (unsigned k = 0; k < n; ++k) {
+            args.reset();
+            args.push_back(a.mk_int(k));
+            args.push_back(a.mk_int(k + 1));
+            fi->insert_entry(args.c_ptr(), a.mk_int(3 * k));
+        }
+        // else: x0 - 2*x1
+        fi->set_else(a.mk_sub(m.mk_var(0, int_sort), a.mk_mul(a.mk_int(2), m.mk_var(1, int_sort))));
+        expr_ref interp(fi->get_interp(), m);
+        model_ref mdl = alloc(model, m);
+        mdl->register_decl(f, fi);
+        th_rewriter rw(m);
+        var_subst subst(m, false);
+        for (unsigned i = 0; i < n + 5; ++i) {
+            for (unsigned j = 0; j < n + 5; j += 7) {
+                args.reset();
+                args.push_back(a.mk_int(i));
+                args.push_back(a.mk_int(j));
+                expr_ref r1 = (*mdl)(m.mk_app(f, args.size(), args.c_ptr()));
+                expr_ref r2 = subst(interp, args.size(), args.c_ptr());
+                rw(r2);
+                ENSURE(r1 == r2);
+                ENSURE(r1 == a.mk_int(j == i + 1 && i < n ? 3 * (int)i : (int)i - 2 * (int)j));
+            }
+        }
+    }
+}
+
+void tst_func_interp() {
+    tst_lookup();
+    tst_algebraic();
+    tst_else();
+}
@@ -0,0 +1,79 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    func_interp_bench.cpp
+
+Abstract:
+
+    Construction and evaluation of large function graphs.
+
+    Usage: test-z3 func_interp_bench [num-entries]
+
+    Builds the interpretation of a unary integer function with the
+    given number of entries (default 100000) using insert_entry, and
+    evaluates the function in the model at every entry and at as many
+    points that are not entries.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#include <cstdlib>
+#include <iomanip>
+#include "util/stopwatch.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "model/model.h"
+
+void tst_func_interp_bench(char** argv, int argc, int& i) {
+    unsigned num_entries = 100000;
+    if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+        num_entries = atoi(argv[i + 1]);
+        ++i;
+    }
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    sort * int_sort = a.mk_int();
+    func_decl_ref f(m.mk_func_decl(symbol("f"), 1, &int_sort, int_sort), m);
+    expr_ref_vector vals(m);
+    for (unsigned k = 0; k < 2 * num_entries; ++k)
+        vals.push_back(a.mk_int(k));
+
+    stopwatch sw;
+    sw.start();
+    func_interp * fi = alloc(func_interp, m, 1);
+    // entries at the even numbers
+    for (unsigned k = 0; k < num_entries; ++k) {
+        expr * arg = vals.get(2 * k);
+        fi->insert_entry(&arg, vals.get(k % 1000 + 1));
+    }
+    fi->set_else(a.mk_int(0));
+    model_ref mdl = alloc(model, m);
+    mdl->register_decl(f, fi);
+    sw.stop();
+    double build = sw.get_seconds();
+
+    sw.reset();
+    sw.start();
+    for (unsigned k = 0; k < 2 * num_entries; ++k) {
+        expr_ref r = (*mdl)(m.mk_app(f, vals.get(k)));
+        rational v;
+        ENSURE(a.is_numeral(r, v) && v == rational(k % 2 == 0 ? (k / 2) % 1000 + 1 : 0));
+    }
+    sw.stop();
+    double eval = sw.get_seconds();
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "(func-interp-bench :entries " << num_entries
+              << " :time-build " << build
+              << " :time-eval " << eval
+              << " :evals-per-sec " << std::setprecision(0) << (eval > 0 ? 2 * num_entries / eval : 0)
+              << ")\n";
+}
@@ -0,0 +1,196 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    lp_bench.cpp
+
+Abstract:
+
+    Performance benchmark for the lp subsystem.
+    Every MPS file of the corpus is loaded into lar_solver and solved
+    with each simplex strategy; pivots, factorizations, time and memory
+    are reported as CSV, one line per file and strategy.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+
+--*/
+#ifndef _WINDOWS
+#include <dirent.h>
+#endif
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "util/rational.h"
+#include "util/stopwatch.h"
+#include "util/memory_manager.h"
+#include "util/lp/mps_reader.h"
+#include "util/lp/lar_solver.h"
+#include "test/lp/argument_parser.h"
+
+void gparams_register_modules(){}
+void mem_initialize() {}
+void mem_finalize() {}
+
+namespace lp {
+
+static bool has_mps_extension(std::string const & name) {
+    std::string ext(".mps");
+    if (name.size() <= ext.size())
+        return false;
+    std::string suffix = name.substr(name.size() - ext.size());
+    std::transform(suffix.begin(), suffix.end(), suffix.begin(), ::tolower);
+    return suffix == ext;
+}
+
+static void collect_mps_files_in_directory(std::string const & dir, vector<std::string> & file_names) {
+#ifdef _WINDOWS
+    std::cout << "reading a directory is not supported on this platform, use --filelist" << std::endl;
+#else
+    DIR * d = opendir(dir.c_str());
+    if (d == nullptr) {
+        std::cout << "cannot open directory " << dir << std::endl;
+        return;
+    }
+    vector<std::string> names;
+    while (struct dirent * e = readdir(d)) {
+        std::string name(e->d_name);
+        if (has_mps_extension(name))
+            names.push_back(dir + "/" + name);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    for (auto const & n : names)
+        file_names.push_back(n);
+#endif
+}
+
+static void collect_mps_files_in_list(std::string const & file_list, vector<std::string> & file_names) {
+    std::ifstream in(file_list);
+    if (!in.is_open()) {
+        std::cout << "cannot open " << file_list << std::endl;
+        return;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty())
+            file_names.push_back(line);
+    }
+}
+
+static char const * strategy_name(simplex_strategy_enum s) {
+    switch (s) {
+    case simplex_strategy_enum::tableau_rows: return "tableau_rows";
+    case simplex_strategy_enum::tableau_costs: return "tableau_costs";
+    case simplex_strategy_enum::lu: return "lu";
+    default: return "undecided";
+    }
+}
+
+static void bench_file(std::string const & file_name, simplex_strategy_enum strategy, double time_limit, std::ostream & out) {
+    mps_reader<mpq, mpq> reader(file_name);
+    reader.read();
+    if (!reader.is_ok()) {
+        std::cout << "cannot process " << file_name << std::endl;
+        return;
+    }
+    unsigned long long mem_before = memory::get_allocation_size();
+    // the strategy must be set before the constraints are added, since lu also fills the double solver
+    lar_solver * solver = new lar_solver();
+    solver->settings().simplex_strategy() = strategy;
+    reader.fill_lar_solver(solver);
+    solver->settings().time_limit = time_limit;
+    stopwatch sw;
+    sw.start();
+    lp_status status = solver->solve();
+    sw.stop();
+    unsigned long long mem_after = memory::get_allocation_size();
+    double mem = mem_after > mem_before ? static_cast<double>(mem_after - mem_before)/static_cast<double>(1024*1024) : 0.0;
+    stats const & st = solver->settings().st();
+    out << file_name << ","
+        << strategy_name(strategy) << ","
+        << lp_status_to_string(status) << ","
+        << solver->get_total_iterations() << ","
+        << st.m_num_factorizations << ","
+        << st.m_lu_updates << ","
+        << sw.get_seconds() << ","
+        << mem << std::endl;
+    delete solver;
+}
+
+static void setup_args_parser(argument_parser & parser) {
+    parser.add_option_with_after_string_with_help("--dir", "the directory with the MPS files");
+    parser.add_option_with_after_string_with_help("--filelist", "the file containing the list of MPS files, one per line");
+    parser.add_option_with_after_string_with_help("--file", "a single MPS file");
+    parser.add_option_with_after_string_with_help("--time_limit", "the time limit in seconds for every run");
+    parser.add_option_with_after_string_with_help("--out", "the CSV output file, the standard output by default");
+    parser.add_option_with_help_string("--no_lu", "do not run the strategy presolving with the double solver and LU");
+}
+
+int bench_lp(int argn, char ** argv) {
+    argument_parser args_parser(argn, argv);
+    setup_args_parser(args_parser);
+    if (!args_parser.parse()) {
+        std::cout << args_parser.m_error_message << std::endl;
+        std::cout << args_parser.usage_string();
+        return 1;
+    }
+    vector<std::string> file_names;
+    std::string v = args_parser.get_option_value("--file");
+    if (!v.empty())
+        file_names.push_back(v);
+    v = args_parser.get_option_value("--dir");
+    if (!v.empty())
+        collect_mps_files_in_directory(v, file_names);
+    v = args_parser.get_option_value("--filelist");
+    if (!v.empty())
+        collect_mps_files_in_list(v, file_names);
+    if (file_names.empty()) {
+        std::cout << "no MPS files are given" << std::endl;
+        std::cout << args_parser.usage_string();
+        return 1;
+    }
+    double time_limit = std::numeric_limits<double>::max();
+    v = args_parser.get_option_value("--time_limit");
+    if (!v.empty())
+        time_limit = atof(v.c_str());
+
+    vector<simplex_strategy_enum> strategies;
+    strategies.push_back(simplex_strategy_enum::tableau_rows);
+    strategies.push_back(simplex_strategy_enum::tableau_costs);
+    if (!args_parser.option_is_used("--no_lu"))
+        strategies.push_back(simplex_strategy_enum::lu);
+
+    std::ofstream out_file;
+    v = args_parser.get_option_value("--out");
+    if (!v.empty()) {
+        out_file.open(v);
+        if (!out_file.is_open()) {
+            std::cout << "cannot open " << v << std::endl;
+            return 1;
+        }
+    }
+    std::ostream & out = v.empty() ? std::cout : out_file;
+    out << "file,strategy,status,pivots,factorizations,lu_updates,seconds,memory_mb" << std::endl;
+    for (auto const & fn : file_names)
+        for (auto s : strategies)
+            bench_file(fn, s, time_limit, out);
+    return 0;
+}
+}
+
+int main(int argn, char**argv){
+    rational::initialize();
+    int ret = lp::bench_lp(argn, argv);
+    rational::finalize();
+    return ret;
+}
@@ -158,6 +158,7 @@ int main(int argc, char ** argv) {
     TST(doc);
     TST(udoc_relation);
     TST(string_buffer);
+    TST(sexpr);
     TST(map);
     TST(diff_logic);
     TST(uint_set);
@@ -242,13 +243,28 @@ int main(int argc, char ** argv) {
     TST_ARGV(ddnf);
     TST(ddnf1);
     TST(model_evaluator);
+    TST(compiled_expr);
     TST(get_consequences);
     TST(pb2bv);
     TST_ARGV(sat_lookahead);
     TST_ARGV(sat_local_search);
     TST_ARGV(cnf_backbones);
     TST(bdd);
+    TST_ARGV(rewriter_bench);
+    TST_ARGV(func_interp_bench);
+    TST_ARGV(dl_leapfrog_bench);
     TST(solver_pool);
+    TST(thread_pool);
+    TST(tactic2solver);
+    TST(spacer_parallel);
+    TST(spacer_lemmas);
+    TST(rewrite_cache);
+    TST(par_rewriter);
+    TST(par_tactical);
+    TST(portfolio_tactic);
+    TST(profile_tactic);
+    TST(dl_bdd_relation);
+    TST(func_interp);
     //TST_ARGV(hs);
 }
 
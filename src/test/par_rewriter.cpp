@@ -0,0 +1,110 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    par_rewriter.cpp
+
+Abstract:
+
+    Compare rewriting formulas in parallel with rewriting them one by one.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include <atomic>
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/par_rewriter.h"
+#include "util/thread_pool.h"
+#include "util/util.h"
+
+static expr * mk_random_term(arith_util & a, random_gen & rand, expr_ref_vector const & vars, unsigned depth) {
+    ast_manager & m = a.get_manager();
+    if (depth == 0 || rand(5) == 0)
+        return rand(3) == 0 ? a.mk_int(rand(4)) : vars.get(rand(vars.size()));
+    expr * t1 = mk_random_term(a, rand, vars, depth - 1);
+    expr * t2 = mk_random_term(a, rand, vars, depth - 1);
+    switch (rand(4)) {
+    case 0: return a.mk_add(t1, t2);
+    case 1: return a.mk_mul(t1, a.mk_int(rand(3)));
+    case 2: return a.mk_sub(t1, t1);
+    default: return m.mk_ite(a.mk_le(t1, t2), t1, a.mk_add(t2, a.mk_int(1)));
+    }
+}
+
+static void mk_formulas(ast_manager & m, unsigned num_formulas, expr_ref_vector & fmls) {
+    arith_util a(m);
+    random_gen rand(0);
+    expr_ref_vector vars(m);
+    for (unsigned i = 0; i < 4; ++i)
+        vars.push_back(m.mk_const(symbol((std::string("x") + std::to_string(i)).c_str()), a.mk_int()));
+    for (unsigned i = 0; i < num_formulas; ++i) {
+        expr * t1 = mk_random_term(a, rand, vars, 4);
+        expr * t2 = mk_random_term(a, rand, vars, 4);
+        fmls.push_back(rand(2) == 0 ? a.mk_le(t1, t2) : m.mk_or(m.mk_eq(t1, t2), a.mk_ge(t1, a.mk_int(0))));
+    }
+}
+
+static void tst_same_results(unsigned num_workers, unsigned num_threads, unsigned num_formulas) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    params_ref p;
+    expr_ref_vector fmls(m), seq(m);
+    mk_formulas(m, num_formulas, fmls);
+    expr_ref_vector orig(fmls);
+
+    th_rewriter rw(m, p);
+    unsigned seq_steps = 0;
+    expr_ref r(m);
+    for (expr * f : fmls) {
+        rw(f, r);
+        seq.push_back(r);
+        seq_steps += rw.get_num_steps();
+    }
+
+    thread_pool pool(num_workers);
+    unsigned par_steps = 0;
+    bool is_par = par_rewrite(pool, m, p, num_threads, fmls, par_steps);
+    // every thread needs at least 64 formulas, and the calling thread takes part
+    ENSURE(is_par == (std::min(num_threads, num_workers + 1) > 1 && num_formulas >= 128));
+    ENSURE(fmls.size() == seq.size());
+    for (unsigned i = 0; i < fmls.size(); ++i) {
+        // when the formulas are not rewritten in parallel, they are left unchanged
+        ENSURE(fmls.get(i) == (is_par ? seq.get(i) : orig.get(i)));
+    }
+    ENSURE(!is_par || (par_steps > 0 && seq_steps > 0));
+}
+
+// par_rewrite called from a task of the pool rewrites sequentially
+static void tst_nested() {
+    thread_pool pool(2);
+    std::atomic<unsigned> num_par(0);
+    {
+        thread_pool::task_group tasks(pool);
+        for (unsigned i = 0; i < 4; ++i) {
+            tasks.add([&]() {
+                ast_manager m;
+                reg_decl_plugins(m);
+                expr_ref_vector fmls(m);
+                mk_formulas(m, 256, fmls);
+                unsigned num_steps = 0;
+                if (par_rewrite(pool, m, params_ref(), 4, fmls, num_steps))
+                    ++num_par;
+            });
+        }
+    }
+    ENSURE(num_par == 0);
+}
+
+void tst_par_rewriter() {
+    tst_same_results(3, 4, 512);
+    tst_same_results(1, 2, 128);
+    tst_same_results(3, 4, 100);
+    tst_same_results(0, 4, 512);
+    tst_same_results(3, 1, 512);
+    tst_nested();
+}
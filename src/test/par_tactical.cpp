@@ -0,0 +1,252 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    par_tactical.cpp
+
+Abstract:
+
+    Test the par and par_and_then tacticals on a thread pool with workers.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "ast/reg_decl_plugins.h"
+#include "tactic/tactical.h"
+#include "util/thread_pool.h"
+
+namespace {
+
+    struct tactic_log {
+        std::atomic<unsigned> m_calls;
+        std::atomic<unsigned> m_cancels;
+        std::atomic<unsigned> m_in_parallel;
+        tactic_log(): m_calls(0), m_cancels(0), m_in_parallel(0) {}
+    };
+
+    /**
+       \brief win: add the constant \c name to the goal.
+       loop: run until the manager of the goal is canceled.
+       fail: throw an exception.
+       solve: decide a goal with the constant sat or unsat, loop on the other goals.
+       split: create a goal for every formula.
+    */
+    enum test_kind { WIN, LOOP, FAIL, SOLVE, SPLIT };
+
+    class test_tactic : public tactic {
+        test_kind    m_kind;
+        char const * m_name;
+        tactic_log & m_log;
+
+        static bool has_const(goal const & g, char const * name) {
+            for (unsigned i = 0; i < g.size(); ++i) {
+                expr * f = g.form(i);
+                if (is_app(f) && to_app(f)->get_num_args() == 0 && to_app(f)->get_decl()->get_name() == name)
+                    return true;
+            }
+            return false;
+        }
+
+        void loop(ast_manager & m) {
+            while (!m.canceled())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++m_log.m_cancels;
+            throw tactic_exception(m.limit().get_cancel_msg());
+        }
+
+    public:
+        test_tactic(test_kind k, char const * name, tactic_log & log): m_kind(k), m_name(name), m_log(log) {}
+
+        void operator()(goal_ref const & in, goal_ref_buffer & result) override {
+            ast_manager & m = in->m();
+            ++m_log.m_calls;
+            if (thread_pool::in_parallel())
+                ++m_log.m_in_parallel;
+            switch (m_kind) {
+            case WIN:
+                in->assert_expr(m.mk_const(symbol(m_name), m.mk_bool_sort()));
+                result.push_back(in.get());
+                return;
+            case LOOP:
+                loop(m);
+                return;
+            case FAIL:
+                throw tactic_exception("test tactic failed");
+            case SOLVE:
+                if (has_const(*in, "sat"))
+                    in->reset();
+                else if (has_const(*in, "unsat"))
+                    in->assert_expr(m.mk_false());
+                else
+                    loop(m);
+                result.push_back(in.get());
+                return;
+            case SPLIT:
+                for (unsigned i = 0; i < in->size(); ++i) {
+                    goal * g = alloc(goal, m, false, false);
+                    g->assert_expr(in->form(i));
+                    result.push_back(g);
+                }
+                return;
+            }
+        }
+
+        void cleanup() override {}
+
+        // the tactic is stateless apart from the log, so all managers share it
+        tactic * translate(ast_manager & m) override { return this; }
+
+        static bool is_winner(goal_ref_buffer const & r, char const * name) {
+            return r.size() == 1 && has_const(*r[0], name);
+        }
+    };
+}
+
+static goal_ref mk_goal(ast_manager & m, unsigned num, char const * const * names) {
+    goal_ref g = alloc(goal, m, false, false);
+    for (unsigned i = 0; i < num; ++i)
+        g->assert_expr(m.mk_const(symbol(names[i]), m.mk_bool_sort()));
+    return g;
+}
+
+/**
+   \brief The first tactic that finishes wins, the other tactics are canceled.
+*/
+static void tst_winner() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    tactic_log loop_log, fail_log, win_log;
+    tactic_ref t = par(alloc(test_tactic, LOOP, "loop", loop_log),
+                       alloc(test_tactic, FAIL, "fail", fail_log),
+                       alloc(test_tactic, WIN, "win", win_log));
+    char const * names[1] = { "p" };
+    goal_ref g = mk_goal(m, 1, names);
+    goal_ref_buffer result;
+    (*t)(g, result);
+    ENSURE(test_tactic::is_winner(result, "win"));
+    // the result is translated back to the manager of the goal
+    ENSURE(&result[0]->m() == &m);
+    ENSURE(win_log.m_calls == 1);
+    // a loser that started was canceled, otherwise par would not have returned
+    ENSURE(loop_log.m_calls == loop_log.m_cancels);
+    ENSURE(win_log.m_in_parallel == 1);
+}
+
+/**
+   \brief Canceling the manager of the goal cancels the copies of all tactics.
+*/
+static void tst_outer_cancel() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    tactic_log log;
+    tactic_ref t = par(alloc(test_tactic, LOOP, "loop1", log),
+                       alloc(test_tactic, LOOP, "loop2", log));
+    char const * names[1] = { "p" };
+    goal_ref g = mk_goal(m, 1, names);
+    std::thread canceler([&]() {
+        // the limits of the copies are children of the limit of m once the tactics run
+        while (log.m_calls < 2)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        m.limit().cancel();
+    });
+    goal_ref_buffer result;
+    bool ex = false;
+    try {
+        (*t)(g, result);
+    }
+    catch (tactic_exception &) {
+        ex = true;
+    }
+    canceler.join();
+    m.limit().reset_cancel();
+    ENSURE(ex);
+    ENSURE(log.m_calls == 2 && log.m_cancels == 2);
+}
+
+/**
+   \brief A par nested in a task of par runs its tactics one by one.
+*/
+static void tst_nested() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    tactic_log a_log, b_log, loop_log;
+    tactic_ref inner = par(alloc(test_tactic, WIN, "a", a_log),
+                           alloc(test_tactic, WIN, "b", b_log));
+    tactic_ref t = par(inner.get(), alloc(test_tactic, LOOP, "loop", loop_log));
+    char const * names[1] = { "p" };
+    goal_ref g = mk_goal(m, 1, names);
+    goal_ref_buffer result;
+    (*t)(g, result);
+    // the inner par falls back to or_else: the first tactic succeeds and the second never runs
+    ENSURE(test_tactic::is_winner(result, "a"));
+    ENSURE(a_log.m_calls == 1 && a_log.m_in_parallel == 1);
+    ENSURE(b_log.m_calls == 0);
+    ENSURE(loop_log.m_calls == loop_log.m_cancels);
+}
+
+/**
+   \brief par_and_then: a satisfiable subgoal decides the goal and cancels the
+   other subgoals, unsatisfiable subgoals together decide the goal unsat.
+*/
+static void tst_par_and_then() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    tactic_log split_log, solve_log;
+    tactic_ref t = par_and_then(alloc(test_tactic, SPLIT, "split", split_log),
+                                alloc(test_tactic, SOLVE, "solve", solve_log));
+
+    char const * names1[4] = { "p", "q", "sat", "r" };
+    goal_ref g = mk_goal(m, 4, names1);
+    goal_ref_buffer result;
+    (*t)(g, result);
+    ENSURE(is_decided_sat(result));
+    ENSURE(solve_log.m_calls >= 1 && solve_log.m_calls == solve_log.m_cancels + 1);
+
+    char const * names2[4] = { "unsat", "unsat", "unsat", "unsat" };
+    g = mk_goal(m, 4, names2);
+    result.reset();
+    unsigned calls = solve_log.m_calls;
+    (*t)(g, result);
+    ENSURE(is_decided_unsat(result));
+    // the goal has 4 copies of the same formula, but they are split into 4 subgoals
+    ENSURE(solve_log.m_calls == calls + 4);
+    ENSURE(split_log.m_in_parallel == 0);
+}
+
+/**
+   \brief Without workers par is or_else.
+*/
+static void tst_sequential() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    tactic_log fail_log, a_log, b_log;
+    tactic_ref t = par(alloc(test_tactic, FAIL, "fail", fail_log),
+                       alloc(test_tactic, WIN, "a", a_log),
+                       alloc(test_tactic, WIN, "b", b_log));
+    char const * names[1] = { "p" };
+    goal_ref g = mk_goal(m, 1, names);
+    goal_ref_buffer result;
+    (*t)(g, result);
+    ENSURE(test_tactic::is_winner(result, "a"));
+    ENSURE(fail_log.m_calls == 1 && a_log.m_calls == 1 && b_log.m_calls == 0);
+    ENSURE(a_log.m_in_parallel == 0);
+}
+
+void tst_par_tactical() {
+    thread_pool::set_num_workers(3);
+    tst_winner();
+    tst_outer_cancel();
+    tst_nested();
+    tst_par_and_then();
+    thread_pool::set_num_workers(0);
+    tst_sequential();
+    // the next client creates the shared pool with the default number of workers
+    thread_pool::finalize();
+}
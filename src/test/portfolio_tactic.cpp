@@ -0,0 +1,307 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    portfolio_tactic.cpp
+
+Abstract:
+
+    Test the order in which the portfolio tactic runs its strategies,
+    the knowledge file and the handling of failed and undecided strategies.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "ast/reg_decl_plugins.h"
+#include "tactic/tactic.h"
+#include "tactic/portfolio_tactic.h"
+
+namespace {
+
+    /**
+       \brief decide: decide the goal sat.
+       undecided: add the constant \c name to the goal.
+       fail: throw an exception.
+       slow: decide the goal after \c ms milliseconds unless canceled before.
+    */
+    enum test_kind { DECIDE, UNDECIDED, FAIL, SLOW };
+
+    class test_tactic : public tactic {
+        test_kind        m_kind;
+        char const *     m_name;
+        unsigned         m_ms;
+        std::string &    m_calls;
+    public:
+        test_tactic(test_kind k, char const * name, std::string & calls, unsigned ms = 0):
+            m_kind(k), m_name(name), m_ms(ms), m_calls(calls) {}
+
+        void operator()(goal_ref const & in, goal_ref_buffer & result) override {
+            ast_manager & m = in->m();
+            m_calls += m_name;
+            switch (m_kind) {
+            case DECIDE:
+                in->reset();
+                break;
+            case UNDECIDED:
+                in->assert_expr(m.mk_const(symbol(m_name), m.mk_bool_sort()));
+                break;
+            case FAIL:
+                throw tactic_exception("test tactic failed");
+            case SLOW: {
+                auto start = std::chrono::steady_clock::now();
+                while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(m_ms)) {
+                    if (m.canceled())
+                        throw tactic_exception(m.limit().get_cancel_msg());
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                in->reset();
+                break;
+            }
+            }
+            result.push_back(in.get());
+        }
+
+        void cleanup() override {}
+
+        tactic * translate(ast_manager & m) override { return this; }
+    };
+
+    struct outcome {
+        unsigned m_attempts;
+        unsigned m_solved;
+        double   m_time;
+    };
+}
+
+static char const * s_file = "portfolio_tactic_test.knowledge";
+
+static goal_ref mk_goal(ast_manager & m) {
+    goal_ref g = alloc(goal, m, false, false);
+    g->assert_expr(m.mk_const(symbol("p"), m.mk_bool_sort()));
+    return g;
+}
+
+static params_ref mk_params(unsigned slice, unsigned rounds, bool use_file) {
+    params_ref p;
+    p.set_uint("slice", slice);
+    p.set_uint("rounds", rounds);
+    if (use_file)
+        p.set_str("knowledge_file", s_file);
+    return p;
+}
+
+static bool has_const(goal const & g, char const * name) {
+    for (unsigned i = 0; i < g.size(); ++i) {
+        expr * f = g.form(i);
+        if (is_app(f) && to_app(f)->get_num_args() == 0 && to_app(f)->get_decl()->get_name() == name)
+            return true;
+    }
+    return false;
+}
+
+/**
+   \brief Return the lines of the knowledge file without the comment, as features, strategy and outcome.
+*/
+static void read_file(vector<std::string> & features, vector<std::string> & names, vector<outcome> & outcomes) {
+    std::ifstream in(s_file);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == ';')
+            continue;
+        size_t i = line.find('\t');
+        size_t j = line.find('\t', i + 1);
+        ENSURE(i != std::string::npos && j != std::string::npos);
+        features.push_back(line.substr(0, i));
+        names.push_back(line.substr(i + 1, j - i - 1));
+        std::istringstream nums(line.substr(j + 1));
+        outcome o;
+        nums >> o.m_attempts >> o.m_solved >> o.m_time;
+        ENSURE(!nums.fail());
+        outcomes.push_back(o);
+    }
+}
+
+/**
+   \brief Return the features of the test goal, as recorded in the knowledge file.
+*/
+static std::string get_features() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    std::string calls;
+    tactic * ts[1] = { alloc(test_tactic, DECIDE, "d", calls) };
+    char const * names[1] = { "d" };
+    tactic_ref t = mk_portfolio_tactic(m, 1, names, ts, mk_params(1000, 1, true));
+    goal_ref_buffer result;
+    (*t)(mk_goal(m), result);
+    vector<std::string> features, ns;
+    vector<outcome> outcomes;
+    read_file(features, ns, outcomes);
+    ENSURE(features.size() == 1);
+    std::remove(s_file);
+    return features[0];
+}
+
+/**
+   \brief Strategies that decided similar goals come first, by average solving time, then the
+   strategies without outcomes, then the strategies that never decided such goals.
+*/
+static void tst_ranking(std::string const & features) {
+    {
+        std::ofstream out(s_file);
+        out << "; features\tstrategy\tattempts\tsolved\tsolving-time\n";
+        out << features << "\tnever\t3\t0\t0\n";
+        out << features << "\tslow\t2\t2\t0.2\n";
+        out << features << "\tfast\t2\t1\t0.01\n";
+        // outcomes for other features do not count
+        out << "other size:9 bool:9 arith:9 bv:9\tnone\t1\t1\t0.001\n";
+    }
+    ast_manager m;
+    reg_decl_plugins(m);
+    std::string calls;
+    tactic * ts[4] = {
+        alloc(test_tactic, UNDECIDED, "N", calls),
+        alloc(test_tactic, UNDECIDED, "S", calls),
+        alloc(test_tactic, UNDECIDED, "F", calls),
+        alloc(test_tactic, UNDECIDED, "X", calls)
+    };
+    char const * names[4] = { "never", "slow", "fast", "none" };
+    tactic_ref t = mk_portfolio_tactic(m, 4, names, ts, mk_params(1000, 1, true));
+    goal_ref g = mk_goal(m);
+    goal_ref_buffer result;
+    (*t)(g, result);
+    ENSURE(calls == "FSXN");
+    // every strategy is undecided, the result of the first one is used
+    ENSURE(result.size() == 1 && has_const(*result[0], "F") && !has_const(*result[0], "S"));
+    std::remove(s_file);
+}
+
+/**
+   \brief The outcomes of every invocation are merged with the file, other lines are kept.
+*/
+static void tst_round_trip(std::string const & features) {
+    {
+        std::ofstream out(s_file);
+        out << features << "\tb\t5\t1\t0.5\n";
+        out << "quant size:1 bool:0 arith:0 bv:0\ta\t7\t7\t1.5\n";
+    }
+    ast_manager m;
+    reg_decl_plugins(m);
+    std::string calls;
+    tactic * ts[2] = {
+        alloc(test_tactic, FAIL, "A", calls),
+        alloc(test_tactic, DECIDE, "B", calls)
+    };
+    char const * names[2] = { "a", "b" };
+    tactic_ref t = mk_portfolio_tactic(m, 2, names, ts, mk_params(1000, 2, true));
+    for (unsigned k = 0; k < 2; ++k) {
+        goal_ref_buffer result;
+        goal_ref g = mk_goal(m);
+        (*t)(g, result);
+        ENSURE(is_decided_sat(result));
+    }
+    // b decided goals with these features, so it runs first and a never runs
+    ENSURE(calls == "BB");
+    vector<std::string> fs, ns;
+    vector<outcome> outcomes;
+    read_file(fs, ns, outcomes);
+    ENSURE(ns.size() == 2);
+    for (unsigned i = 0; i < ns.size(); ++i) {
+        if (ns[i] == "a") {
+            ENSURE(fs[i] != features);
+            ENSURE(outcomes[i].m_attempts == 7 && outcomes[i].m_solved == 7);
+        }
+        else {
+            ENSURE(ns[i] == "b" && fs[i] == features);
+            ENSURE(outcomes[i].m_attempts == 7 && outcomes[i].m_solved == 3);
+            ENSURE(outcomes[i].m_time >= 0.5);
+        }
+    }
+    std::remove(s_file);
+}
+
+/**
+   \brief Failed strategies are dropped, strategies that time out run again with a larger slice,
+   and the last remaining strategy runs without time limit.
+*/
+static void tst_drop_failed() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    std::string calls;
+    tactic * ts[2] = {
+        alloc(test_tactic, FAIL, "F", calls),
+        alloc(test_tactic, SLOW, "S", calls, 100)
+    };
+    char const * names[2] = { "f", "s" };
+    // slices of 5 and 10 milliseconds are too short for s
+    tactic_ref t = mk_portfolio_tactic(m, 2, names, ts, mk_params(5, 2, false));
+    goal_ref g = mk_goal(m);
+    goal_ref_buffer result;
+    (*t)(g, result);
+    ENSURE(is_decided_sat(result));
+    ENSURE(calls == "FSSS");
+    statistics st;
+    t->collect_statistics(st);
+    ENSURE(st.get_uint("portfolio failures") == 1);
+    ENSURE(st.get_uint("portfolio timeouts") == 2);
+    ENSURE(st.get_uint("portfolio slices") == 4);
+    ENSURE(!m.canceled());
+}
+
+/**
+   \brief When no strategy decides the goal, the first undecided result is used,
+   and without undecided results the portfolio fails.
+*/
+static void tst_fallback() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    std::string calls;
+    char const * names[2] = { "f", "u" };
+    tactic * ts1[2] = {
+        alloc(test_tactic, FAIL, "F", calls),
+        alloc(test_tactic, UNDECIDED, "U", calls)
+    };
+    tactic_ref t = mk_portfolio_tactic(m, 2, names, ts1, mk_params(5, 2, false));
+    goal_ref g = mk_goal(m);
+    goal_ref_buffer result;
+    (*t)(g, result);
+    ENSURE(calls == "FU");
+    ENSURE(result.size() == 1 && !result[0]->is_decided() && has_const(*result[0], "U"));
+    // the goal is replaced by the undecided goal
+    ENSURE(has_const(*g, "U"));
+
+    calls.clear();
+    tactic * ts3[2] = {
+        alloc(test_tactic, FAIL, "F", calls),
+        alloc(test_tactic, FAIL, "G", calls)
+    };
+    t = mk_portfolio_tactic(m, 2, names, ts3, mk_params(5, 2, false));
+    g = mk_goal(m);
+    result.reset();
+    bool ex = false;
+    try {
+        (*t)(g, result);
+    }
+    catch (tactic_exception & e) {
+        ex = true;
+        ENSURE(strcmp(e.msg(), "test tactic failed") == 0);
+    }
+    ENSURE(ex && calls == "FG");
+}
+
+void tst_portfolio_tactic() {
+    std::string features = get_features();
+    tst_ranking(features);
+    tst_round_trip(features);
+    tst_drop_failed();
+    tst_fallback();
+}
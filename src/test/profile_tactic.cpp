@@ -0,0 +1,124 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    profile_tactic.cpp
+
+Abstract:
+
+    Test the invocation tree that profiled tactics record for nested
+    then and par-or tacticals, and the collapsed stack output.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "ast/reg_decl_plugins.h"
+#include "tactic/tactical.h"
+#include "tactic/profile_tactic.h"
+#include "tactic/core/simplify_tactic.h"
+#include "util/thread_pool.h"
+
+static char const * s_file = "profile_tactic_test.folded";
+
+/**
+   \brief (then simplify (par-or fail skip) simplify), with every node profiled.
+*/
+static tactic * mk_strategy(ast_manager & m, params_ref const & p) {
+    tactic * branches = par(mk_profile_tactic("fail", mk_fail_tactic()),
+                            mk_profile_tactic("skip", mk_skip_tactic()));
+    return mk_profile_tactic("then",
+                             and_then(mk_profile_tactic("simplify", mk_simplify_tactic(m)),
+                                      mk_profile_tactic("par-or", branches),
+                                      mk_profile_tactic("simplify", mk_simplify_tactic(m))),
+                             p);
+}
+
+static void apply(ast_manager & m, tactic & t) {
+    goal_ref g = alloc(goal, m, false, false);
+    expr_ref p(m.mk_const(symbol("p"), m.mk_bool_sort()), m);
+    expr_ref q(m.mk_const(symbol("q"), m.mk_bool_sort()), m);
+    g->assert_expr(m.mk_and(p, m.mk_or(q, m.mk_false())));
+    goal_ref_buffer result;
+    t(g, result);
+    ENSURE(result.size() == 1 && result[0]->size() == 2);
+}
+
+/**
+   \brief The tree is displayed on the verbose stream: nodes are indented by their depth,
+   and the invocations of the same tactic under the same parent are merged.
+*/
+static void tst_display() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    tactic_ref t = mk_strategy(m, params_ref());
+    std::ostringstream out;
+    set_verbose_stream(out);
+    apply(m, *t);
+    set_verbose_stream(std::cerr);
+    std::string s = out.str();
+    ENSURE(s.find("(tactic-profile\n  (then :calls 1 ") == 0);
+    ENSURE(s.find("\n    (simplify :calls 2 ") != std::string::npos);
+    ENSURE(s.find("\n    (par-or :calls 1 ") != std::string::npos);
+    // the branches of par-or run on copies of the tactics in other threads, but stay below par-or
+    ENSURE(s.find("\n      (skip :calls 1 ") != std::string::npos);
+    ENSURE(s.find("\n    (skip") == std::string::npos && s.find("\n    (fail") == std::string::npos);
+    // the goal p, (or q false) is simplified to p, q
+    std::string root = s.substr(0, s.find('\n', 16));
+    ENSURE(root.find(":size 4 -> 2") != std::string::npos);
+    // the display is produced once, by the outermost tactic
+    ENSURE(s.find("(tactic-profile", 1) == std::string::npos);
+}
+
+/**
+   \brief With tactic.profile.file, every invocation of the outermost tactic appends
+   one line per path: the tactic names separated by ';' and the self time in microseconds.
+*/
+static void tst_collapsed() {
+    std::remove(s_file);
+    ast_manager m;
+    reg_decl_plugins(m);
+    params_ref p;
+    p.set_str("profile.file", s_file);
+    tactic_ref t = mk_strategy(m, p);
+    apply(m, *t);
+    apply(m, *t);
+    std::ifstream in(s_file);
+    std::string line;
+    vector<std::string> paths;
+    while (std::getline(in, line)) {
+        size_t i = line.rfind(' ');
+        ENSURE(i != std::string::npos && i > 0 && i + 1 < line.size());
+        for (size_t j = i + 1; j < line.size(); ++j)
+            ENSURE('0' <= line[j] && line[j] <= '9');
+        paths.push_back(line.substr(0, i));
+    }
+    in.close();
+    std::remove(s_file);
+    // fail may be canceled before it starts, so it has no line in some invocations
+    unsigned num_then = 0, num_simplify = 0, num_par = 0, num_skip = 0;
+    for (std::string const & path : paths) {
+        if (path == "then") ++num_then;
+        else if (path == "then;simplify") ++num_simplify;
+        else if (path == "then;par-or") ++num_par;
+        else if (path == "then;par-or;skip") ++num_skip;
+        else ENSURE(path == "then;par-or;fail");
+    }
+    // the merged simplify nodes have one line per invocation of the outermost tactic
+    ENSURE(num_then == 2 && num_simplify == 2 && num_par == 2 && num_skip == 2);
+    ENSURE(paths[0] == "then" && paths[1] == "then;simplify" && paths[2] == "then;par-or");
+}
+
+void tst_profile_tactic() {
+    // par-or runs its branches on the workers of the shared pool
+    thread_pool::set_num_workers(2);
+    tst_display();
+    tst_collapsed();
+    thread_pool::finalize();
+}
@@ -0,0 +1,240 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    rewrite_cache.cpp
+
+Abstract:
+
+    Test the rewrite results kept across calls to th_rewriter.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include "api/z3.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/rewriter/th_rewriter.h"
+#include "ast/rewriter/rewrite_cache.h"
+#include "util/util.h"
+
+static void tst_lru() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref_vector ts(m), rs(m);
+    for (unsigned i = 0; i < 5; ++i) {
+        ts.push_back(a.mk_add(x, a.mk_int(i)));
+        rs.push_back(a.mk_int(i));
+    }
+    rewrite_cache c(m, 3);
+    expr * r = nullptr;
+    c.insert(ts.get(0), 0, rs.get(0));
+    c.insert(ts.get(1), 0, rs.get(1));
+    c.insert(ts.get(2), 0, rs.get(2));
+    ENSURE(c.size() == 3);
+    // the lookup makes ts[0] the most recently used entry, so ts[1] is evicted first
+    ENSURE(c.find(ts.get(0), 0, r) && r == rs.get(0));
+    c.insert(ts.get(3), 0, rs.get(3));
+    ENSURE(c.size() == 3);
+    ENSURE(c.contains(ts.get(0), 0) && !c.contains(ts.get(1), 0));
+    ENSURE(c.contains(ts.get(2), 0) && c.contains(ts.get(3), 0));
+    c.insert(ts.get(4), 0, rs.get(4));
+    ENSURE(c.contains(ts.get(0), 0) && !c.contains(ts.get(2), 0));
+    ENSURE(!c.find(ts.get(1), 0, r));
+    statistics st;
+    c.collect_statistics(st);
+    ENSURE(st.get_uint("rewrite cache evictions") == 2);
+    ENSURE(st.get_uint("rewrite cache hits") == 1);
+    ENSURE(st.get_uint("rewrite cache misses") == 1);
+    // shrinking the bound evicts the least recently used entries
+    c.set_max_size(1);
+    ENSURE(c.size() == 1 && c.contains(ts.get(4), 0));
+    // a bound of 0 disables the cache
+    c.set_max_size(0);
+    c.insert(ts.get(0), 0, rs.get(0));
+    ENSURE(c.size() == 0);
+}
+
+static void tst_release() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref t1(a.mk_add(x, a.mk_int(1)), m), t2(a.mk_add(x, a.mk_int(2)), m);
+    expr_ref r1(a.mk_mul(x, a.mk_int(3)), m), r2(a.mk_mul(x, a.mk_int(4)), m);
+    unsigned rc_t1 = t1->get_ref_count(), rc_r1 = r1->get_ref_count();
+    rewrite_cache c(m, 1);
+    c.insert(t1, 0, r1);
+    ENSURE(t1->get_ref_count() == rc_t1 + 1 && r1->get_ref_count() == rc_r1 + 1);
+    // evicting the entry releases the key and the value
+    c.insert(t2, 0, r2);
+    ENSURE(t1->get_ref_count() == rc_t1 && r1->get_ref_count() == rc_r1);
+    // terms only referenced by the cache are reclaimed once they are evicted
+    // the arithmetic plugin keeps small numerals alive, create them up front
+    expr_ref five(a.mk_int(5), m), six(a.mk_int(6), m);
+    unsigned num_asts = m.get_num_asts();
+    {
+        expr_ref t3(a.mk_add(x, five), m), r3(a.mk_mul(x, six), m);
+        c.insert(t3, 0, r3);
+    }
+    ENSURE(m.get_num_asts() > num_asts);
+    c.insert(t1, 0, r1);
+    ENSURE(m.get_num_asts() <= num_asts);
+    c.reset();
+    ENSURE(t1->get_ref_count() == rc_t1 && r1->get_ref_count() == rc_r1);
+    ENSURE(c.size() == 0);
+}
+
+static void tst_fingerprints() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref t(a.mk_mul(a.mk_add(x, a.mk_int(1)), a.mk_add(x, a.mk_int(2))), m);
+    params_ref p1, p2;
+    p2.set_bool("som", true);
+    expr_ref r1(m), r2(m), s1(m), s2(m);
+    th_rewriter(m, p1)(t, r1);
+    th_rewriter(m, p2)(t, r2);
+    ENSURE(r1 != r2);
+
+    rewrite_cache c(m, 100);
+    th_rewriter rw1(m, p1), rw2(m, p2);
+    rw1.set_cache(&c);
+    rw2.set_cache(&c);
+    rw1(t, s1);
+    unsigned sz = c.size();
+    ENSURE(sz > 0);
+    rw2(t, s2);
+    ENSURE(s1 == r1 && s2 == r2);
+    // both configurations have their own entries
+    ENSURE(c.size() > sz);
+    statistics st;
+    c.collect_statistics(st);
+    ENSURE(st.get_uint("rewrite cache hits") == 0);
+
+    // a rewriter with the same parameters uses the entries of rw1
+    th_rewriter rw3(m, p1);
+    rw3.set_cache(&c);
+    rw3(t, s1);
+    ENSURE(s1 == r1);
+    st.reset();
+    c.collect_statistics(st);
+    unsigned hits = st.get_uint("rewrite cache hits");
+    ENSURE(hits > 0);
+
+    // updating the parameters updates the fingerprint
+    rw3.updt_params(p2);
+    rw3(t, s2);
+    ENSURE(s2 == r2);
+    st.reset();
+    c.collect_statistics(st);
+    ENSURE(st.get_uint("rewrite cache hits") > hits);
+}
+
+static void tst_proofs() {
+    ast_manager m(PGM_ENABLED);
+    reg_decl_plugins(m);
+    arith_util a(m);
+    expr_ref x(m.mk_const(symbol("x"), a.mk_int()), m);
+    expr_ref t(a.mk_le(a.mk_add(x, a.mk_int(1)), a.mk_add(x, a.mk_int(2))), m), r(m);
+    proof_ref pr(m);
+    rewrite_cache c(m, 100);
+    th_rewriter rw(m);
+    rw.set_cache(&c);
+    rw(t, r, pr);
+    ENSURE(m.is_true(r) && pr);
+    rw(t, r, pr);
+    ENSURE(m.is_true(r) && pr);
+    ENSURE(c.size() == 0);
+    statistics st;
+    c.collect_statistics(st);
+    ENSURE(st.get_uint("rewrite cache hits") == 0 && st.get_uint("rewrite cache misses") == 0);
+}
+
+static expr * mk_random_term(arith_util & a, random_gen & rand, expr_ref_vector & pool, unsigned depth) {
+    ast_manager & m = a.get_manager();
+    if (depth == 0 || rand(4) == 0)
+        return pool.get(rand(pool.size()));
+    expr * t1 = mk_random_term(a, rand, pool, depth - 1);
+    expr * t2 = mk_random_term(a, rand, pool, depth - 1);
+    expr * r = nullptr;
+    switch (rand(5)) {
+    case 0: r = a.mk_add(t1, t2); break;
+    case 1: r = a.mk_mul(t1, a.mk_int(rand(3))); break;
+    case 2: r = a.mk_sub(t1, t1); break;
+    case 3: r = m.mk_ite(a.mk_le(t1, t2), t1, a.mk_add(t2, a.mk_int(1))); break;
+    default: r = a.mk_add(t2, a.mk_int(0)); break;
+    }
+    // keep subterms around so that later terms share them
+    pool.push_back(r);
+    return r;
+}
+
+static void tst_same_results() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    random_gen rand(0);
+    expr_ref_vector pool(m);
+    for (unsigned i = 0; i < 3; ++i)
+        pool.push_back(m.mk_const(symbol((std::string("x") + std::to_string(i)).c_str()), a.mk_int()));
+    pool.push_back(a.mk_int(1));
+    // a small bound, so that entries are evicted while the terms are simplified
+    rewrite_cache c(m, 50);
+    th_rewriter cached(m), plain(m);
+    cached.set_cache(&c);
+    for (unsigned i = 0; i < 300; ++i) {
+        expr_ref t(mk_random_term(a, rand, pool, 5), m), r1(m), r2(m);
+        cached(t, r1);
+        plain(t, r2);
+        ENSURE(r1 == r2);
+    }
+    statistics st;
+    c.collect_statistics(st);
+    ENSURE(st.get_uint("rewrite cache hits") > 0);
+    ENSURE(st.get_uint("rewrite cache evictions") > 0);
+}
+
+/**
+   \brief Z3_simplify with rewriter.persistent_cache on and off.
+*/
+static void tst_api() {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_sort int_sort = Z3_mk_int_sort(ctx);
+    Z3_ast x = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "x"), int_sort);
+    Z3_ast y = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, "y"), int_sort);
+    Z3_params on = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, on);
+    Z3_params off = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, off);
+    Z3_params_set_uint(ctx, on, Z3_mk_string_symbol(ctx, "persistent_cache"), 1000);
+    Z3_ast t = Z3_mk_int(ctx, 0, int_sort);
+    for (unsigned i = 0; i < 20; ++i) {
+        Z3_ast args[3] = { t, Z3_mk_int(ctx, i, int_sort), i % 2 ? x : y };
+        t = Z3_mk_add(ctx, 3, args);
+        Z3_ast c = Z3_mk_le(ctx, t, Z3_mk_add(ctx, 3, args));
+        Z3_ast r1 = Z3_simplify_ex(ctx, Z3_mk_ite(ctx, c, t, x), on);
+        Z3_ast r2 = Z3_simplify_ex(ctx, Z3_mk_ite(ctx, c, t, x), off);
+        ENSURE(Z3_is_eq_ast(ctx, r1, r2));
+    }
+    Z3_params_dec_ref(ctx, on);
+    Z3_params_dec_ref(ctx, off);
+    Z3_del_context(ctx);
+}
+
+void tst_rewrite_cache() {
+    tst_lru();
+    tst_release();
+    tst_fingerprints();
+    tst_proofs();
+    tst_same_results();
+    tst_api();
+}
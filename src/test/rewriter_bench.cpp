@@ -0,0 +1,112 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    rewriter_bench.cpp
+
+Abstract:
+
+    Throughput of th_rewriter on deep bit-vector terms.
+
+    Usage: test-z3 rewriter_bench [depth]
+
+    Reports the number of rewriting steps per second for a deep term
+    without sharing and for a deep term where every level is shared,
+    once with a new rewriter for every call and once with a rewriter
+    that is reused across calls.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+
+#include <cstdlib>
+#include <iomanip>
+#include "util/stopwatch.h"
+#include "ast/bv_decl_plugin.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/for_each_expr.h"
+#include "ast/rewriter/th_rewriter.h"
+
+static expr_ref mk_unshared_term(bv_util& bv, expr_ref_vector const& xs, unsigned depth) {
+    ast_manager& m = bv.get_manager();
+    expr_ref t(xs.get(0), m);
+    for (unsigned k = 0; k < depth; ++k) {
+        expr* x = xs.get(k % xs.size());
+        expr_ref c(bv.mk_numeral(rational(k % 7 + 1), 32), m);
+        t = bv.mk_bv_add(bv.mk_bv_mul(c, t), m.mk_app(bv.get_fid(), OP_BAND, x, bv.mk_numeral(rational(255), 32)));
+    }
+    return t;
+}
+
+static expr_ref mk_shared_term(bv_util& bv, expr_ref_vector const& xs, unsigned depth) {
+    ast_manager& m = bv.get_manager();
+    expr_ref t(xs.get(0), m);
+    for (unsigned k = 0; k < depth; ++k) {
+        expr* x = xs.get(k % xs.size());
+        expr* y = xs.get((k + 1) % xs.size());
+        t = bv.mk_bv_mul(bv.mk_bv_add(t, x), bv.mk_bv_add(t, y));
+    }
+    return t;
+}
+
+static void bench(char const* name, ast_manager& m, expr* t, unsigned reps) {
+    expr_ref r(m);
+    unsigned num_steps = 0;
+    stopwatch sw;
+    sw.start();
+    for (unsigned i = 0; i < reps; ++i) {
+        th_rewriter rw(m);
+        rw(t, r);
+        num_steps += rw.get_num_steps();
+    }
+    sw.stop();
+    double fresh = sw.get_seconds();
+
+    num_steps = 0;
+    sw.reset();
+    sw.start();
+    th_rewriter rw(m);
+    for (unsigned i = 0; i < reps; ++i) {
+        rw.reset();
+        rw(t, r);
+        num_steps += rw.get_num_steps();
+    }
+    sw.stop();
+    double reused = sw.get_seconds();
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "(rewriter-bench :term " << name
+              << " :nodes " << get_num_exprs(t)
+              << " :steps " << num_steps
+              << " :time-fresh " << fresh
+              << " :steps-per-sec-fresh " << std::setprecision(0) << (fresh > 0 ? num_steps / fresh : 0)
+              << std::setprecision(3)
+              << " :time-reused " << reused
+              << " :steps-per-sec-reused " << std::setprecision(0) << (reused > 0 ? num_steps / reused : 0)
+              << ")\n";
+}
+
+void tst_rewriter_bench(char** argv, int argc, int& i) {
+    unsigned depth = 20000;
+    if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+        depth = atoi(argv[i + 1]);
+        ++i;
+    }
+    ast_manager m;
+    reg_decl_plugins(m);
+    bv_util bv(m);
+    expr_ref_vector xs(m);
+    for (unsigned k = 0; k < 8; ++k) {
+        std::string name = "x" + std::to_string(k);
+        xs.push_back(m.mk_const(symbol(name.c_str()), bv.mk_sort(32)));
+    }
+    expr_ref t1 = mk_unshared_term(bv, xs, depth);
+    expr_ref t2 = mk_shared_term(bv, xs, depth);
+    bench("unshared", m, t1, 10);
+    bench("shared", m, t2, 10);
+}
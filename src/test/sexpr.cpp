@@ -0,0 +1,40 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    sexpr.cpp
+
+Abstract:
+
+    Test display of s-expressions.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include <sstream>
+#include "util/sexpr.h"
+#include "util/rational.h"
+
+static void tst_display(sexpr * s, char const * expected) {
+    std::ostringstream out;
+    s->display(out);
+    std::cout << out.str() << "\n";
+    ENSURE(out.str() == expected);
+}
+
+void tst_sexpr() {
+    sexpr_manager m;
+    sexpr_ref a(m.mk_symbol(symbol("foo")), m);
+    sexpr_ref n(m.mk_numeral(rational(3)), m);
+    sexpr * args[2] = { a.get(), n.get() };
+    sexpr_ref c(m.mk_composite(2, args), m);
+    sexpr * nested[2] = { c.get(), a.get() };
+    sexpr_ref d(m.mk_composite(2, nested), m);
+    tst_display(a, "foo");
+    tst_display(n, "3");
+    tst_display(c, "(foo 3)");
+    tst_display(d, "((foo 3) foo)");
+}
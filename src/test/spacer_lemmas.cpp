@@ -0,0 +1,220 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    spacer_lemmas.cpp
+
+Abstract:
+
+    Test the subsumption checks of the lemma frames of SPACER.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include <string>
+#include "api/z3.h"
+#include "api/api_stats.h"
+#include "util/util.h"
+
+/**
+   \brief An 8 latch circuit whose bad state is unreachable.
+*/
+static char const * s_circuit_unsat =
+    "(declare-rel inv (Bool Bool Bool Bool Bool Bool Bool Bool))\n"
+    "(declare-rel bad ())\n"
+    "(declare-var a0 Bool) (declare-var a1 Bool) (declare-var a2 Bool) (declare-var a3 Bool)\n"
+    "(declare-var a4 Bool) (declare-var a5 Bool) (declare-var a6 Bool) (declare-var a7 Bool)\n"
+    "(declare-var b0 Bool) (declare-var b1 Bool) (declare-var b2 Bool) (declare-var b3 Bool)\n"
+    "(declare-var b4 Bool) (declare-var b5 Bool) (declare-var b6 Bool) (declare-var b7 Bool)\n"
+    "(declare-var i0 Bool) (declare-var i1 Bool) (declare-var i2 Bool)\n"
+    "(rule (=> (and (not a0) (not a1) (not a2) (not a3) (not a4) (not a5) (not a6) (not a7))\n"
+    "          (inv a0 a1 a2 a3 a4 a5 a6 a7)))\n"
+    "(rule (=> (and (inv a0 a1 a2 a3 a4 a5 a6 a7)\n"
+    "               (= b0 (ite i1 (not a0) i0)) (= b1 (ite (not a2) a5 a5)) (= b2 (xor (not a7) (not a1)))\n"
+    "               (= b3 (ite (not a6) (not a2) (not i2))) (= b4 (ite (not i1) a2 (not i1)))\n"
+    "               (= b5 (xor (not a1) (not i0))) (= b6 (ite a1 a4 (not a7))) (= b7 (and a2 a5 (not i1))))\n"
+    "          (inv b0 b1 b2 b3 b4 b5 b6 b7)))\n"
+    "(rule (=> (and (inv a0 a1 a2 a3 a4 a5 a6 a7) a5 a3 a0 a7) bad))\n"
+    "(query bad)\n";
+
+/**
+   \brief A 7 latch circuit whose bad state is unreachable.
+*/
+static char const * s_circuit_unsat2 =
+    "(declare-rel inv (Bool Bool Bool Bool Bool Bool Bool))\n"
+    "(declare-rel bad ())\n"
+    "(declare-var a0 Bool) (declare-var a1 Bool) (declare-var a2 Bool) (declare-var a3 Bool)\n"
+    "(declare-var a4 Bool) (declare-var a5 Bool) (declare-var a6 Bool)\n"
+    "(declare-var b0 Bool) (declare-var b1 Bool) (declare-var b2 Bool) (declare-var b3 Bool)\n"
+    "(declare-var b4 Bool) (declare-var b5 Bool) (declare-var b6 Bool)\n"
+    "(declare-var i0 Bool) (declare-var i1 Bool) (declare-var i2 Bool)\n"
+    "(rule (=> (and (not a0) (not a1) (not a2) (not a3) (not a4) (not a5) (not a6))\n"
+    "          (inv a0 a1 a2 a3 a4 a5 a6)))\n"
+    "(rule (=> (and (inv a0 a1 a2 a3 a4 a5 a6)\n"
+    "               (= b0 (ite (not i0) a4 a4)) (= b1 (or i0 (not a3) (not i0))) (= b2 (and (not a2) (not a2) (not a0)))\n"
+    "               (= b3 (xor a3 (not a4))) (= b4 (or a4 i1 (not a6))) (= b5 (ite (not a0) (not i1) (not a0)))\n"
+    "               (= b6 (ite a3 i2 (not a5))))\n"
+    "          (inv b0 b1 b2 b3 b4 b5 b6)))\n"
+    "(rule (=> (and (inv a0 a1 a2 a3 a4 a5 a6) a1 a2 a0) bad))\n"
+    "(query bad)\n";
+
+/**
+   \brief An 8 latch circuit whose bad state is reachable.
+*/
+static char const * s_circuit_sat =
+    "(declare-rel inv (Bool Bool Bool Bool Bool Bool Bool Bool))\n"
+    "(declare-rel bad ())\n"
+    "(declare-var a0 Bool) (declare-var a1 Bool) (declare-var a2 Bool) (declare-var a3 Bool)\n"
+    "(declare-var a4 Bool) (declare-var a5 Bool) (declare-var a6 Bool) (declare-var a7 Bool)\n"
+    "(declare-var b0 Bool) (declare-var b1 Bool) (declare-var b2 Bool) (declare-var b3 Bool)\n"
+    "(declare-var b4 Bool) (declare-var b5 Bool) (declare-var b6 Bool) (declare-var b7 Bool)\n"
+    "(declare-var i0 Bool) (declare-var i1 Bool) (declare-var i2 Bool)\n"
+    "(rule (=> (and (not a0) (not a1) (not a2) (not a3) (not a4) (not a5) (not a6) (not a7))\n"
+    "          (inv a0 a1 a2 a3 a4 a5 a6 a7)))\n"
+    "(rule (=> (and (inv a0 a1 a2 a3 a4 a5 a6 a7)\n"
+    "               (= b0 (ite a4 (not i2) a7)) (= b1 (ite i0 (not a5) a0)) (= b2 (and i1 a0 (not a6)))\n"
+    "               (= b3 (xor i2 (not a2))) (= b4 (ite a4 (not a3) i2)) (= b5 (ite a5 a3 a2))\n"
+    "               (= b6 (ite i1 (not i1) a1)) (= b7 (xor (not a3) a3)))\n"
+    "          (inv b0 b1 b2 b3 b4 b5 b6 b7)))\n"
+    "(rule (=> (and (inv a0 a1 a2 a3 a4 a5 a6 a7) a5 a0 a2 a7) bad))\n"
+    "(query bad)\n";
+
+struct spacer_stats {
+    unsigned m_subsumed;
+    unsigned m_removed;
+    unsigned m_pushes;
+};
+
+static void get_stats(Z3_context ctx, Z3_fixedpoint fp, spacer_stats & s) {
+    Z3_stats st = Z3_fixedpoint_get_statistics(ctx, fp);
+    Z3_stats_inc_ref(ctx, st);
+    statistics const & stats = to_stats_ref(st);
+    s.m_subsumed = stats.get_uint("SPACER num subsumed lemmas");
+    s.m_removed = stats.get_uint("SPACER num removed lemmas");
+    s.m_pushes = stats.get_uint("SPACER num subsumed pushes");
+    Z3_stats_dec_ref(ctx, st);
+}
+
+static Z3_fixedpoint mk_spacer(Z3_context ctx, bool inductive_generalizer, bool simplify_lemmas) {
+    Z3_fixedpoint fp = Z3_mk_fixedpoint(ctx);
+    Z3_fixedpoint_inc_ref(ctx, fp);
+    Z3_params p = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, p);
+    Z3_params_set_symbol(ctx, p, Z3_mk_string_symbol(ctx, "engine"), Z3_mk_string_symbol(ctx, "spacer"));
+    Z3_params_set_bool(ctx, p, Z3_mk_string_symbol(ctx, "spacer.use_inductive_generalizer"), inductive_generalizer);
+    Z3_params_set_bool(ctx, p, Z3_mk_string_symbol(ctx, "spacer.simplify_lemmas_pre"), simplify_lemmas);
+    Z3_params_set_bool(ctx, p, Z3_mk_string_symbol(ctx, "spacer.simplify_lemmas_post"), simplify_lemmas);
+    Z3_fixedpoint_set_params(ctx, fp, p);
+    Z3_params_dec_ref(ctx, p);
+    return fp;
+}
+
+static Z3_lbool query(Z3_context ctx, Z3_fixedpoint fp, char const * chc) {
+    Z3_ast_vector queries = Z3_fixedpoint_from_string(ctx, fp, chc);
+    ENSURE(Z3_ast_vector_size(ctx, queries) == 1);
+    return Z3_fixedpoint_query(ctx, fp, Z3_ast_vector_get(ctx, queries, 0));
+}
+
+/**
+   \brief Solve \c chc in a fresh context, as the order of the literals in the
+   lemmas depends on the ids of the terms.
+*/
+static Z3_lbool solve(char const * chc, bool inductive_generalizer, bool simplify_lemmas, spacer_stats & s) {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_fixedpoint fp = mk_spacer(ctx, inductive_generalizer, simplify_lemmas);
+    Z3_lbool r = query(ctx, fp, chc);
+    get_stats(ctx, fp, s);
+    Z3_fixedpoint_dec_ref(ctx, fp);
+    Z3_del_context(ctx);
+    return r;
+}
+
+/**
+   \brief Solve the circuits and check that the lemmas that are subsumed by the
+   lemmas learned later are removed, and that lemmas weaker than a lemma at the
+   next level are pushed without a solver call. The subsumption checks must not
+   change the answers.
+*/
+static void tst_circuits() {
+    spacer_stats s;
+    ENSURE(solve(s_circuit_unsat, true, false, s) == Z3_L_FALSE);
+    ENSURE(s.m_removed > 0);
+    ENSURE(solve(s_circuit_unsat2, false, false, s) == Z3_L_FALSE);
+    ENSURE(s.m_removed > 0 && s.m_pushes > 0);
+    ENSURE(solve(s_circuit_sat, true, false, s) == Z3_L_TRUE);
+    ENSURE(solve(s_circuit_sat, false, false, s) == Z3_L_TRUE);
+    ENSURE(s.m_removed > 0 && s.m_pushes > 0);
+    // the lemma frames are reindexed when the lemmas are simplified
+    ENSURE(solve(s_circuit_unsat2, false, true, s) == Z3_L_FALSE);
+    ENSURE(s.m_removed > 0 && s.m_pushes > 0);
+    ENSURE(solve(s_circuit_sat, false, true, s) == Z3_L_TRUE);
+    ENSURE(s.m_removed > 0 && s.m_pushes > 0);
+}
+
+/**
+   \brief Add external lemmas over the signature of inv after solving the
+   unreachable circuit. A lemma weaker than a lemma at the same or a higher
+   level is dropped, and a stronger lemma removes the weaker lemmas at the
+   same or lower levels, also when it is added again at a higher level.
+*/
+static void tst_external_lemmas() {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_fixedpoint fp = mk_spacer(ctx, true, false);
+    ENSURE(query(ctx, fp, s_circuit_unsat) == Z3_L_FALSE);
+
+    // the lemmas of inv are over the constants inv_<i>_n of its signature
+    Z3_sort bool_sort = Z3_mk_bool_sort(ctx);
+    Z3_sort domain[8];
+    Z3_ast args[8];
+    for (unsigned i = 0; i < 8; ++i) {
+        domain[i] = bool_sort;
+        args[i] = Z3_mk_const(ctx, Z3_mk_string_symbol(ctx, ("inv_" + std::to_string(i) + "_n").c_str()), bool_sort);
+    }
+    // the learned lemmas do not contain these literals
+    Z3_ast lits[3] = { args[0], args[5], args[6] };
+    Z3_func_decl inv = Z3_mk_func_decl(ctx, Z3_mk_string_symbol(ctx, "inv"), 8, domain, bool_sort);
+    Z3_ast head = Z3_mk_app(ctx, inv, 8, args);
+    Z3_inc_ref(ctx, head);
+
+    spacer_stats s0, s1;
+    get_stats(ctx, fp, s0);
+    Z3_fixedpoint_add_constraint(ctx, fp, Z3_mk_implies(ctx, head, Z3_mk_or(ctx, 2, lits)), 3);
+    get_stats(ctx, fp, s1);
+    ENSURE(s1.m_subsumed == s0.m_subsumed && s1.m_removed == s0.m_removed);
+
+    // the cube of a weaker lemma contains the cube of the lemma above
+    Z3_fixedpoint_add_constraint(ctx, fp, Z3_mk_implies(ctx, head, Z3_mk_or(ctx, 3, lits)), 2);
+    get_stats(ctx, fp, s1);
+    ENSURE(s1.m_subsumed == s0.m_subsumed + 1);
+
+    // but not at a higher level
+    Z3_fixedpoint_add_constraint(ctx, fp, Z3_mk_implies(ctx, head, Z3_mk_or(ctx, 3, lits)), 4);
+    get_stats(ctx, fp, s1);
+    ENSURE(s1.m_subsumed == s0.m_subsumed + 1 && s1.m_removed == s0.m_removed);
+
+    // a stronger lemma at a lower level keeps both lemmas
+    Z3_fixedpoint_add_constraint(ctx, fp, Z3_mk_implies(ctx, head, lits[0]), 1);
+    get_stats(ctx, fp, s1);
+    ENSURE(s1.m_removed == s0.m_removed);
+
+    // and removes them once it is pushed to level 4
+    Z3_fixedpoint_add_constraint(ctx, fp, Z3_mk_implies(ctx, head, lits[0]), 4);
+    get_stats(ctx, fp, s1);
+    ENSURE(s1.m_subsumed == s0.m_subsumed + 1 && s1.m_removed == s0.m_removed + 2);
+
+    Z3_dec_ref(ctx, head);
+    Z3_fixedpoint_dec_ref(ctx, fp);
+    Z3_del_context(ctx);
+}
+
+void tst_spacer_lemmas() {
+    tst_circuits();
+    tst_external_lemmas();
+}
@@ -0,0 +1,162 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    spacer_parallel.cpp
+
+Abstract:
+
+    Test the lemma store of parallel SPACER and compare the answers
+    of spacer.threads=2 with the sequential engine.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include <string>
+#include "api/z3.h"
+#include "api/api_stats.h"
+#include "util/thread_pool.h"
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "muz/spacer/spacer_parallel.h"
+
+/**
+   \brief Publish lemmas from several threads, each with its own ast_manager,
+   while the threads fetch the lemmas of the others.
+*/
+static void tst_lemma_store() {
+    ast_manager m;
+    reg_decl_plugins(m);
+    spacer::lemma_store store(m);
+    unsigned const num_threads = 4, num_lemmas = 50;
+    unsigned fetched[num_threads] = {};
+    unsigned pos[num_threads] = {};
+    thread_pool pool(num_threads - 1);
+    thread_pool::task_group tasks(pool);
+    for (unsigned t = 0; t < num_threads; ++t) {
+        tasks.add([&, t]() {
+            ast_manager tm(m, false);
+            arith_util a(tm);
+            expr_ref x(tm.mk_const(symbol("x"), a.mk_int()), tm);
+            expr_ref_vector lemmas(tm);
+            unsigned_vector levels;
+            for (unsigned j = 0; j < num_lemmas; ++j) {
+                expr_ref lemma(a.mk_le(x, a.mk_int(100 * t + j)), tm);
+                store.publish(tm, lemma, j % 3, t);
+                // every thread publishes the same lemma at the same level, it is stored once
+                lemma = a.mk_ge(x, a.mk_int(0));
+                store.publish(tm, lemma, 0, t);
+                store.fetch(tm, t, pos[t], lemmas, levels);
+            }
+            for (unsigned i = 0; i < levels.size(); ++i) {
+                ENSURE(levels[i] < 3);
+            }
+            fetched[t] = lemmas.size();
+        });
+    }
+    tasks.wait();
+    ENSURE(store.num_published() == num_threads * num_lemmas + 1);
+    unsigned total = 0;
+    for (unsigned t = 0; t < num_threads; ++t) {
+        expr_ref_vector lemmas(m);
+        unsigned_vector levels;
+        store.fetch(m, t, pos[t], lemmas, levels);
+        total += fetched[t] + lemmas.size();
+    }
+    // every thread sees the lemmas of the others, and the shared lemma unless it published it first
+    ENSURE(total == num_threads * (num_threads - 1) * num_lemmas + num_threads - 1);
+
+    // a lemma published again at a higher level is stored again
+    ast_manager tm(m, false);
+    arith_util a(tm);
+    expr_ref lemma(a.mk_ge(tm.mk_const(symbol("x"), a.mk_int()), a.mk_int(0)), tm);
+    store.publish(tm, lemma, 2, 0);
+    ENSURE(store.num_published() == num_threads * num_lemmas + 2);
+    store.publish(tm, lemma, 1, 0);
+    ENSURE(store.num_published() == num_threads * num_lemmas + 2);
+}
+
+/**
+   \brief Solve the query of \c chc with \c num_threads SPACER contexts.
+   \c num_imported is set to the number of lemmas the main context imported from the helpers.
+*/
+static Z3_lbool solve_chc(char const * chc, unsigned num_threads, unsigned & num_imported) {
+    Z3_config cfg = Z3_mk_config();
+    Z3_context ctx = Z3_mk_context(cfg);
+    Z3_del_config(cfg);
+    Z3_fixedpoint fp = Z3_mk_fixedpoint(ctx);
+    Z3_fixedpoint_inc_ref(ctx, fp);
+    Z3_params p = Z3_mk_params(ctx);
+    Z3_params_inc_ref(ctx, p);
+    Z3_params_set_symbol(ctx, p, Z3_mk_string_symbol(ctx, "engine"), Z3_mk_string_symbol(ctx, "spacer"));
+    Z3_params_set_uint(ctx, p, Z3_mk_string_symbol(ctx, "spacer.threads"), num_threads);
+    Z3_fixedpoint_set_params(ctx, fp, p);
+    Z3_params_dec_ref(ctx, p);
+    Z3_ast_vector queries = Z3_fixedpoint_from_string(ctx, fp, chc);
+    ENSURE(Z3_ast_vector_size(ctx, queries) == 1);
+    Z3_lbool r = Z3_fixedpoint_query(ctx, fp, Z3_ast_vector_get(ctx, queries, 0));
+    Z3_stats st = Z3_fixedpoint_get_statistics(ctx, fp);
+    Z3_stats_inc_ref(ctx, st);
+    statistics const & stats = to_stats_ref(st);
+    num_imported = stats.get_uint("spacer.lemmas_imported") + stats.get_uint("spacer.lemmas_discarded");
+    Z3_stats_dec_ref(ctx, st);
+    Z3_fixedpoint_dec_ref(ctx, fp);
+    Z3_del_context(ctx);
+    return r;
+}
+
+/**
+   \brief Two counters that move in lock step, and a query for a state
+   that is unreachable (bad = 0) or reachable after \c bound steps (bad = 1).
+*/
+static std::string mk_counter_chc(unsigned bound, bool reachable) {
+    std::string b = std::to_string(bound);
+    return std::string(
+        "(declare-rel inv (Int Int Int))\n"
+        "(declare-var x Int)\n(declare-var y Int)\n(declare-var z Int)\n"
+        "(rule (=> (and (= x 0) (= y 0) (= z 0)) (inv x y z)))\n"
+        "(rule (=> (and (inv x y z) (< x ") + b + ")) (inv (+ x 1) (+ y 2) (- z 1))))\n"
+        "(rule (=> (and (inv x y z) (>= x " + b + ")) (inv 0 0 0)))\n"
+        "(declare-rel bad ())\n" +
+        (reachable ?
+         "(rule (=> (and (inv x y z) (= y (* 2 " + b + "))) bad))\n" :
+         "(rule (=> (and (inv x y z) (or (not (= y (* 2 x))) (not (= z (- x))) (> x " + b + "))) bad))\n") +
+        "(query bad)\n";
+}
+
+static void tst_parallel_chc() {
+    // the helper context runs on the worker of the shared pool
+    thread_pool::set_num_workers(1);
+    unsigned num_shared = 0;
+    for (unsigned bound = 2; bound <= 12; bound += 5) {
+        for (unsigned k = 0; k < 2; ++k) {
+            bool reachable = k == 1;
+            std::string chc = mk_counter_chc(bound, reachable);
+            unsigned imported1 = 0, imported2 = 0;
+            Z3_lbool r1 = solve_chc(chc.c_str(), 1, imported1);
+            Z3_lbool r2 = solve_chc(chc.c_str(), 2, imported2);
+            ENSURE(r1 == (reachable ? Z3_L_TRUE : Z3_L_FALSE));
+            ENSURE(r2 == r1);
+            ENSURE(imported1 == 0);
+            num_shared += imported2;
+        }
+    }
+    ENSURE(num_shared > 0);
+
+    // without workers the main context solves the query alone
+    thread_pool::set_num_workers(0);
+    std::string chc = mk_counter_chc(7, false);
+    unsigned imported = 0;
+    ENSURE(solve_chc(chc.c_str(), 2, imported) == Z3_L_FALSE);
+    ENSURE(imported == 0);
+    // the next client creates the shared pool with the default number of workers
+    thread_pool::finalize();
+}
+
+void tst_spacer_parallel() {
+    tst_lemma_store();
+    tst_parallel_chc();
+}
@@ -0,0 +1,195 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    tactic2solver.cpp
+
+Abstract:
+
+    Test incremental preprocessing of tactic based solvers against the smt solver.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+--*/
+#include "ast/reg_decl_plugins.h"
+#include "ast/arith_decl_plugin.h"
+#include "ast/ast_pp.h"
+#include "solver/tactic2solver.h"
+#include "solver/solver.h"
+#include "smt/smt_solver.h"
+#include "smt/tactic/smt_tactic.h"
+#include "tactic/tactical.h"
+#include "tactic/core/simplify_tactic.h"
+#include "tactic/core/propagate_values_tactic.h"
+#include "tactic/core/solve_eqs_tactic.h"
+#include "tactic/core/elim_uncnstr_tactic.h"
+#include "util/util.h"
+
+/**
+   \brief Model converter that converts models, but does not support formulas.
+*/
+class opaque_model_converter : public model_converter {
+    model_converter_ref m_mc;
+public:
+    opaque_model_converter(model_converter * mc): m_mc(mc) {}
+    void operator()(model_ref & md) override { (*m_mc)(md); }
+    void operator()(labels_vec & r) override { (*m_mc)(r); }
+    void get_units(obj_map<expr, bool> & units) override { m_mc->get_units(units); }
+    model_converter * translate(ast_translation & tr) override { return alloc(opaque_model_converter, m_mc->translate(tr)); }
+    void display(std::ostream & out) override { m_mc->display(out); }
+};
+
+/**
+   \brief Tactic that hides the model converters of the goals produced by \c t behind an opaque_model_converter.
+*/
+class opaque_mc_tactic : public tactic {
+    tactic_ref m_t;
+public:
+    opaque_mc_tactic(tactic * t): m_t(t) {}
+    void operator()(goal_ref const & in, goal_ref_buffer & result) override {
+        (*m_t)(in, result);
+        for (goal * g : result) {
+            if (g->mc())
+                g->set(alloc(opaque_model_converter, g->mc()));
+        }
+    }
+    void cleanup() override { m_t->cleanup(); }
+    tactic * translate(ast_manager & m) override { return alloc(opaque_mc_tactic, m_t->translate(m)); }
+};
+
+static tactic * mk_preprocess(ast_manager & m, bool opaque = false) {
+    tactic * t = and_then(and_then(mk_simplify_tactic(m), mk_propagate_values_tactic(m)),
+                          mk_solve_eqs_tactic(m),
+                          mk_elim_uncnstr_tactic(m));
+    return opaque ? alloc(opaque_mc_tactic, t) : t;
+}
+
+static void check_model(solver & s, expr_ref_vector const & fmls) {
+    model_ref md;
+    s.get_model(md);
+    ENSURE(md);
+    ast_manager & m = fmls.get_manager();
+    for (expr * f : fmls) {
+        expr_ref v(m);
+        VERIFY(md->eval_expr(f, v, true));
+        if (!m.is_true(v)) {
+            std::cout << "model does not satisfy " << mk_pp(f, m) << "\n" << *md << "\n";
+        }
+        ENSURE(m.is_true(v));
+    }
+}
+
+static void check(solver & s1, solver & s2, expr_ref_vector const & fmls, expr_ref_vector const & asms) {
+    lbool r1 = s1.check_sat(asms);
+    lbool r2 = s2.check_sat(asms);
+    if (r1 != r2) {
+        std::cout << r1 << " " << r2 << "\n" << fmls << "\n" << asms << "\n";
+    }
+    ENSURE(r1 == r2);
+    if (r1 == l_true) {
+        expr_ref_vector all(fmls);
+        all.append(asms);
+        check_model(s1, all);
+    }
+}
+
+// a chain of definitions as in bounded model checking: x_{i+1} = x_i + 1.
+// with opaque model converters, the definitions of eliminated symbols cannot be
+// moved to new assertions, and the cache is rolled back instead.
+static void tst_chain(bool opaque) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    params_ref p;
+    ref<solver> s1 = mk_incremental_tactic2solver(m, mk_preprocess(m, opaque), mk_smt_tactic(m), p);
+    ref<solver> s2 = mk_smt_solver(m, p, symbol::null);
+    expr_ref_vector fmls(m), asms(m), xs(m);
+    for (unsigned i = 0; i < 8; ++i)
+        xs.push_back(m.mk_const(symbol((std::string("x") + std::to_string(i)).c_str()), a.mk_int()));
+    expr_ref fml(m.mk_eq(xs.get(0), a.mk_int(0)), m);
+    s1->assert_expr(fml);
+    s2->assert_expr(fml);
+    fmls.push_back(fml);
+    for (unsigned i = 0; i + 1 < xs.size(); ++i) {
+        fml = m.mk_eq(xs.get(i + 1), a.mk_add(xs.get(i), a.mk_int(1)));
+        s1->assert_expr(fml);
+        s2->assert_expr(fml);
+        fmls.push_back(fml);
+        // the bad state is reachable only in the last step.
+        s1->push();
+        s2->push();
+        fml = m.mk_eq(xs.get(i + 1), a.mk_int(7));
+        s1->assert_expr(fml);
+        s2->assert_expr(fml);
+        fmls.push_back(fml);
+        check(*s1, *s2, fmls, asms);
+        s1->pop(1);
+        s2->pop(1);
+        fmls.pop_back();
+        check(*s1, *s2, fmls, asms);
+    }
+}
+
+static void tst_random(unsigned seed) {
+    ast_manager m;
+    reg_decl_plugins(m);
+    arith_util a(m);
+    params_ref p;
+    random_gen rand(seed);
+    ref<solver> s1 = mk_incremental_tactic2solver(m, mk_preprocess(m), mk_smt_tactic(m), p);
+    ref<solver> s2 = mk_smt_solver(m, p, symbol::null);
+    expr_ref_vector vars(m), fmls(m), asms(m);
+    unsigned_vector lim;
+    for (unsigned i = 0; i < 5; ++i)
+        vars.push_back(m.mk_const(symbol((std::string("v") + std::to_string(i)).c_str()), a.mk_int()));
+    for (unsigned step = 0; step < 60; ++step) {
+        expr * x = vars.get(rand(vars.size()));
+        expr * y = vars.get(rand(vars.size()));
+        expr_ref k(a.mk_int(static_cast<int>(rand(7)) - 3), m);
+        expr_ref fml(m);
+        switch (rand(8)) {
+        case 0: fml = m.mk_eq(x, a.mk_add(y, k)); break;
+        case 1: fml = a.mk_le(x, k); break;
+        case 2: fml = a.mk_ge(a.mk_add(x, y), k); break;
+        case 3: fml = m.mk_not(m.mk_eq(x, y)); break;
+        case 4:
+            if (lim.size() < 3) {
+                s1->push();
+                s2->push();
+                lim.push_back(fmls.size());
+            }
+            continue;
+        case 5:
+            if (!lim.empty()) {
+                s1->pop(1);
+                s2->pop(1);
+                fmls.shrink(lim.back());
+                lim.pop_back();
+            }
+            continue;
+        case 6:
+            asms.reset();
+            asms.push_back(a.mk_ge(x, k));
+            check(*s1, *s2, fmls, asms);
+            asms.reset();
+            continue;
+        default:
+            check(*s1, *s2, fmls, asms);
+            continue;
+        }
+        s1->assert_expr(fml);
+        s2->assert_expr(fml);
+        fmls.push_back(fml);
+    }
+    check(*s1, *s2, fmls, asms);
+}
+
+void tst_tactic2solver() {
+    tst_chain(false);
+    tst_chain(true);
+    for (unsigned i = 0; i < 20; ++i)
+        tst_random(i);
+}
@@ -0,0 +1,61 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    thread_pool.cpp
+
+Abstract:
+
+    Test the thread pool.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#include "util/thread_pool.h"
+#include "util/debug.h"
+
+static void tst_groups(unsigned num_workers) {
+    thread_pool p(num_workers);
+    ENSURE(p.num_workers() == num_workers);
+    ENSURE(!p.in_worker());
+    ENSURE(!thread_pool::in_parallel());
+    std::atomic<unsigned> count(0);
+    for (unsigned round = 0; round < 10; ++round) {
+        thread_pool::task_group g(p);
+        for (unsigned i = 0; i < 100; ++i)
+            g.add([&]() { ++count; });
+        g.wait();
+        ENSURE(count == 100 * (round + 1));
+    }
+
+    // tasks that wait for tasks of their own
+    count = 0;
+    std::atomic<unsigned> in_worker(0);
+    {
+        thread_pool::task_group g(p);
+        for (unsigned i = 0; i < 8; ++i) {
+            g.add([&]() {
+                ENSURE(thread_pool::in_parallel());
+                if (p.in_worker())
+                    ++in_worker;
+                thread_pool::task_group g2(p);
+                for (unsigned j = 0; j < 50; ++j)
+                    g2.add([&]() { ++count; });
+            });
+        }
+    }
+    ENSURE(count == 8 * 50);
+    ENSURE(!thread_pool::in_parallel());
+    ENSURE(num_workers > 0 || in_worker == 0);
+}
+
+void tst_thread_pool() {
+    tst_groups(0);
+    tst_groups(1);
+    tst_groups(4);
+}
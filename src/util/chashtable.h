@@ -260,6 +260,28 @@ public:
         finalize();
     }
 
+    /**
+       \brief Remove all elements, but keep the table for the next round
+       unless it was mostly unused. It is meant for caches that are reset
+       often and refilled to a similar size.
+    */
+    void reset_keep_capacity() {
+        if (m_size == 0) 
+            return;
+        if (m_size < (m_slots >> 2)) {
+            finalize();
+            return;
+        }
+        cell * end = m_table + m_capacity;
+        for (cell * it = m_table; it != end; ++it)
+            it->m_next = reinterpret_cast<cell*>(1);
+        m_used_slots  = 0;
+        m_size        = 0;
+        m_next_cell   = m_table + m_slots;
+        m_free_cell   = nullptr;
+        m_tofree_cell = nullptr;
+    }
+
     void finalize() {
         delete_table();
         init(m_init_slots, m_init_cellar);
@@ -619,6 +641,10 @@ public:
         m_table.reset();
     }
 
+    void reset_keep_capacity() {
+        m_table.reset_keep_capacity();
+    }
+
     void finalize() {
         m_table.finalize();
     }
@@ -448,12 +448,39 @@ public:
     }
 
 
-    int find_leaving_tableau_rows(X & new_val_for_leaving) {
+    X get_infeasibility_of_column(unsigned j) const {
+        lp_assert(!this->column_is_feasible(j));
+        return this->x_below_low_bound(j)? this->m_lower_bounds[j] - this->m_x[j] : this->m_x[j] - this->m_upper_bounds[j];
+    }
+
+    // dual pricing: the basic column with the largest bound violation leaves the basis,
+    // the ties are broken by the smallest index
+    int find_most_infeasible_column_tableau_rows() const {
+        int j = -1;
+        X max_inf = zero_of_type<X>();
+        for (unsigned k : this->m_inf_set.m_index) {
+            X inf = get_infeasibility_of_column(k);
+            if (j == -1 || max_inf < inf || (inf == max_inf && k < static_cast<unsigned>(j))) {
+                j = static_cast<int>(k);
+                max_inf = inf;
+            }
+        }
+        return j;
+    }
+
+    int find_smallest_inf_column_tableau_rows() const {
         int j = -1;
         for (unsigned k : this->m_inf_set.m_index) {
             if (k < static_cast<unsigned>(j))
                 j = static_cast<int>(k);
         }
+        return j;
+    }
+
+    int find_leaving_tableau_rows(X & new_val_for_leaving) {
+        // fall back to the smallest index in the Bland mode to avoid cycling
+        int j = this->m_settings.dual_pricing_in_tableau_rows() && !m_bland_mode_tableau ?
+            find_most_infeasible_column_tableau_rows() : find_smallest_inf_column_tableau_rows();
         if (j == -1)
             return -1;
 
@@ -110,6 +110,8 @@ struct stats {
     unsigned m_patches_success;
     unsigned m_hnf_cutter_calls;
     unsigned m_hnf_cuts;
+    unsigned m_lu_updates;
+    unsigned m_lu_fill_in;
     stats() { reset(); }
     void reset() { memset(this, 0, sizeof(*this)); }
 };
@@ -149,6 +151,8 @@ public:
     // whose diagonal element in the eta column is less than e2 (entering_diag_epsilon) in magnitude, the this choice is rejected ...
     double        entering_diag_epsilon;
     int           c_partial_pivoting; // this is the constant c from page 410
+    // the number of column replacements in lu after which the basis is factorized from scratch
+    unsigned      lu_refactor_period;
     unsigned      depth_of_rook_search;
     bool          using_partial_pivoting;
     // dissertation of Achim Koberstein
@@ -198,10 +202,14 @@ public:
     unsigned         limit_on_rows_for_hnf_cutter;
     unsigned         limit_on_columns_for_hnf_cutter;
     bool             m_enable_hnf;
-
+private:
+    bool             m_dual_pricing_in_tableau_rows;
+public:
 
     unsigned hnf_cut_period() const { return m_hnf_cut_period; }
     void set_hnf_cut_period(unsigned period) { m_hnf_cut_period = period;  }
+    bool dual_pricing_in_tableau_rows() const { return m_dual_pricing_in_tableau_rows; }
+    void set_dual_pricing_in_tableau_rows(bool f) { m_dual_pricing_in_tableau_rows = f; }
     unsigned random_next() { return m_rand(); }
     void set_random_seed(unsigned s) { m_rand.set_seed(s); }
 
@@ -222,6 +230,7 @@ public:
                     positive_price_epsilon(1e-7),
                     entering_diag_epsilon (1e-8),
                     c_partial_pivoting (10), // this is the constant c from page 410
+                    lu_refactor_period (200),
                     depth_of_rook_search (4),
                     using_partial_pivoting (true),
                     // dissertation of Achim Koberstein
@@ -265,7 +274,8 @@ public:
                     m_int_patch_only_integer_values(true),
                     limit_on_rows_for_hnf_cutter(75),
                     limit_on_columns_for_hnf_cutter(150),
-                    m_enable_hnf(true)
+                    m_enable_hnf(true),
+                    m_dual_pricing_in_tableau_rows(false)
     {}
 
     void set_resource_limit(lp_resource_limit& lim) { m_resource_limit = &lim; }
@@ -120,7 +120,13 @@ lu<M>::lu(const M& A,
     debug_test_of_basis(A, basis);
 #endif
     ++m_settings.st().m_num_factorizations;
+    unsigned nnz_of_B = m_U.get_number_of_nonzeroes();
     create_initial_factorization();
+    if (get_status() == LU_status::OK) {
+        unsigned nnz_of_U = m_U.get_number_of_nonzeroes();
+        if (nnz_of_U > nnz_of_B)
+            m_settings.st().m_lu_fill_in += nnz_of_U - nnz_of_B;
+    }
 #ifdef Z3DEBUG
     // lp_assert(check_correctness());
 #endif
@@ -906,6 +912,7 @@ row_eta_matrix<typename M::coefftype, typename M::argtype> *lu<M>::get_row_eta_m
 template <typename M>
 void lu<M>::replace_column(T pivot_elem_for_checking, indexed_vector<T> & w, unsigned leaving_column_of_U){
     m_refactor_counter++;
+    ++m_settings.st().m_lu_updates;
     unsigned replaced_column =  transform_U_to_V_by_replacing_column( w, leaving_column_of_U);
     unsigned lowest_row_of_the_bump = m_U.lowest_row_in_column(replaced_column);
     m_r_wave.init(m_dim);
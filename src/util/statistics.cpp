@@ -221,6 +221,15 @@ unsigned statistics::get_uint_value(unsigned idx) const {
     return m_stats[idx].second;
 }
 
+unsigned statistics::get_uint(char const * key) const {
+    unsigned r = 0;
+    for (key_val_pair const & kv : m_stats) {
+        if (strcmp(kv.first, key) == 0)
+            r += kv.second;
+    }
+    return r;
+}
+
 double statistics::get_double_value(unsigned idx) const {
     SASSERT(idx < size());
     SASSERT(!is_uint(idx));
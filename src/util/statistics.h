@@ -40,6 +40,10 @@ public:
     bool is_uint(unsigned idx) const;
     char const * get_key(unsigned idx) const;
     unsigned get_uint_value(unsigned idx) const;
+    /**
+       \brief Return the sum of the unsigned values reported for \c key, or 0 if there is none.
+    */
+    unsigned get_uint(char const * key) const;
     double get_double_value(unsigned idx) const;
 };
 
@@ -0,0 +1,187 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    thread_pool.cpp
+
+Abstract:
+
+    Persistent pool of worker threads with work stealing.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#include "util/thread_pool.h"
+#include "util/debug.h"
+#include "util/z3_omp.h"
+
+thread_pool * thread_pool::g_pool = nullptr;
+
+static std::mutex g_pool_mutex;
+
+// number of tasks the calling thread is running, tasks may run nested tasks while they wait
+static thread_local unsigned g_num_running = 0;
+
+thread_pool::thread_pool(unsigned num_workers):
+    m_num_queued(0),
+    m_next(0),
+    m_shutdown(false) {
+    for (unsigned i = 0; i < num_workers; ++i)
+        m_queues.push_back(alloc(task_queue));
+    for (unsigned i = 0; i < num_workers; ++i)
+        m_threads.push_back(std::thread([this, i]() { work(i); }));
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_cond.notify_all();
+    for (std::thread & t : m_threads)
+        t.join();
+}
+
+thread_pool & thread_pool::get() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    if (!g_pool) {
+        unsigned n = std::thread::hardware_concurrency();
+        g_pool = alloc(thread_pool, n > 1 ? n - 1 : 0);
+    }
+    return *g_pool;
+}
+
+void thread_pool::finalize() {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    dealloc(g_pool);
+    g_pool = nullptr;
+}
+
+void thread_pool::set_num_workers(unsigned num_workers) {
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    dealloc(g_pool);
+    g_pool = alloc(thread_pool, num_workers);
+}
+
+bool thread_pool::in_parallel() {
+    return g_num_running > 0 || 0 != omp_in_parallel();
+}
+
+int thread_pool::worker_id() const {
+    std::thread::id id = std::this_thread::get_id();
+    for (unsigned i = 0; i < m_threads.size(); ++i)
+        if (m_threads[i].get_id() == id)
+            return i;
+    return -1;
+}
+
+void thread_pool::submit(task const & t) {
+    SASSERT(!m_queues.empty());
+    int w = worker_id();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        unsigned i = w >= 0 ? w : (m_next++) % m_queues.size();
+        std::lock_guard<std::mutex> qlock(m_queues[i]->m_mutex);
+        m_queues[i]->m_tasks.push_back(t);
+        ++m_num_queued;
+    }
+    m_cond.notify_one();
+}
+
+bool thread_pool::pop(unsigned i, task & t) {
+    task_queue & q = *m_queues[i];
+    std::lock_guard<std::mutex> lock(q.m_mutex);
+    if (q.m_tasks.empty())
+        return false;
+    t = q.m_tasks.back();
+    q.m_tasks.pop_back();
+    --m_num_queued;
+    return true;
+}
+
+bool thread_pool::steal(unsigned i, task & t) {
+    unsigned n = m_queues.size();
+    for (unsigned k = 1; k < n; ++k) {
+        task_queue & q = *m_queues[(i + k) % n];
+        std::lock_guard<std::mutex> lock(q.m_mutex);
+        if (!q.m_tasks.empty()) {
+            t = q.m_tasks.front();
+            q.m_tasks.pop_front();
+            --m_num_queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool thread_pool::take(task_group * g, task & t) {
+    for (unsigned i = 0; i < m_queues.size(); ++i) {
+        task_queue * q = m_queues[i];
+        std::lock_guard<std::mutex> lock(q->m_mutex);
+        for (auto it = q->m_tasks.begin(); it != q->m_tasks.end(); ++it) {
+            if (it->m_group == g) {
+                t = *it;
+                q->m_tasks.erase(it);
+                --m_num_queued;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void thread_pool::run(task & t) {
+    ++g_num_running;
+    t.m_fn();
+    --g_num_running;
+    t.m_fn = nullptr;
+    t.m_group->task_done();
+}
+
+void thread_pool::work(unsigned i) {
+    task t;
+    while (true) {
+        if (pop(i, t) || steal(i, t)) {
+            run(t);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this]() { return m_shutdown || m_num_queued > 0; });
+        if (m_shutdown && m_num_queued == 0)
+            return;
+    }
+}
+
+void thread_pool::task_group::add(std::function<void()> const & fn) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_pending;
+    }
+    task t;
+    t.m_fn = fn;
+    t.m_group = this;
+    if (m_pool.num_workers() == 0)
+        m_pool.run(t);
+    else
+        m_pool.submit(t);
+}
+
+void thread_pool::task_group::task_done() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SASSERT(m_pending > 0);
+    if (--m_pending == 0)
+        m_cond.notify_all();
+}
+
+void thread_pool::task_group::wait() {
+    task t;
+    while (m_pool.take(this, t))
+        m_pool.run(t);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this]() { return m_pending == 0; });
+}
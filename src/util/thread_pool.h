@@ -0,0 +1,136 @@
+/*++
+Copyright (c) 2018 Microsoft Corporation
+
+Module Name:
+
+    thread_pool.h
+
+Abstract:
+
+    Persistent pool of worker threads with work stealing.
+
+    The pool is created on first use with one worker less than the
+    number of hardware threads: a thread that waits for a group of
+    tasks executes the queued tasks of the group itself, so at most
+    one thread per hardware thread is busy with the tasks of the pool.
+
+    Every worker owns a queue of tasks. Tasks submitted by a worker
+    are added to its own queue, other tasks are distributed over the
+    queues round robin. A worker takes the most recent task of its own
+    queue and steals the oldest task of another queue when its own
+    queue is empty.
+
+    Tasks must not throw exceptions. Cancellation is the business of
+    the tasks, for example by canceling the resource limits of the
+    managers they work on.
+
+Author:
+
+    agent (agent@local) 2026-10-18
+
+Revision History:
+
+--*/
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "util/vector.h"
+#include "util/scoped_ptr_vector.h"
+
+class thread_pool {
+public:
+    class task_group;
+
+private:
+    struct task {
+        std::function<void()> m_fn;
+        task_group *          m_group;
+    };
+
+    struct task_queue {
+        std::mutex       m_mutex;
+        std::deque<task> m_tasks;
+    };
+
+    vector<std::thread>           m_threads;
+    scoped_ptr_vector<task_queue> m_queues;
+    std::mutex                    m_mutex;
+    std::condition_variable       m_cond;
+    std::atomic<unsigned>         m_num_queued;
+    unsigned                      m_next;
+    bool                          m_shutdown;
+
+    static thread_pool *          g_pool;
+
+    int worker_id() const;
+    void submit(task const & t);
+    bool pop(unsigned i, task & t);
+    bool steal(unsigned i, task & t);
+    bool take(task_group * g, task & t);
+    void run(task & t);
+    void work(unsigned i);
+
+public:
+    thread_pool(unsigned num_workers);
+    ~thread_pool();
+
+    /**
+       \brief Return the pool that is shared by all clients. It is created on first use.
+    */
+    static thread_pool & get();
+
+    static void finalize();
+
+    /**
+       \brief Replace the shared pool by a pool with \c num_workers workers.
+       No tasks of the shared pool may be pending.
+    */
+    static void set_num_workers(unsigned num_workers);
+
+    /**
+       \brief Return true if the calling thread runs a task of a pool or is
+       inside an OpenMP parallel region. Code that can run in parallel checks it
+       and runs sequentially instead of creating another level of threads.
+    */
+    static bool in_parallel();
+
+    unsigned num_workers() const { return m_threads.size(); }
+
+    /**
+       \brief Return true if the calling thread is one of the workers of the pool.
+    */
+    bool in_worker() const { return worker_id() >= 0; }
+
+    /**
+       \brief Tasks that are submitted together and waited for together.
+    */
+    class task_group {
+        friend class thread_pool;
+        thread_pool &           m_pool;
+        std::mutex              m_mutex;
+        std::condition_variable m_cond;
+        unsigned                m_pending;
+        void task_done();
+    public:
+        task_group(thread_pool & p): m_pool(p), m_pending(0) {}
+        ~task_group() { wait(); }
+        void add(std::function<void()> const & fn);
+        /**
+           \brief Execute the tasks of the group that are still queued on the
+           calling thread and wait until the remaining tasks are finished.
+        */
+        void wait();
+    };
+};
+
+/*
+  ADD_FINALIZER('thread_pool::finalize();')
+*/
+
+#endif